@@ -0,0 +1,51 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_BENCH_BENCH_HPP
+#define VLE_BENCH_BENCH_HPP
+
+#include <cstdint>
+
+namespace vle {
+namespace bench {
+
+/**
+ * Spend some processor time without memory access: @c amount iterations
+ * of a linear congruential generator.
+ */
+inline void
+busy_work(std::uint64_t amount) noexcept
+{
+    volatile std::uint64_t x = amount;
+
+    for (std::uint64_t i = 0; i != amount; ++i)
+        x = x * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+}
+}
+} // namespace vle bench
+
+#endif
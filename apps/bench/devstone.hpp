@@ -0,0 +1,500 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_BENCH_DEVSTONE_HPP
+#define VLE_BENCH_DEVSTONE_HPP
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/devs/ExternalEventList.hpp>
+#include <vle/oov/Plugin.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "bench.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace vle {
+namespace bench {
+
+/**
+ * The atomic model of DEVStone: an external event starts a work of
+ * @c external_work iterations, the model sends an event on its @c out port
+ * immediately and becomes passive after a work of @c internal_work
+ * iterations.
+ */
+class DevstoneAtomic : public devs::Dynamics
+{
+public:
+    DevstoneAtomic(const devs::DynamicsInit& init,
+                   const devs::InitEventList& events,
+                   std::uint64_t internal_work,
+                   std::uint64_t external_work)
+      : devs::Dynamics(init, events)
+      , m_internal_work(internal_work)
+      , m_external_work(external_work)
+      , m_transitions(0)
+      , m_active(false)
+    {}
+
+    devs::Time timeAdvance() const override
+    {
+        return m_active ? 0.0 : devs::infinity;
+    }
+
+    void output(devs::Time /*time*/,
+                devs::ExternalEventList& output) const override
+    {
+        if (m_active)
+            output.emplace_back("out");
+    }
+
+    void internalTransition(devs::Time /*time*/) override
+    {
+        busy_work(m_internal_work);
+        m_active = false;
+        ++m_transitions;
+    }
+
+    void externalTransition(const devs::ExternalEventList& /*events*/,
+                            devs::Time /*time*/) override
+    {
+        busy_work(m_external_work);
+        m_active = true;
+        ++m_transitions;
+    }
+
+    std::unique_ptr<value::Value> observation(
+      const devs::ObservationEvent& /*event*/) const override
+    {
+        return value::Integer::create(m_transitions);
+    }
+
+private:
+    std::uint64_t m_internal_work;
+    std::uint64_t m_external_work;
+    std::int32_t m_transitions;
+    bool m_active;
+};
+
+/**
+ * Send one event per unit of time on the @c out port, @c events times.
+ */
+class DevstoneGenerator : public devs::Dynamics
+{
+public:
+    DevstoneGenerator(const devs::DynamicsInit& init,
+                      const devs::InitEventList& events,
+                      std::uint64_t count)
+      : devs::Dynamics(init, events)
+      , m_count(count)
+    {}
+
+    devs::Time init(devs::Time /*time*/) override
+    {
+        return m_count ? 0.0 : devs::infinity;
+    }
+
+    devs::Time timeAdvance() const override
+    {
+        return m_count ? 1.0 : devs::infinity;
+    }
+
+    void output(devs::Time /*time*/,
+                devs::ExternalEventList& output) const override
+    {
+        output.emplace_back("out");
+    }
+
+    void internalTransition(devs::Time /*time*/) override
+    {
+        --m_count;
+    }
+
+private:
+    std::uint64_t m_count;
+};
+
+/**
+ * An output plug-in that only counts the observations, to measure the
+ * cost of the observation in the kernel.
+ */
+class CounterPlugin : public oov::Plugin
+{
+public:
+    CounterPlugin(const std::string& location)
+      : oov::Plugin(location)
+      , m_values(0)
+    {}
+
+    void onParameter(const std::string& /*plugin*/,
+                     const std::string& /*location*/,
+                     const std::string& /*file*/,
+                     std::unique_ptr<value::Value> /*parameters*/,
+                     const double& /*time*/) override
+    {}
+
+    void onNewObservable(const std::string& /*simulator*/,
+                         const std::string& /*parent*/,
+                         const std::string& /*port*/,
+                         const std::string& /*view*/,
+                         const double& /*time*/) override
+    {}
+
+    void onDelObservable(const std::string& /*simulator*/,
+                         const std::string& /*parent*/,
+                         const std::string& /*port*/,
+                         const std::string& /*view*/,
+                         const double& /*time*/) override
+    {}
+
+    void onValue(const std::string& /*simulator*/,
+                 const std::string& /*parent*/,
+                 const std::string& /*port*/,
+                 const std::string& /*view*/,
+                 const double& /*time*/,
+                 std::unique_ptr<value::Value> /*value*/) override
+    {
+        ++m_values;
+    }
+
+private:
+    std::uint64_t m_values;
+};
+
+enum class devstone_type
+{
+    li,   /**< Low interconnection: each level has a coupled model and
+           * width - 1 atomic models connected to the input. */
+    hi,   /**< High input: LI with a chain between the atomic models. */
+    ho,   /**< High output: HI with a second input and a second output
+           * which collects the outputs of the atomic models. */
+    homod /**< HO with a triangular second layer of atomic models: its
+           * first row is connected to all the models of the first layer,
+           * the couplings grow with the square of the width. */
+};
+
+struct devstone_parameters
+{
+    devstone_type type = devstone_type::li;
+    int depth = 10;
+    int width = 10;
+    std::uint64_t internal_work = 0;
+    std::uint64_t external_work = 0;
+    std::uint64_t events = 1;
+    bool observe = false;
+};
+
+inline const char*
+to_string(devstone_type type) noexcept
+{
+    switch (type) {
+    case devstone_type::li:
+        return "LI";
+    case devstone_type::hi:
+        return "HI";
+    case devstone_type::ho:
+        return "HO";
+    case devstone_type::homod:
+        return "HOmod";
+    }
+
+    return "";
+}
+
+/**
+ * @throw utils::ArgError if @c name is not LI, HI, HO or HOmod.
+ */
+inline devstone_type
+devstone_type_from_string(const std::string& name)
+{
+    for (auto type : { devstone_type::li,
+                       devstone_type::hi,
+                       devstone_type::ho,
+                       devstone_type::homod })
+        if (name == to_string(type))
+            return type;
+
+    throw utils::ArgError("Unknown DEVStone model `%s'", name.c_str());
+}
+
+/**
+ * Register the dynamics and the output plug-in of the DEVStone models.
+ */
+inline void
+register_devstone(utils::ContextPtr ctx, const devstone_parameters& params)
+{
+    const auto internal_work = params.internal_work;
+    const auto external_work = params.external_work;
+    const auto count = params.events;
+
+    ctx->add_dynamics_factory(
+      "devstone_atomic",
+      [internal_work, external_work](const devs::DynamicsInit& init,
+                                     const devs::InitEventList& events) {
+          return new DevstoneAtomic(
+            init, events, internal_work, external_work);
+      });
+
+    ctx->add_dynamics_factory(
+      "devstone_generator",
+      [count](const devs::DynamicsInit& init,
+              const devs::InitEventList& events) {
+          return new DevstoneGenerator(init, events, count);
+      });
+
+    ctx->add_oov_factory("devstone_counter", [](const std::string& location) {
+        return new CounterPlugin(location);
+    });
+}
+
+class DevstoneBuilder
+{
+public:
+    DevstoneBuilder(const devstone_parameters& params)
+      : m_params(params)
+      , m_atomics(0)
+      , m_couplings(0)
+    {}
+
+    /**
+     * Build a @c vpz::Vpz with a generator connected to the DEVStone
+     * model. The duration of the experiment lets the generator send all
+     * its events.
+     *
+     * With d the depth and w the width, the DEVStone model has
+     * (w - 1)(d - 1) + 1 atomic models, ((w - 1) + (w - 1)w / 2)(d - 1) + 1
+     * for HOmod, and the following couplings, the input and the internal
+     * ones (EIC, IC) and the output ones (EOC):
+     *
+     * - LI: EIC w(d - 1) + 1, IC 0, EOC d.
+     * - HI: EIC w(d - 1) + 1, IC (w - 2)(d - 1), EOC d.
+     * - HO: EIC (w + 1)(d - 1) + 1, IC (w - 2)(d - 1), EOC w(d - 1) + 1.
+     * - HOmod: EIC (2(w - 1) + 1)(d - 1) + 1,
+     *   IC ((w - 1)^2 + (w - 1)w / 2)(d - 1), EOC d.
+     *
+     * The chains of HI and HO have no coupling when w = 1. The
+     * @c couplings count adds the couplings of the generator.
+     *
+     * @throw utils::ArgError if the depth or the width is lower than 1.
+     */
+    std::unique_ptr<vpz::Vpz> build()
+    {
+        if (m_params.depth < 1 or m_params.width < 1)
+            throw utils::ArgError("DEVStone: depth and width must be >= 1");
+
+        m_atomics = 0;
+        m_couplings = 0;
+
+        auto file = std::make_unique<vpz::Vpz>();
+        auto& project = file->project();
+        project.experiment().setBegin(0.0);
+        project.experiment().setDuration(static_cast<double>(m_params.events));
+
+        auto& dynamics = project.dynamics().dynamiclist();
+        dynamics.emplace("atomic", vpz::Dynamic("atomic"))
+          .first->second.setLibrary("devstone_atomic");
+        dynamics.emplace("generator", vpz::Dynamic("generator"))
+          .first->second.setLibrary("devstone_generator");
+
+        if (m_params.observe) {
+            auto& views = project.experiment().views();
+            views.addStreamOutput("counter", "", "devstone_counter", "");
+            views.add(vpz::View("transitions",
+                                vpz::View::INTERNAL | vpz::View::EXTERNAL |
+                                  vpz::View::CONFLUENT,
+                                "counter"));
+            views.addObservable(vpz::Observable("atomic"))
+              .add("transitions")
+              .add("transitions");
+        }
+
+        auto top = std::make_unique<vpz::CoupledModel>("top", nullptr);
+        auto* gen = top->addAtomicModel("generator");
+        gen->setDynamics("generator");
+        gen->addOutputPort("out");
+
+        auto* root = level(top.get(), m_params.depth);
+        connect(top.get(), gen, "out", root, "in");
+        if (has_second_input())
+            connect(top.get(), gen, "out", root, "in2");
+
+        project.model().setGraph(std::move(top));
+
+        return file;
+    }
+
+    std::size_t atomics() const noexcept
+    {
+        return m_atomics;
+    }
+
+    std::size_t couplings() const noexcept
+    {
+        return m_couplings;
+    }
+
+private:
+    const devstone_parameters& m_params;
+    std::size_t m_atomics;
+    std::size_t m_couplings;
+
+    bool has_second_input() const noexcept
+    {
+        return m_params.type == devstone_type::ho or
+               m_params.type == devstone_type::homod;
+    }
+
+    vpz::AtomicModel* atomic(vpz::CoupledModel* parent,
+                             const std::string& name)
+    {
+        auto* mdl = parent->addAtomicModel(name);
+        mdl->setDynamics("atomic");
+        mdl->addInputPort("in");
+        mdl->addOutputPort("out");
+        if (m_params.observe)
+            mdl->setObservables("atomic");
+
+        ++m_atomics;
+        return mdl;
+    }
+
+    void connect(vpz::CoupledModel* parent,
+                 vpz::BaseModel* src,
+                 const std::string& src_port,
+                 vpz::BaseModel* dst,
+                 const std::string& dst_port)
+    {
+        if (src == parent)
+            parent->addInputConnection(src_port, dst, dst_port);
+        else if (dst == parent)
+            parent->addOutputConnection(src, src_port, dst_port);
+        else
+            parent->addInternalConnection(src, src_port, dst, dst_port);
+
+        ++m_couplings;
+    }
+
+    vpz::CoupledModel* level(vpz::CoupledModel* parent, int depth)
+    {
+        const bool second = has_second_input();
+        auto* coupled = parent->addCoupledModel("l" + std::to_string(depth));
+        coupled->addInputPort("in");
+        coupled->addOutputPort("out");
+        if (second)
+            coupled->addInputPort("in2");
+        if (m_params.type == devstone_type::ho)
+            coupled->addOutputPort("out2");
+
+        if (depth == 1) {
+            auto* mdl = atomic(coupled, "a");
+            connect(coupled, coupled, "in", mdl, "in");
+            connect(coupled, mdl, "out", coupled, "out");
+            return coupled;
+        }
+
+        auto* child = level(coupled, depth - 1);
+        connect(coupled, coupled, "in", child, "in");
+        connect(coupled, child, "out", coupled, "out");
+
+        std::vector<vpz::AtomicModel*> row;
+        for (int i = 1; i < m_params.width; ++i)
+            row.push_back(atomic(coupled, "a" + std::to_string(i)));
+
+        switch (m_params.type) {
+        case devstone_type::li:
+            for (auto* mdl : row)
+                connect(coupled, coupled, "in", mdl, "in");
+            break;
+        case devstone_type::hi:
+            for (std::size_t i = 0; i != row.size(); ++i) {
+                connect(coupled, coupled, "in", row[i], "in");
+                if (i + 1 != row.size())
+                    connect(coupled, row[i], "out", row[i + 1], "in");
+            }
+            break;
+        case devstone_type::ho:
+            connect(coupled, coupled, "in", child, "in2");
+            for (std::size_t i = 0; i != row.size(); ++i) {
+                connect(coupled, coupled, "in2", row[i], "in");
+                connect(coupled, row[i], "out", coupled, "out2");
+                if (i + 1 != row.size())
+                    connect(coupled, row[i], "out", row[i + 1], "in");
+            }
+            break;
+        case devstone_type::homod: {
+            for (auto* mdl : row) {
+                connect(coupled, coupled, "in2", mdl, "in");
+                connect(coupled, mdl, "out", child, "in2");
+            }
+
+            // The second layer is a triangle: its first row has width - 1
+            // models, fed by the input and connected to all the models of
+            // the first layer, each next row has one model less, the k-th
+            // model of a row is connected to the (k + 1)-th model of the
+            // previous one.
+            std::vector<vpz::AtomicModel*> previous;
+            for (int r = 1; r < m_params.width; ++r) {
+                std::vector<vpz::AtomicModel*> current;
+                for (int i = (r == 1 ? 1 : r); i < m_params.width; ++i)
+                    current.push_back(atomic(coupled,
+                                             "b" + std::to_string(r) + "_" +
+                                               std::to_string(i)));
+
+                for (std::size_t i = 0; i != current.size(); ++i) {
+                    if (r == 1) {
+                        connect(coupled, coupled, "in", current[i], "in");
+                        for (auto* mdl : row)
+                            connect(coupled, current[i], "out", mdl, "in");
+                    } else {
+                        connect(coupled,
+                                current[i],
+                                "out",
+                                previous[i + 1],
+                                "in");
+                    }
+                }
+
+                previous = std::move(current);
+            }
+        } break;
+        }
+
+        return coupled;
+    }
+};
+}
+} // namespace vle bench
+
+#endif
@@ -0,0 +1,600 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/Simulation.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/vle.hpp>
+
+#include "devstone.hpp"
+#include "phold.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <getopt.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct bench_run
+{
+    double wall_time;
+    vle::devs::Statistics statistics;
+};
+
+/* The runs of a benchmark with a number of threads of the kernel. */
+struct bench_result
+{
+    long threads;
+    std::vector<bench_run> runs;
+
+    double best() const
+    {
+        double ret = runs.front().wall_time;
+        for (const auto& run : runs)
+            ret = std::min(ret, run.wall_time);
+
+        return ret;
+    }
+
+    double mean() const
+    {
+        double ret = 0.0;
+        for (const auto& run : runs)
+            ret += run.wall_time;
+
+        return ret / runs.size();
+    }
+};
+
+/* The peak resident set size of the process in kilobytes, 0 if unknown. */
+long
+peak_memory() noexcept
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+/* The events of a run: the external events routed to the models and the
+ * internal events. */
+std::uint64_t
+events(const vle::devs::Statistics& stats) noexcept
+{
+    return stats.external_events + stats.internal_transitions +
+           stats.confluent_transitions;
+}
+
+void
+write_statistics(FILE* out, const bench_run& run)
+{
+    const auto& s = run.statistics;
+
+    fprintf(out,
+            "        {\n"
+            "          \"wall_time\": %.9g,\n"
+            "          \"events\": %llu,\n"
+            "          \"events_per_second\": %.9g,\n"
+            "          \"bags\": %llu,\n"
+            "          \"outputs\": %llu,\n"
+            "          \"output_events\": %llu,\n"
+            "          \"external_events\": %llu,\n"
+            "          \"internal_transitions\": %llu,\n"
+            "          \"external_transitions\": %llu,\n"
+            "          \"confluent_transitions\": %llu,\n"
+            "          \"observations\": %llu,\n"
+            "          \"phases\": {\n"
+            "            \"output\": %.9g,\n"
+            "            \"routing\": %.9g,\n"
+            "            \"transition\": %.9g,\n"
+            "            \"observation\": %.9g,\n"
+            "            \"scheduler\": %.9g\n"
+            "          }\n"
+            "        }",
+            run.wall_time,
+            static_cast<unsigned long long>(events(s)),
+            run.wall_time > 0 ? events(s) / run.wall_time : 0.0,
+            static_cast<unsigned long long>(s.bags),
+            static_cast<unsigned long long>(s.outputs),
+            static_cast<unsigned long long>(s.output_events),
+            static_cast<unsigned long long>(s.external_events),
+            static_cast<unsigned long long>(s.internal_transitions),
+            static_cast<unsigned long long>(s.external_transitions),
+            static_cast<unsigned long long>(s.confluent_transitions),
+            static_cast<unsigned long long>(s.observations),
+            s.output_time,
+            s.routing_time,
+            s.transition_time,
+            s.observation_time,
+            s.scheduler_time);
+}
+
+void
+write_result(FILE* out, const bench_result& result, double reference)
+{
+    const auto best = std::min_element(
+      result.runs.cbegin(),
+      result.runs.cend(),
+      [](const bench_run& a, const bench_run& b) {
+          return a.wall_time < b.wall_time;
+      });
+
+    fprintf(out,
+            "    {\n"
+            "      \"threads\": %ld,\n"
+            "      \"best_wall_time\": %.9g,\n"
+            "      \"mean_wall_time\": %.9g,\n"
+            "      \"best_events_per_second\": %.9g,\n"
+            "      \"speedup\": %.9g,\n"
+            "      \"runs\": [\n",
+            result.threads,
+            best->wall_time,
+            result.mean(),
+            best->wall_time > 0 ? events(best->statistics) / best->wall_time
+                                : 0.0,
+            best->wall_time > 0 ? reference / best->wall_time : 0.0);
+
+    for (std::size_t i = 0; i != result.runs.size(); ++i) {
+        write_statistics(out, result.runs[i]);
+        fputs(i + 1 != result.runs.size() ? ",\n" : "\n", out);
+    }
+
+    fputs("      ]\n    }", out);
+}
+
+void
+write_parameters(FILE* out, const vle::bench::devstone_parameters& p)
+{
+    fprintf(out,
+            "  \"parameters\": {\n"
+            "    \"model\": \"%s\",\n"
+            "    \"depth\": %d,\n"
+            "    \"width\": %d,\n"
+            "    \"generator_events\": %llu,\n"
+            "    \"internal_work\": %llu,\n"
+            "    \"external_work\": %llu,\n"
+            "    \"observe\": %s\n"
+            "  },\n",
+            vle::bench::to_string(p.type),
+            p.depth,
+            p.width,
+            static_cast<unsigned long long>(p.events),
+            static_cast<unsigned long long>(p.internal_work),
+            static_cast<unsigned long long>(p.external_work),
+            p.observe ? "true" : "false");
+}
+
+void
+write_parameters(FILE* out, const vle::bench::phold_parameters& p)
+{
+    fprintf(out,
+            "  \"parameters\": {\n"
+            "    \"topology\": \"%s\",\n"
+            "    \"models\": %d,\n"
+            "    \"degree\": %d,\n"
+            "    \"probability\": %.9g,\n"
+            "    \"population\": %llu,\n"
+            "    \"work\": %llu,\n"
+            "    \"lookahead\": %.9g,\n"
+            "    \"mean\": %.9g,\n"
+            "    \"quantum\": %.9g,\n"
+            "    \"duration\": %.9g,\n"
+            "    \"seed\": %lu\n"
+            "  },\n",
+            vle::bench::to_string(p.topology),
+            p.models,
+            p.degree,
+            p.probability,
+            static_cast<unsigned long long>(p.population),
+            static_cast<unsigned long long>(p.work),
+            p.lookahead,
+            p.mean,
+            p.quantum,
+            p.duration,
+            static_cast<unsigned long>(p.seed));
+}
+
+void
+show_help() noexcept
+{
+    printf("VLE %s\nvle-bench-%s [options...]\n\n"
+           "Run a benchmark of the simulation kernel and write a JSON "
+           "report.\n\n"
+           "help,h           Produce help message\n"
+           "benchmark,b      devstone or phold [default: devstone]\n"
+           "threads,t        Comma separated numbers of threads of the "
+           "kernel\n"
+           "                 (vle.simulation.thread), the speedups are "
+           "computed\n"
+           "                 against the first one [default: 0]\n"
+           "block-size       Number of models of a task of a thread "
+           "(vle.simulation.block-size) [default: 8]\n"
+           "repeat,r         Number of runs for each number of threads "
+           "[default: 3]\n"
+           "output,o         Write the report into a file instead of the "
+           "standard output\n"
+           "\nDEVStone:\n"
+           "model,m          LI, HI, HO or HOmod [default: LI]\n"
+           "depth,d          Number of levels of coupled models "
+           "[default: 10]\n"
+           "width,w          Number of models of a level [default: 10]\n"
+           "events,e         Number of events of the generator "
+           "[default: 1]\n"
+           "internal-work    Busy loop iterations of an internal "
+           "transition [default: 0]\n"
+           "external-work    Busy loop iterations of an external "
+           "transition [default: 0]\n"
+           "observe          Observe the transitions of all atomic models\n"
+           "\nPHOLD:\n"
+           "topology         smallworld, scalefree or random "
+           "[default: smallworld]\n"
+           "models,n         Number of logical processes [default: 1000]\n"
+           "degree           Neighbours of a smallworld process "
+           "[default: 4]\n"
+           "probability      Rewiring (smallworld) or edge (random) "
+           "probability [default: 0.05]\n"
+           "population       Initial jobs of a process [default: 1]\n"
+           "work             Busy loop iterations of a job "
+           "[default: 1000]\n"
+           "lookahead        Minimal delay of a job [default: 0]\n"
+           "mean             Mean of the exponential delay of a job "
+           "[default: 1]\n"
+           "quantum          Delays are rounded up to a multiple of the "
+           "quantum, 0 to\n"
+           "                 disable [default: 1]\n"
+           "duration         Duration of the simulation [default: 100]\n"
+           "seed             Seed of the random generators [default: 1]\n",
+           vle::string_version().c_str(),
+           vle::string_version_abi().c_str());
+}
+
+bool
+to_long(const char* str, long min, long* value) noexcept
+{
+    char* end = nullptr;
+    errno = 0;
+    long ret = std::strtol(str, &end, 10);
+
+    if (errno or end == str or *end != '\0' or ret < min)
+        return false;
+
+    *value = ret;
+    return true;
+}
+
+bool
+to_double(const char* str, double min, double* value) noexcept
+{
+    char* end = nullptr;
+    errno = 0;
+    double ret = std::strtod(str, &end);
+
+    if (errno or end == str or *end != '\0' or ret < min)
+        return false;
+
+    *value = ret;
+    return true;
+}
+
+bool
+to_long_list(const char* str, std::vector<long>* values)
+{
+    std::istringstream iss(str);
+    std::string token;
+    long value;
+
+    values->clear();
+    while (std::getline(iss, token, ',')) {
+        if (not to_long(token.c_str(), 0, &value))
+            return false;
+
+        values->push_back(value);
+    }
+
+    return not values->empty();
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char** argv)
+{
+    vle::bench::devstone_parameters devstone;
+    vle::bench::phold_parameters phold;
+    std::string benchmark = "devstone";
+    std::string output_file;
+    std::vector<long> threads{ 0 };
+    long block_size = 8;
+    long repeat = 3;
+    long value = 0;
+    int observe = 0;
+    int opt_index;
+
+    const char* const short_opts = "hb:m:d:w:e:n:t:r:o:";
+    const struct option long_opts[] = {
+        { "help", 0, nullptr, 'h' },
+        { "benchmark", 1, nullptr, 'b' },
+        { "model", 1, nullptr, 'm' },
+        { "depth", 1, nullptr, 'd' },
+        { "width", 1, nullptr, 'w' },
+        { "events", 1, nullptr, 'e' },
+        { "internal-work", 1, nullptr, 0 },
+        { "external-work", 1, nullptr, 0 },
+        { "observe", 0, &observe, 1 },
+        { "topology", 1, nullptr, 0 },
+        { "models", 1, nullptr, 'n' },
+        { "degree", 1, nullptr, 0 },
+        { "probability", 1, nullptr, 0 },
+        { "population", 1, nullptr, 0 },
+        { "work", 1, nullptr, 0 },
+        { "lookahead", 1, nullptr, 0 },
+        { "mean", 1, nullptr, 0 },
+        { "quantum", 1, nullptr, 0 },
+        { "duration", 1, nullptr, 0 },
+        { "seed", 1, nullptr, 0 },
+        { "threads", 1, nullptr, 't' },
+        { "block-size", 1, nullptr, 0 },
+        { "repeat", 1, nullptr, 'r' },
+        { "output", 1, nullptr, 'o' },
+        { nullptr, 0, nullptr, 0 }
+    };
+
+    for (;;) {
+        const auto opt =
+          getopt_long(argc, argv, short_opts, long_opts, &opt_index);
+        if (opt == -1)
+            break;
+
+        bool valid = true;
+        try {
+            switch (opt) {
+            case 0: {
+                const std::string name = long_opts[opt_index].name;
+                if (name == "internal-work") {
+                    valid = to_long(::optarg, 0, &value);
+                    devstone.internal_work = value;
+                } else if (name == "external-work") {
+                    valid = to_long(::optarg, 0, &value);
+                    devstone.external_work = value;
+                } else if (name == "topology") {
+                    phold.topology =
+                      vle::bench::phold_topology_from_string(::optarg);
+                } else if (name == "degree") {
+                    valid = to_long(::optarg, 1, &value);
+                    phold.degree = static_cast<int>(value);
+                } else if (name == "probability") {
+                    valid = to_double(::optarg, 0.0, &phold.probability);
+                } else if (name == "population") {
+                    valid = to_long(::optarg, 0, &value);
+                    phold.population = value;
+                } else if (name == "work") {
+                    valid = to_long(::optarg, 0, &value);
+                    phold.work = value;
+                } else if (name == "lookahead") {
+                    valid = to_double(::optarg, 0.0, &phold.lookahead);
+                } else if (name == "mean") {
+                    valid = to_double(::optarg, 0.0, &phold.mean);
+                } else if (name == "quantum") {
+                    valid = to_double(::optarg, 0.0, &phold.quantum);
+                } else if (name == "duration") {
+                    valid = to_double(::optarg, 0.0, &phold.duration);
+                } else if (name == "seed") {
+                    valid = to_long(::optarg, 0, &value);
+                    phold.seed = static_cast<std::uint32_t>(value);
+                } else if (name == "block-size") {
+                    valid = to_long(::optarg, 1, &block_size);
+                }
+            } break;
+            case 'h':
+                show_help();
+                return EXIT_SUCCESS;
+            case 'b':
+                benchmark = ::optarg;
+                valid = benchmark == "devstone" or benchmark == "phold";
+                break;
+            case 'm':
+                devstone.type =
+                  vle::bench::devstone_type_from_string(::optarg);
+                break;
+            case 'd':
+                valid = to_long(::optarg, 1, &value);
+                devstone.depth = static_cast<int>(value);
+                break;
+            case 'w':
+                valid = to_long(::optarg, 1, &value);
+                devstone.width = static_cast<int>(value);
+                break;
+            case 'e':
+                valid = to_long(::optarg, 0, &value);
+                devstone.events = value;
+                break;
+            case 'n':
+                valid = to_long(::optarg, 1, &value);
+                phold.models = static_cast<int>(value);
+                break;
+            case 't':
+                valid = to_long_list(::optarg, &threads);
+                break;
+            case 'r':
+                valid = to_long(::optarg, 1, &repeat);
+                break;
+            case 'o':
+                output_file = ::optarg;
+                break;
+            case '?':
+            default:
+                fprintf(stderr, "Unknown command line option\n");
+                return EXIT_FAILURE;
+            }
+        } catch (const std::exception& e) {
+            fprintf(stderr, "%s\n", e.what());
+            return EXIT_FAILURE;
+        }
+
+        if (not valid) {
+            fprintf(stderr, "Bad value for the option: %s\n", ::optarg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    devstone.observe = observe;
+
+    auto ctx = vle::utils::make_context();
+    ctx->set_log_priority(3);
+    ctx->set_setting("vle.simulation.block-size", block_size);
+
+    vle::bench::DevstoneBuilder builder(devstone);
+    std::function<std::unique_ptr<vle::vpz::Vpz>()> make;
+    if (benchmark == "devstone") {
+        vle::bench::register_devstone(ctx, devstone);
+        make = [&builder]() { return builder.build(); };
+    } else {
+        vle::bench::register_phold(ctx, phold);
+        make = [&phold]() { return vle::bench::make_phold(phold); };
+    }
+
+    std::vector<bench_result> results;
+    double build_time = 0.0;
+
+    try {
+        for (auto thread : threads) {
+            ctx->set_setting("vle.simulation.thread", thread);
+            results.push_back({ thread, {} });
+
+            for (long i = 0; i != repeat; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                auto file = make();
+                auto built = std::chrono::steady_clock::now();
+                build_time =
+                  std::chrono::duration<double>(built - start).count();
+
+                vle::manager::Simulation sim(
+                  ctx,
+                  vle::manager::SIMULATION_STATISTICS |
+                    vle::manager::SIMULATION_NO_RETURN,
+                  std::chrono::milliseconds::zero());
+
+                vle::manager::Error error;
+                sim.run(std::move(file), &error);
+                auto end = std::chrono::steady_clock::now();
+
+                if (error.code) {
+                    fprintf(stderr,
+                            "Simulation failure: %s\n",
+                            error.message.c_str());
+                    return EXIT_FAILURE;
+                }
+
+                results.back().runs.push_back(
+                  { std::chrono::duration<double>(end - built).count(),
+                    sim.statistics() });
+            }
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "vle-bench: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    // The simulations must not depend on the number of threads.
+    const auto& reference = results.front().runs.front().statistics;
+    bool deterministic = true;
+    for (const auto& result : results)
+        for (const auto& run : result.runs)
+            deterministic = deterministic and
+                            events(run.statistics) == events(reference) and
+                            run.statistics.bags == reference.bags;
+
+    FILE* out = stdout;
+    if (not output_file.empty()) {
+        out = fopen(output_file.c_str(), "w");
+        if (not out) {
+            fprintf(stderr, "Fail to open `%s'\n", output_file.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    fprintf(out,
+            "{\n"
+            "  \"benchmark\": \"%s\",\n"
+            "  \"version\": \"%s\",\n",
+            benchmark.c_str(),
+            vle::string_version().c_str());
+
+    if (benchmark == "devstone") {
+        write_parameters(out, devstone);
+        fprintf(out,
+                "  \"atomic_models\": %zu,\n"
+                "  \"couplings\": %zu,\n",
+                builder.atomics(),
+                builder.couplings());
+    } else {
+        write_parameters(out, phold);
+    }
+
+    fprintf(out,
+            "  \"block_size\": %ld,\n"
+            "  \"build_time\": %.9g,\n"
+            "  \"peak_memory_kb\": %ld,\n"
+            "  \"deterministic\": %s,\n"
+            "  \"results\": [\n",
+            block_size,
+            build_time,
+            peak_memory(),
+            deterministic ? "true" : "false");
+
+    const double reference_time = results.front().best();
+    for (std::size_t i = 0; i != results.size(); ++i) {
+        write_result(out, results[i], reference_time);
+        fputs(i + 1 != results.size() ? ",\n" : "\n", out);
+    }
+
+    fputs("  ]\n}\n", out);
+
+    if (out != stdout)
+        fclose(out);
+
+    return deterministic ? EXIT_SUCCESS : EXIT_FAILURE;
+}
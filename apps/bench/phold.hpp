@@ -0,0 +1,331 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_BENCH_PHOLD_HPP
+#define VLE_BENCH_PHOLD_HPP
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/devs/Executive.hpp>
+#include <vle/devs/ExternalEvent.hpp>
+#include <vle/devs/ExternalEventList.hpp>
+#include <vle/translator/GraphTranslator.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace bench {
+
+enum class phold_topology
+{
+    smallworld, /**< Watts-Strogatz: @c degree neighbours, rewired with
+                 * @c probability. */
+    scalefree,  /**< Power law out-degrees (PLOD). */
+    random      /**< Erdos-Renyi with an edge @c probability. */
+};
+
+struct phold_parameters
+{
+    phold_topology topology = phold_topology::smallworld;
+    int models = 1000;
+    int degree = 4;
+    double probability = 0.05;
+    std::uint64_t population = 1;
+    std::uint64_t work = 1000;
+    double lookahead = 0.0;
+    double mean = 1.0;
+    double quantum = 1.0;
+    double duration = 100.0;
+    std::uint32_t seed = 1;
+};
+
+inline const char*
+to_string(phold_topology topology) noexcept
+{
+    switch (topology) {
+    case phold_topology::smallworld:
+        return "smallworld";
+    case phold_topology::scalefree:
+        return "scalefree";
+    case phold_topology::random:
+        return "random";
+    }
+
+    return "";
+}
+
+/**
+ * @throw utils::ArgError if @c name is not smallworld, scalefree or
+ * random.
+ */
+inline phold_topology
+phold_topology_from_string(const std::string& name)
+{
+    for (auto topology : { phold_topology::smallworld,
+                           phold_topology::scalefree,
+                           phold_topology::random })
+        if (name == to_string(topology))
+            return topology;
+
+    throw utils::ArgError("Unknown PHOLD topology `%s'", name.c_str());
+}
+
+/**
+ * A logical process of PHOLD. It starts with @c population jobs. When a
+ * job is due, the model works @c work iterations and sends it to one of
+ * its neighbours, chosen at random. A received job is due after
+ * @c lookahead plus an exponential delay of mean @c mean, rounded up to a
+ * multiple of @c quantum so that the models share the bags.
+ *
+ * The random generator of each model is seeded with its name: the
+ * simulation does not depend on the number of threads of the kernel.
+ */
+class PholdProcess : public devs::Dynamics
+{
+public:
+    PholdProcess(const devs::DynamicsInit& init,
+                 const devs::InitEventList& events,
+                 const phold_parameters& params)
+      : devs::Dynamics(init, events)
+      , m_params(params)
+      , m_rng(params.seed ^ std::hash<std::string>()(getModelName()))
+      , m_delay(1.0 / params.mean)
+      , m_time(0.0)
+      , m_target(0)
+      , m_ports_ready(false)
+    {}
+
+    devs::Time init(devs::Time time) override
+    {
+        m_time = time;
+        for (std::uint64_t i = 0; i != m_params.population; ++i)
+            m_jobs.push(time + delay());
+
+        m_target = m_rng();
+        return timeAdvance();
+    }
+
+    devs::Time timeAdvance() const override
+    {
+        return m_jobs.empty() ? devs::infinity : m_jobs.top() - m_time;
+    }
+
+    void output(devs::Time /*time*/,
+                devs::ExternalEventList& output) const override
+    {
+        const auto& ports = outputs();
+        if (not ports.empty())
+            output.emplace_back(ports[m_target % ports.size()]);
+    }
+
+    void internalTransition(devs::Time time) override
+    {
+        m_time = time;
+        m_jobs.pop();
+        busy_work(m_params.work);
+
+        // Without neighbour, the job stays in the model.
+        if (outputs().empty())
+            m_jobs.push(time + delay());
+
+        m_target = m_rng();
+    }
+
+    void externalTransition(const devs::ExternalEventList& events,
+                            devs::Time time) override
+    {
+        m_time = time;
+        for (std::size_t i = 0, e = events.size(); i != e; ++i)
+            m_jobs.push(time + delay());
+    }
+
+private:
+    const phold_parameters& m_params;
+    std::mt19937 m_rng;
+    std::exponential_distribution<double> m_delay;
+    std::priority_queue<double, std::vector<double>, std::greater<double>>
+      m_jobs;
+    devs::Time m_time;
+    std::uint32_t m_target;
+
+    /* The output ports are added by the executive after the build of the
+     * model. */
+    mutable std::vector<std::string> m_ports;
+    mutable bool m_ports_ready;
+
+    const std::vector<std::string>& outputs() const
+    {
+        if (not m_ports_ready) {
+            for (const auto& elem : getModel().getOutputPortList())
+                m_ports.push_back(elem.first);
+            m_ports_ready = true;
+        }
+
+        return m_ports;
+    }
+
+    double delay()
+    {
+        double ret = m_params.lookahead + m_delay(m_rng);
+
+        if (m_params.quantum > 0.0)
+            ret = std::max(1.0, std::ceil(ret / m_params.quantum)) *
+                  m_params.quantum;
+
+        return ret;
+    }
+};
+
+/**
+ * Build the graph of the logical processes with the
+ * @c translator::graph_generator in its initialization and stay passive.
+ */
+class PholdExecutive : public devs::Executive
+{
+public:
+    PholdExecutive(const devs::ExecutiveInit& init,
+                   const devs::InitEventList& events,
+                   const phold_parameters& params)
+      : devs::Executive(init, events)
+      , m_params(params)
+    {}
+
+    devs::Time init(devs::Time time) override
+    {
+        translator::graph_generator gg(
+          { [](const translator::graph_generator::node_metrics& metrics,
+               std::string& name,
+               std::string& classname) {
+                name = "lp" + std::to_string(metrics.id);
+                classname = "lp";
+            },
+            translator::graph_generator::connectivity::IN,
+            true });
+
+        std::mt19937 gen(m_params.seed);
+
+        switch (m_params.topology) {
+        case phold_topology::smallworld:
+            gg.make_smallworld(*this,
+                               gen,
+                               m_params.models,
+                               m_params.degree,
+                               m_params.probability,
+                               false);
+            break;
+        case phold_topology::scalefree:
+            gg.make_scalefree(
+              *this, gen, m_params.models, 2.5, 10.0 * m_params.models, false);
+            break;
+        case phold_topology::random:
+            gg.make_sorted_erdos_renyi(
+              *this, gen, m_params.models, m_params.probability, false);
+            break;
+        }
+
+        return devs::Executive::init(time);
+    }
+
+private:
+    const phold_parameters& m_params;
+};
+
+/**
+ * Register the dynamics of the logical processes and the executive. The
+ * parameters must outlive the simulations.
+ */
+inline void
+register_phold(utils::ContextPtr ctx, const phold_parameters& params)
+{
+    ctx->add_dynamics_factory(
+      "phold_process",
+      [&params](const devs::DynamicsInit& init,
+                const devs::InitEventList& events) {
+          return new PholdProcess(init, events, params);
+      });
+
+    ctx->add_executive_factory(
+      "phold_executive",
+      [&params](const devs::ExecutiveInit& init,
+                const devs::InitEventList& events) {
+          return new PholdExecutive(init, events, params);
+      });
+}
+
+/**
+ * Build a @c vpz::Vpz with the executive of PHOLD and the class of the
+ * logical processes.
+ *
+ * @throw utils::ArgError if a parameter is out of its domain.
+ */
+inline std::unique_ptr<vpz::Vpz>
+make_phold(const phold_parameters& params)
+{
+    if (params.models < 1 or params.degree < 1 or params.mean <= 0.0 or
+        params.lookahead < 0.0 or params.quantum < 0.0 or
+        params.probability < 0.0 or params.probability > 1.0)
+        throw utils::ArgError("PHOLD: bad parameters");
+
+    auto file = std::make_unique<vpz::Vpz>();
+    auto& project = file->project();
+    project.experiment().setBegin(0.0);
+    project.experiment().setDuration(params.duration);
+
+    auto& dynamics = project.dynamics().dynamiclist();
+    dynamics.emplace("process", vpz::Dynamic("process"))
+      .first->second.setLibrary("phold_process");
+    dynamics.emplace("executive", vpz::Dynamic("executive"))
+      .first->second.setLibrary("phold_executive");
+
+    auto lp = std::make_unique<vpz::AtomicModel>("lp", nullptr);
+    lp->setDynamics("process");
+    lp->addInputPort("in");
+    project.classes().add("lp").setGraph(std::move(lp));
+
+    auto top = std::make_unique<vpz::CoupledModel>("top", nullptr);
+    top->addAtomicModel("executive")->setDynamics("executive");
+    project.model().setGraph(std::move(top));
+
+    return file;
+}
+}
+} // namespace vle bench
+
+#endif
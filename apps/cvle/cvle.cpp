@@ -30,6 +30,7 @@
 #include <vle/utils/Filesystem.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Tools.hpp>
+#include <vle/value/Binary.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
@@ -40,19 +41,34 @@
 #define OMPI_SKIP_MPICXX
 #include <getopt.h>
 #include <mpi.h>
+#include <unistd.h>
 
+#ifdef VLE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <array>
 #include <cassert>
 #include <cerrno>
 #include <cmath>
 #include <cstdio>
+#include <condition_variable>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <list>
 #include <locale>
+#include <mutex>
 #include <sstream>
 #include <stack>
+#include <thread>
 
 #ifdef VLE_HAVE_NLS
 #ifndef ENABLE_NLS
@@ -137,6 +153,213 @@ mpi_recv_string()
     return std::make_tuple(ret, status.MPI_SOURCE, from_int(status.MPI_TAG));
 }
 
+/*
+ * The binary mode (--binary) replaces the csv blocks by binary blocks
+ * encoded with vle::value::BinaryWriter:
+ * - a block is a number of rows followed by the rows, each row as a
+ *   string;
+ * - a row of the master is the typed values of the columns (nullptr for
+ *   the default value of the vpz) or the vpz of the complex values mode;
+ * - a row of a worker is the text before the views, the views (a
+ *   vle::value::Map) or an error text, and the text after the views.
+ * A block is sent packed: a flag ('B' or 'Z' for zlib compression), the
+ * size of the block then the block. The output file starts with a header
+ * and stores each packed block after its size, see @c convert_to_csv.
+ */
+const char binary_file_magic[8] = { 'c', 'v', 'l', 'e', '-', 'b', 'i', 'n' };
+const char index_file_magic[8] = { 'c', 'v', 'l', 'e', '-', 'i', 'd', 'x' };
+
+enum BinaryRow : uint8_t
+{
+    binary_views,
+    binary_text
+};
+
+static std::string
+encode_rows(const std::vector<std::string>& rows)
+{
+    std::string raw;
+    vle::value::BinaryWriter out(raw);
+
+    out.writeUint32(static_cast<uint32_t>(rows.size()));
+    for (const auto& row : rows)
+        out.writeString(row);
+
+    return raw;
+}
+
+static std::vector<std::string>
+decode_rows(const std::string& raw)
+{
+    vle::value::BinaryReader in(raw.data(), raw.data() + raw.size());
+    std::vector<std::string> rows(in.readUint32());
+
+    for (auto& row : rows)
+        row = in.readString();
+
+    return rows;
+}
+
+static std::vector<std::string>
+split_rows(const std::string& block)
+{
+    std::vector<std::string> rows;
+    std::string::size_type begin, end;
+
+    for (begin = 0, end = block.find('\n'); begin < block.size();
+         begin = end + 1, end = block.find('\n', end + 1))
+        rows.emplace_back(block, begin, end - begin);
+
+    return rows;
+}
+
+static std::string
+pack_block(const std::string& raw, bool compress)
+{
+    std::string packed;
+    vle::value::BinaryWriter out(packed);
+
+#ifdef VLE_HAVE_ZLIB
+    if (compress) {
+        uLongf size = compressBound(static_cast<uLong>(raw.size()));
+        std::string buffer(size, '\0');
+
+        if (compress2(reinterpret_cast<Bytef*>(&buffer[0]),
+                      &size,
+                      reinterpret_cast<const Bytef*>(raw.data()),
+                      static_cast<uLong>(raw.size()),
+                      Z_BEST_SPEED) != Z_OK)
+            throw vle::utils::InternalError(_("Fail to compress a block"));
+
+        out.writeUint8('Z');
+        out.writeUint64(raw.size());
+        packed.append(buffer, 0, size);
+        return packed;
+    }
+#else
+    (void)compress;
+#endif
+
+    out.writeUint8('B');
+    out.writeUint64(raw.size());
+    packed.append(raw);
+    return packed;
+}
+
+static std::string
+unpack_block(const std::string& packed)
+{
+    vle::value::BinaryReader in(packed.data(), packed.data() + packed.size());
+    uint8_t flag = in.readUint8();
+    std::size_t size = static_cast<std::size_t>(in.readUint64());
+    const char* data = in.position();
+    std::size_t available =
+      static_cast<std::size_t>(packed.data() + packed.size() - data);
+
+    if (flag == 'B' and available == size)
+        return std::string(data, size);
+
+#ifdef VLE_HAVE_ZLIB
+    if (flag == 'Z') {
+        std::string raw(size, '\0');
+        uLongf length = static_cast<uLongf>(size);
+
+        if (uncompress(reinterpret_cast<Bytef*>(&raw[0]),
+                       &length,
+                       reinterpret_cast<const Bytef*>(data),
+                       static_cast<uLong>(available)) != Z_OK or
+            length != size)
+            throw vle::utils::FileError(_("Corrupted compressed block"));
+
+        return raw;
+    }
+#endif
+
+    throw vle::utils::FileError(_("Unknown or corrupted binary block"));
+}
+
+/**
+ * A block sent without waiting for the worker (see @c mpi_isend_block): the
+ * buffers must live until the end of the communications.
+ */
+struct PendingBlock
+{
+    std::string block;
+    std::array<int, 2> ids;
+    std::array<MPI_Request, 2> requests;
+};
+
+static void
+mpi_isend_block(int target,
+                CommunicationTag tag,
+                std::string block,
+                int first,
+                int last,
+                std::list<PendingBlock>& pending)
+{
+    pending.emplace_back();
+    auto& send = pending.back();
+    send.block = std::move(block);
+    send.ids = { { first, last } };
+
+    if (MPI_Isend(send.block.data(),
+                  static_cast<int>(send.block.size()),
+                  MPI_CHAR,
+                  target,
+                  tag,
+                  MPI_COMM_WORLD,
+                  &send.requests[0]) != MPI_SUCCESS or
+        MPI_Isend(send.ids.data(),
+                  static_cast<int>(send.ids.size()),
+                  MPI_INT,
+                  target,
+                  tag,
+                  MPI_COMM_WORLD,
+                  &send.requests[1]) != MPI_SUCCESS) {
+        fprintf(stderr,
+                "Sending block (size: %d) to %d failed\n",
+                static_cast<int>(send.block.size()),
+                target);
+        MPI_Abort(MPI_COMM_WORLD, send_errorcode);
+    }
+}
+
+/**
+ * Release the buffers of the finished sends, or wait for all the sends if
+ * @c wait is true.
+ */
+static void
+mpi_complete_blocks(std::list<PendingBlock>& pending, bool wait)
+{
+    for (auto it = pending.begin(); it != pending.end();) {
+        int flag = 1;
+        if (wait)
+            MPI_Waitall(2, it->requests.data(), MPI_STATUSES_IGNORE);
+        else
+            MPI_Testall(2, it->requests.data(), &flag, MPI_STATUSES_IGNORE);
+
+        if (flag)
+            it = pending.erase(it);
+        else
+            ++it;
+    }
+}
+
+/**
+ * @return true if a message from @c source (a rank or MPI_ANY_SOURCE) is
+ * waiting.
+ */
+static bool
+mpi_message_ready(int source)
+{
+    int flag = 0;
+    MPI_Iprobe(source, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+    return flag;
+}
+
+/**
+ * Send a block and the identifiers of its rows, see @c mpi_recv_block.
+ */
 static void
 mpi_send_block(int target,
                CommunicationTag tag,
@@ -144,38 +367,27 @@ mpi_send_block(int target,
                int first,
                int last)
 {
-    std::array<int, 2> ids{ { first, last } };
-
-    if (MPI_Send(block.data(),
-                 static_cast<int>(block.size()),
-                 MPI_CHAR,
-                 target,
-                 tag,
-                 MPI_COMM_WORLD) != MPI_SUCCESS) {
-        fprintf(stderr,
-                "Sending block buffer (size: %d) to %d failed\n",
-                static_cast<int>(block.size()),
-                target);
-        MPI_Abort(MPI_COMM_WORLD, send_errorcode);
-    }
+    std::array<int, 2> ids = { { first, last } };
 
+    mpi_send_string(target, tag, block);
     if (MPI_Send(ids.data(),
                  static_cast<int>(ids.size()),
                  MPI_INT,
                  target,
                  tag,
                  MPI_COMM_WORLD) != MPI_SUCCESS) {
-        fprintf(stderr,
-                "Sending block rows identifier %d to %d to rank %d failed\n",
-                first,
-                last,
-                target);
+        fprintf(
+          stderr, "Sending block rows identifier to %d failed\n", target);
         MPI_Abort(MPI_COMM_WORLD, send_errorcode);
     }
 }
 
-static std::tuple<std::string, int, int, CommunicationTag>
-mpi_worker()
+/**
+ * Receive a block, the rank of its sender and the identifiers of its
+ * rows, or the end message of the master (without identifiers).
+ */
+static std::tuple<std::string, int, int, int, CommunicationTag>
+mpi_recv_block()
 {
     MPI_Status status;
     MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
@@ -190,14 +402,17 @@ mpi_worker()
                  status.MPI_SOURCE,
                  status.MPI_TAG,
                  MPI_COMM_WORLD,
-                 &status) != MPI_SUCCESS)
+                 &status) != MPI_SUCCESS) {
         fprintf(stderr,
                 "Receiving block buffer (size: %d) from %d failed\n",
                 size,
                 status.MPI_SOURCE);
+        MPI_Abort(MPI_COMM_WORLD, recv_errorcode);
+    }
 
     if (status.MPI_TAG == worker_end_tag)
-        return std::make_tuple(ret, -1, -1, worker_end_tag);
+        return std::make_tuple(
+          ret, status.MPI_SOURCE, -1, -1, worker_end_tag);
 
     std::array<int, 2> ids;
     if (MPI_Recv(ids.data(),
@@ -206,12 +421,15 @@ mpi_worker()
                  status.MPI_SOURCE,
                  status.MPI_TAG,
                  MPI_COMM_WORLD,
-                 &status) != MPI_SUCCESS)
+                 &status) != MPI_SUCCESS) {
         fprintf(stderr,
                 "Receiving block rows identifier from %d failed\n",
                 status.MPI_SOURCE);
+        MPI_Abort(MPI_COMM_WORLD, recv_errorcode);
+    }
 
-    return std::make_tuple(ret, ids[0], ids[1], from_int(status.MPI_TAG));
+    return std::make_tuple(
+      ret, status.MPI_SOURCE, ids[0], ids[1], from_int(status.MPI_TAG));
 }
 
 void
@@ -558,51 +776,95 @@ public:
         return indices.size();
     }
 
+    /**
+     * Convert the string of the column @c i into a value of the type of the
+     * column. For a value column, an empty string gives nullptr: the user
+     * wants to use the default @c vle::value::Value from the origin VPZ
+     * file.
+     */
+    std::unique_ptr<vle::value::Value> parse(std::size_t i,
+                                             const std::string& str) const
+    {
+        assert(i < indices.size() && "Too many column");
+
+        int id = indices[i].second;
+
+        if (indices[i].first == column_type::keep_column)
+            return vle::value::String::create(str);
+
+        if (str.empty())
+            return nullptr;
+
+        switch (value_vector[id].default_value->getType()) {
+        case vle::value::Value::BOOLEAN:
+            return vle::value::Boolean::create(vle::utils::to<bool>(str));
+
+        case vle::value::Value::INTEGER:
+            return vle::value::Integer::create(
+              vle::utils::to<std::int32_t>(str));
+
+        case vle::value::Value::DOUBLE:
+            return vle::value::Double::create(vle::utils::to<double>(str));
+
+        case vle::value::Value::STRING:
+            return vle::value::String::create(str);
+
+        default:
+            return nullptr;
+        }
+    }
+
     void update(std::size_t i, const std::string& str)
+    {
+        update(i, parse(i, str).get());
+    }
+
+    /**
+     * Assign the value of the column @c i, the default value of the VPZ if
+     * @c value is nullptr.
+     */
+    void update(std::size_t i, const vle::value::Value* value)
     {
         assert(i < indices.size() && "Too many column");
 
         int id = indices[i].second;
 
         if (indices[i].first == column_type::keep_column) {
-            keep_vector[id].str = str;
-        } else {
-            // If @c str is empty, user want to use the default @c
-            // vle::value::Value from the origin VPZ file. Otherwise, we
-            // convert the value from the string.
+            keep_vector[id].str =
+              value ? value->toString().value() : std::string();
+            return;
+        }
 
-            switch (value_vector[id].default_value->getType()) {
-            case vle::value::Value::BOOLEAN:
-                value_vector[id].value->toBoolean().value() =
-                  str.empty()
-                    ? value_vector[id].default_value->toBoolean().value()
-                    : vle::utils::to<bool>(str);
-                break;
+        const vle::value::Value& def = *value_vector[id].default_value;
+        if (not value)
+            value = &def;
 
-            case vle::value::Value::INTEGER:
-                value_vector[id].value->toInteger().value() =
-                  str.empty()
-                    ? value_vector[id].default_value->toInteger().value()
-                    : vle::utils::to<std::int32_t>(str);
-                break;
+        if (value->getType() != def.getType())
+            throw vle::utils::ArgError(_("Bad type of the column %zu"), i);
 
-            case vle::value::Value::DOUBLE:
-                value_vector[id].value->toDouble().value() =
-                  str.empty()
-                    ? value_vector[id].default_value->toDouble().value()
-                    : vle::utils::to<double>(str);
-                break;
+        switch (def.getType()) {
+        case vle::value::Value::BOOLEAN:
+            value_vector[id].value->toBoolean().value() =
+              value->toBoolean().value();
+            break;
 
-            case vle::value::Value::STRING:
-                value_vector[id].value->toString().value() =
-                  str.empty()
-                    ? value_vector[id].default_value->toString().value()
-                    : str;
-                break;
+        case vle::value::Value::INTEGER:
+            value_vector[id].value->toInteger().value() =
+              value->toInteger().value();
+            break;
 
-            default:
-                break;
-            }
+        case vle::value::Value::DOUBLE:
+            value_vector[id].value->toDouble().value() =
+              value->toDouble().value();
+            break;
+
+        case vle::value::Value::STRING:
+            value_vector[id].value->toString().value() =
+              value->toString().value();
+            break;
+
+        default:
+            break;
         }
     }
 
@@ -769,6 +1031,65 @@ operator<<(std::ostream& os, const std::unique_ptr<vle::value::Matrix>& value)
     return os;
 }
 
+/**
+ * Write the views of a simulation result in the output file.
+ */
+static void
+write_views(std::ostream& os,
+            const vle::value::Map& result,
+            bool more_output_details)
+{
+    for (auto& it : result) {
+        if (it.second && it.second->isMatrix()) {
+            if (more_output_details) {
+                os << "view:" << it.first << "\n"
+                   << vle::value::toMatrixValue(it.second);
+            } else {
+                it.second->writeFile(os);
+            }
+        }
+    }
+}
+
+/**
+ * The real values of the output file are written in scientific notation
+ * with all their digits.
+ */
+static void
+setup_stream(std::ostream& os)
+{
+    os.imbue(std::locale::classic());
+    os << std::setprecision(static_cast<int>(std::floor(
+            std::numeric_limits<double>::digits * std::log10(2) + 2)))
+       << std::scientific;
+}
+
+/**
+ * Build the columns of the csv header: an access to a value of the vpz or
+ * a column kept in the output.
+ */
+static std::unique_ptr<Columns>
+make_columns(const std::string& header, VpzPtr vpz, bool more_output_details)
+{
+    namespace ba = boost::algorithm;
+
+    auto columns = std::make_unique<Columns>(more_output_details);
+    std::vector<std::string> tokens;
+    ba::split(tokens, header, ba::is_any_of(","));
+
+    for (std::size_t i = 0, e = tokens.size(); i != e; ++i) {
+        Access access(cleanup_token(tokens[i]));
+
+        if (access.is_undefined_string()) {
+            columns->add(access.condition);
+        } else {
+            columns->add(access.value(vpz));
+        }
+    }
+
+    return columns;
+}
+
 class Worker
 {
 private:
@@ -785,14 +1106,26 @@ private:
     bool m_workspace_per_worker;
     std::string m_workspace_prefix_path;
 
-    void simulate(std::ostream& os, int row_id)
+    // the locations of the outputs of the vpz file, for the workspaces
+    std::vector<std::pair<std::string, std::string>> m_locations;
+
+    /**
+     * Simulate the current vpz: the base vpz of the worker, modified by the
+     * columns or the conditions of the row. With the warm start, the
+     * loaded models are restarted with the conditions of the row,
+     * otherwise the simulation copies the vpz (or sends it to the spawned
+     * process). With a workspace per row, the relative locations of the
+     * outputs are moved into the workspace directory, the current
+     * directory of the process does not change. If the simulation fails,
+     * returns nullptr and assigns to @c error the text of the output
+     * file.
+     */
+    MapPtr simulate(int row_id, std::string& error)
     {
-        vle::manager::Error error;
+        vle::manager::Error err;
 
-        auto vpz = std::make_unique<vle::vpz::Vpz>(*m_vpz.get());
-        vpz->project().setInstance(row_id);
+        m_vpz->project().setInstance(row_id);
 
-        vle::utils::Path current = vle::utils::Path::current_path();
         if (m_workspace_per_worker) {
             vle::utils::Path workpath(m_workspace_prefix_path + "_" +
                                       std::to_string(row_id));
@@ -807,27 +1140,31 @@ private:
                                               "directory (%s)"),
                                             workpath.string().c_str());
 
-            vle::utils::Path::current_path(workpath);
+            auto& outputs = m_vpz->project().experiment().views().outputs();
+            for (const auto& elem : m_locations) {
+                vle::utils::Path location(elem.second);
+                outputs.get(elem.first).setStreamLocation(
+                  location.is_absolute() ? elem.second
+                                         : (workpath / location).string());
+            }
         }
 
-        auto result = m_simulator->run(std::move(vpz), &error);
+        auto result = m_simulator->run(*m_vpz, &err);
 
-        if (m_workspace_per_worker) {
-            vle::utils::Path::current_path(current);
-        }
-
-        if (error.code) {
+        error.clear();
+        if (err.code) {
             if (m_warnings) {
                 fprintf(stderr,
                         _("Simulation failed. %s [code: %d] in "),
-                        error.message.c_str(),
-                        error.code);
+                        err.message.c_str(),
+                        err.code);
                 if (m_columns) {
                     m_columns->printf(stderr);
                 }
             } else {
-                os << error.message << "\n";
+                error = err.message + "\n";
             }
+            return nullptr;
         } else if (result == nullptr) {
             if (m_warnings) {
                 fprintf(stderr,
@@ -837,27 +1174,57 @@ private:
                     m_columns->printf(stderr);
                 }
             } else {
-                os << "cvle worker error: no result "
-                   << " (try storage as output plugin)\n";
+                error = "cvle worker error: no result "
+                        " (try storage as output plugin)\n";
             }
+        }
+
+        return result;
+    }
+
+    void simulate(std::ostream& os, int row_id)
+    {
+        std::string error;
+        auto result = simulate(row_id, error);
+
+        if (result)
+            write_views(os, *result, m_more_output_details);
+        else
+            os << error;
+    }
+
+    /**
+     * Simulate one row and encode its output: the text before the views
+     * (the kept columns or the id), the views or the error text, and the
+     * text after the views.
+     */
+    std::string simulate_binary(const std::string& before,
+                                int row_id,
+                                const std::string& after)
+    {
+        std::string record;
+        vle::value::BinaryWriter out(record);
+        std::string error;
+
+        out.writeString(before);
+        auto result = simulate(row_id, error);
+        if (result) {
+            out.writeUint8(binary_views);
+            out.writeValue(*result);
         } else {
-            for (auto& it : *result) {
-                if (it.second && it.second->isMatrix()) {
-                    if (m_more_output_details) {
-                        os << "view:" << it.first << "\n"
-                           << vle::value::toMatrixValue(it.second);
-                    } else {
-                        it.second->writeFile(os);
-                    }
-                }
-            }
+            out.writeUint8(binary_text);
+            out.writeString(error);
         }
+        out.writeString(after);
+
+        return record;
     }
 
 public:
     Worker(std::chrono::milliseconds timeout,
            const std::string& vpz,
            bool withoutspawn,
+           bool warm_start,
            bool warnings,
            bool more_output_details,
            bool workspace_per_worker,
@@ -870,18 +1237,24 @@ public:
       , m_workspace_per_worker(workspace_per_worker)
       , m_workspace_prefix_path(workspace_prefix_path)
     {
-        if (not withoutspawn) {
-            m_simulator = std::make_unique<vle::manager::Simulation>(
-              m_context,
-              vle::manager::SIMULATION_NONE |
-                vle::manager::SIMULATION_SPAWN_PROCESS,
-              m_timeout);
-        } else {
-            m_simulator = std::make_unique<vle::manager::Simulation>(
-              m_context, vle::manager::SIMULATION_NONE, m_timeout);
-        }
+        auto options = vle::manager::SIMULATION_NONE;
+        if (not withoutspawn)
+            options = options | vle::manager::SIMULATION_SPAWN_PROCESS;
+        if (warm_start)
+            options = options | vle::manager::SIMULATION_WARM_START;
+
+        m_simulator = std::make_unique<vle::manager::Simulation>(
+          m_context, options, m_timeout);
         m_context->set_log_priority(3);
-        m_vpz = std::make_unique<vle::vpz::Vpz>(vpz);
+        m_vpz = std::make_unique<vle::vpz::Vpz>();
+        if (vle::vpz::Vpz::isCompiledCacheEnabled())
+            m_vpz->parseFileCached(vpz);
+        else
+            m_vpz->parseFile(vpz);
+
+        for (const auto& elem :
+             m_vpz->project().experiment().views().outputs().outputlist())
+            m_locations.emplace_back(elem.first, elem.second.location());
     }
 
     void init(const std::string& header)
@@ -889,68 +1262,250 @@ public:
         if (header == "_cvle_complex_values") {
             m_conditions = std::make_unique<ConditionsBackup>(*m_vpz);
         } else {
-            namespace ba = boost::algorithm;
+            m_columns = make_columns(header, m_vpz, m_more_output_details);
+        }
+    }
 
-            m_columns = std::make_unique<Columns>(m_more_output_details);
-            std::vector<std::string> tokens;
-            ba::split(tokens, header, ba::is_any_of(","));
+    /**
+     * Simulate one row of a block (a line of the csv file or a vpz) and
+     * returns the output of the row.
+     */
+    std::string run(const std::string& row, int row_id)
+    {
+        std::ostringstream result;
+        setup_stream(result);
 
-            for (std::size_t i = 0, e = tokens.size(); i != e; ++i) {
-                Access access(cleanup_token(tokens[i]));
+        if (m_columns) { // use columns
+            std::vector<std::string> output;
+            boost::algorithm::split(
+              output, row, boost::algorithm::is_any_of(","));
 
-                if (access.is_undefined_string()) {
-                    m_columns->add(access.condition);
-                } else {
-                    m_columns->add(access.value(m_vpz));
-                }
+            for (std::size_t i = 0, e = output.size(); i != e; ++i) {
+                std::string current = cleanup_token(output[i]);
+                m_columns->update(i, current);
             }
+
+            result << *m_columns;
+            simulate(result, row_id);
+        } else { // use vpz
+            vle::vpz::Vpz temp;
+            temp.parseMemory(row);
+            vle::vpz::Conditions conds =
+              temp.project().experiment().conditions();
+            m_conditions->modify(*m_vpz, conds);
+            result << m_conditions->getId(conds) << "\n";
+            simulate(result, row_id);
+            m_conditions->restoreBackup(*m_vpz, conds);
+            result << '\n';
         }
+
+        return result.str();
     }
 
-    std::string run(const std::string& block, int first, int last)
+    /**
+     * Simulate one row of a binary block (the typed values of the columns
+     * or a vpz) and returns the encoded output of the row.
+     */
+    std::string run_binary(const std::string& row, int row_id)
     {
-        fprintf(stdout, "worker run row %d to %d\n", first, last);
+        if (m_columns) { // use columns
+            vle::value::BinaryReader in(row.data(), row.data() + row.size());
+            std::size_t size = in.readUint32();
 
-        std::ostringstream result;
-        std::vector<std::string> output;
-        std::string::size_type begin = 0u;
-        std::string::size_type end;
-        result.imbue(std::locale::classic());
-        result << std::setprecision(static_cast<int>(std::floor(
-                    std::numeric_limits<double>::digits * std::log10(2) + 2)))
-               << std::scientific;
-
-        for (begin = 0, end = block.find('\n'); begin < block.size();
-             begin = end + 1, end = block.find('\n', end + 1)) {
-            std::string buffer(block, begin, end - begin);
-            if (m_columns) { // use columns
-                boost::algorithm::split(
-                  output, buffer, boost::algorithm::is_any_of(","));
-
-                for (std::size_t i = 0, e = output.size(); i != e; ++i) {
-                    std::string current = cleanup_token(output[i]);
-                    m_columns->update(i, current);
-                }
+            for (std::size_t i = 0; i != size; ++i)
+                m_columns->update(i, in.readValue().get());
+
+            std::ostringstream before;
+            before << *m_columns;
+            return simulate_binary(before.str(), row_id, std::string());
+        }
+
+        vle::vpz::Vpz temp;
+        temp.parseMemory(row);
+        vle::vpz::Conditions conds = temp.project().experiment().conditions();
+        m_conditions->modify(*m_vpz, conds);
+        auto record =
+          simulate_binary(m_conditions->getId(conds) + "\n", row_id, "\n");
+        m_conditions->restoreBackup(*m_vpz, conds);
+
+        return record;
+    }
+};
+
+/**
+ * @e WorkerPool runs the rows of the blocks received by a worker rank on
+ * several threads, each thread with its own @e Worker (simulator, vpz and
+ * columns). The rows of the next blocks start as soon as a thread is free,
+ * so the threads do not wait for the end of a block. The output of a block
+ * keeps the order of its rows. In binary mode, the rows are encoded (see
+ * @c Worker::run_binary).
+ */
+class WorkerPool
+{
+    struct Block
+    {
+        int first;
+        int last;
+        int remaining;
+        std::vector<std::string> rows;
+    };
+
+    struct Task
+    {
+        std::shared_ptr<Block> block;
+        std::size_t index;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_task_cv;
+    std::condition_variable m_done_cv;
+    std::deque<Task> m_tasks;
+    std::deque<std::shared_ptr<Block>> m_done;
+    std::exception_ptr m_error;
+    int m_pending;
+    bool m_binary;
+    bool m_stop;
+
+    void run_thread(Worker& worker)
+    {
+        for (;;) {
+            Task task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_task_cv.wait(
+                  lock, [this]() { return m_stop or not m_tasks.empty(); });
 
-                result << *m_columns;
-                simulate(result, first++);
-            } else { // use vpz
-                vle::vpz::Vpz temp;
-                temp.parseMemory(buffer);
-                vle::vpz::Conditions conds =
-                  temp.project().experiment().conditions();
-                std::vector<std::string> condNames = conds.conditionnames();
-                m_conditions->modify(*m_vpz, conds);
-                result << m_conditions->getId(conds) << "\n";
-                simulate(result, first++);
-                m_conditions->restoreBackup(*m_vpz, conds);
-                result << '\n';
+                if (m_tasks.empty())
+                    return;
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            std::string output;
+            std::exception_ptr error;
+            try {
+                const auto& row = task.block->rows[task.index];
+                int id = task.block->first + static_cast<int>(task.index);
+                output = m_binary ? worker.run_binary(row, id)
+                                  : worker.run(row, id);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            task.block->rows[task.index] = std::move(output);
+            if (error and not m_error)
+                m_error = error;
+
+            if (--task.block->remaining == 0) {
+                m_done.emplace_back(std::move(task.block));
+                m_done_cv.notify_one();
             }
         }
+    }
 
-        fprintf(stdout, "worker finishes at %d (%d)\n", first, last);
+public:
+    template<typename Function>
+    WorkerPool(int threads, bool binary, Function make_worker)
+      : m_pending(0)
+      , m_binary(binary)
+      , m_stop(false)
+    {
+        for (int i = 0; i < threads; ++i)
+            m_workers.emplace_back(make_worker());
+    }
 
-        return result.str();
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_tasks.clear();
+        }
+
+        m_task_cv.notify_all();
+        for (auto& th : m_threads)
+            th.join();
+    }
+
+    /**
+     * Initialize the workers with the header of the input file then start
+     * the threads.
+     */
+    void init(const std::string& header)
+    {
+        for (auto& worker : m_workers) {
+            worker->init(header);
+            m_threads.emplace_back(
+              &WorkerPool::run_thread, this, std::ref(*worker));
+        }
+    }
+
+    void push(std::vector<std::string> rows, int first, int last)
+    {
+        auto ptr = std::make_shared<Block>();
+        ptr->first = first;
+        ptr->last = last;
+        ptr->rows = std::move(rows);
+        ptr->remaining = static_cast<int>(ptr->rows.size());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_pending;
+        if (ptr->rows.empty()) {
+            m_done.emplace_back(std::move(ptr));
+            return;
+        }
+
+        for (std::size_t i = 0, e = ptr->rows.size(); i != e; ++i)
+            m_tasks.push_back(Task{ ptr, i });
+
+        m_task_cv.notify_all();
+    }
+
+    /**
+     * @return the number of blocks pushed and not yet popped.
+     */
+    int pending()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pending;
+    }
+
+    /**
+     * Wait at most @c timeout for a finished block.
+     *
+     * @return true if a block is finished, the output of its rows is
+     * assigned to @c rows.
+     * @throw the first exception of the workers.
+     */
+    bool pop(std::vector<std::string>& rows,
+             int& first,
+             int& last,
+             std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cv.wait_for(lock, timeout, [this]() {
+            return m_error or not m_done.empty();
+        });
+
+        if (m_error)
+            std::rethrow_exception(m_error);
+
+        if (m_done.empty())
+            return false;
+
+        auto block = std::move(m_done.front());
+        m_done.pop_front();
+        --m_pending;
+
+        rows = std::move(block->rows);
+        first = block->first;
+        last = block->last;
+        return true;
     }
 };
 
@@ -973,28 +1528,296 @@ open(const std::string& file)
     return fs;
 }
 
+/**
+ * The checkpoint index of an output file, stored in the file named after
+ * the output file followed by ".index": a header and a journal of the
+ * blocks of rows, in the order they are written in the output file. A
+ * record is appended after each block, already flushed in the output
+ * file, so the cost of a block does not depend on the number of blocks
+ * and a killed run leaves at worst a truncated last record, ignored. With
+ * @c --resume, the index is compacted (the contiguous blocks are merged,
+ * the truncated record removed), the output file is truncated after its
+ * blocks and the finished rows are skipped. With @c --merge, the blocks
+ * are copied in the order of the input rows.
+ */
+class Checkpoint
+{
+public:
+    struct Block
+    {
+        uint64_t first; // the first row of the block
+        uint64_t last;  // the row after the last row of the block
+        uint64_t offset;
+        uint64_t size;
+    };
+
+private:
+    static constexpr std::size_t header_size =
+      sizeof(index_file_magic) + 2 + sizeof(uint64_t);
+    static constexpr std::size_t record_size = 4 * sizeof(uint64_t);
+
+    std::string m_file;
+    std::ofstream m_journal;
+    std::vector<uint8_t> m_rows;
+    std::vector<Block> m_blocks;
+    uint64_t m_begin; // the size of the header of the output file
+    uint64_t m_end;
+    bool m_binary;
+
+    void mark(const Block& block)
+    {
+        if (m_rows.size() * 8 < block.last)
+            m_rows.resize(static_cast<std::size_t>(block.last + 7) / 8, 0);
+
+        for (auto row = block.first; row < block.last; ++row)
+            m_rows[row / 8] |= static_cast<uint8_t>(1u << (row % 8));
+    }
+
+    static void write_block(vle::value::BinaryWriter& out, const Block& block)
+    {
+        out.writeUint64(block.first);
+        out.writeUint64(block.last);
+        out.writeUint64(block.offset);
+        out.writeUint64(block.size);
+    }
+
+    /* Replace the index by the header and the blocks, under a temporary
+     * name then renamed, and open it to append the next blocks. */
+    void save()
+    {
+        std::string buffer(index_file_magic, sizeof(index_file_magic));
+        vle::value::BinaryWriter out(buffer);
+        out.writeUint8(2);
+        out.writeUint8(m_binary ? 1 : 0);
+        out.writeUint64(m_begin);
+        for (const auto& block : m_blocks)
+            write_block(out, block);
+
+        m_journal.close();
+        auto tmp = vle::utils::Path::unique_path(m_file + "-%%%%-%%%%");
+        {
+            std::ofstream ofs(tmp.string(), std::ios::binary);
+            ofs.write(buffer.data(), buffer.size());
+            if (not ofs.good())
+                throw vle::utils::FileError(
+                  _("Fail to write checkpoint index %s"),
+                  tmp.string().c_str());
+        }
+
+        // std::rename replaces the previous index atomically on POSIX
+        // systems, Path::rename does not replace an existing file.
+        if (std::rename(tmp.string().c_str(), m_file.c_str()) != 0) {
+            tmp.remove();
+            throw vle::utils::FileError(_("Fail to write checkpoint index %s"),
+                                        m_file.c_str());
+        }
+
+        m_journal.open(m_file, std::ios::binary | std::ios::app);
+        if (not m_journal.is_open())
+            throw vle::utils::FileError(_("Fail to open checkpoint index %s"),
+                                        m_file.c_str());
+    }
+
+public:
+    Checkpoint(const std::string& output, bool binary)
+      : m_file(output + ".index")
+      , m_begin(0)
+      , m_end(0)
+      , m_binary(binary)
+    {}
+
+    const std::string& file() const noexcept
+    {
+        return m_file;
+    }
+
+    /**
+     * Read the index of a previous run, without its truncated last record.
+     *
+     * @throw vle::utils::FileError if the index is missing or corrupted.
+     */
+    void load()
+    {
+        std::ifstream ifs(m_file, std::ios::binary);
+        if (not ifs.is_open())
+            throw vle::utils::FileError(_("Fail to open checkpoint index %s"),
+                                        m_file.c_str());
+
+        std::string buffer((std::istreambuf_iterator<char>(ifs)),
+                           std::istreambuf_iterator<char>());
+        if (buffer.compare(0,
+                           sizeof(index_file_magic),
+                           index_file_magic,
+                           sizeof(index_file_magic)) != 0)
+            throw vle::utils::FileError(_("%s is not a checkpoint index"),
+                                        m_file.c_str());
+
+        if (buffer.size() < header_size)
+            throw vle::utils::FileError(_("Corrupted checkpoint index %s"),
+                                        m_file.c_str());
+
+        vle::value::BinaryReader in(buffer.data() + sizeof(index_file_magic),
+                                    buffer.data() + buffer.size());
+        if (in.readUint8() != 2)
+            throw vle::utils::FileError(_("Unknown checkpoint index"));
+
+        m_binary = in.readUint8() != 0;
+        m_begin = in.readUint64();
+        m_end = m_begin;
+        m_rows.clear();
+        m_blocks.resize((buffer.size() - header_size) / record_size);
+        for (auto& block : m_blocks) {
+            block.first = in.readUint64();
+            block.last = in.readUint64();
+            block.offset = in.readUint64();
+            block.size = in.readUint64();
+
+            if (block.first > block.last or block.offset != m_end)
+                throw vle::utils::FileError(
+                  _("Corrupted checkpoint index %s"), m_file.c_str());
+
+            m_end = block.offset + block.size;
+            mark(block);
+        }
+    }
+
+    /**
+     * Rewrite the index of a previous run to resume it: the blocks
+     * contiguous in the output file and in the input rows are merged.
+     */
+    void compact()
+    {
+        std::vector<Block> blocks;
+        for (const auto& block : m_blocks) {
+            if (not blocks.empty() and blocks.back().last == block.first) {
+                blocks.back().last = block.last;
+                blocks.back().size += block.size;
+            } else {
+                blocks.push_back(block);
+            }
+        }
+
+        m_blocks.swap(blocks);
+        save();
+    }
+
+    /**
+     * Start an empty index for an output file which begins with a header
+     * of @c size bytes.
+     */
+    void start(uint64_t size)
+    {
+        m_rows.clear();
+        m_blocks.clear();
+        m_begin = size;
+        m_end = size;
+        save();
+    }
+
+    /**
+     * Append the rows [first, last[ written at the end of the output file,
+     * which now ends at @c end, to the index.
+     */
+    void add(int first, int last, uint64_t end)
+    {
+        m_blocks.push_back({ static_cast<uint64_t>(first),
+                             static_cast<uint64_t>(last),
+                             m_end,
+                             end - m_end });
+        m_end = end;
+        mark(m_blocks.back());
+
+        std::string buffer;
+        vle::value::BinaryWriter out(buffer);
+        write_block(out, m_blocks.back());
+        m_journal.write(buffer.data(), buffer.size());
+        m_journal.flush();
+        if (not m_journal.good())
+            throw vle::utils::FileError(_("Fail to write checkpoint index %s"),
+                                        m_file.c_str());
+    }
+
+    bool done(int row) const noexcept
+    {
+        auto byte = static_cast<std::size_t>(row / 8);
+        return byte < m_rows.size() and (m_rows[byte] & (1u << (row % 8)));
+    }
+
+    bool binary() const noexcept
+    {
+        return m_binary;
+    }
+
+    uint64_t begin() const noexcept
+    {
+        return m_begin;
+    }
+
+    uint64_t end() const noexcept
+    {
+        return m_end;
+    }
+
+    const std::vector<Block>& blocks() const noexcept
+    {
+        return m_blocks;
+    }
+};
+
 class Root
 {
     std::shared_ptr<std::istream> m_is;
     std::shared_ptr<std::ostream> m_os;
     std::ofstream m_ofs;
-    int m_first_id;
+    const Checkpoint* m_checkpoint;
+    uint64_t m_offset;
     int m_last_id;
     int m_blocksize;
 
 public:
-    Root(const std::string& input, const std::string& output, int blocksize)
+    /**
+     * Open the input and output files. With a @c checkpoint of a previous
+     * run, the output file is truncated after the blocks of the index and
+     * opened to append the next blocks, and the rows of the index are
+     * skipped by @c read.
+     */
+    Root(const std::string& input,
+         const std::string& output,
+         int blocksize,
+         bool binary = false,
+         const Checkpoint* checkpoint = nullptr)
       : m_is(&std::cin, no_deleter<std::istream>())
       , m_os(&std::cout, no_deleter<std::ostream>())
-      , m_first_id(0)
+      , m_checkpoint(checkpoint)
+      , m_offset(0)
       , m_last_id(0)
       , m_blocksize(blocksize)
     {
         if (!input.empty())
             m_is = open<std::ifstream>(input);
 
-        if (!output.empty())
-            m_os = open<std::ofstream>(output);
+        auto mode = std::ios::out;
+        if (binary)
+            mode |= std::ios::binary;
+
+        if (checkpoint) {
+            m_offset = checkpoint->end();
+            if (::truncate(output.c_str(),
+                           static_cast<off_t>(m_offset)) != 0)
+                throw vle::utils::FileError(
+                  _("Fail to truncate file %s: %s"),
+                  output.c_str(),
+                  std::strerror(errno));
+            mode |= std::ios::app;
+        }
+
+        if (!output.empty()) {
+            auto ofs = std::make_shared<std::ofstream>(output.c_str(), mode);
+            if (not ofs->is_open())
+                throw vle::utils::FileError(_("Fail to open file %s"),
+                                            output.c_str());
+            m_os = ofs;
+        }
     }
 
     bool header(std::string& header)
@@ -1003,11 +1826,16 @@ public:
         return m_is.get()->good();
     }
 
+    /**
+     * Read the next block of rows [first, last[. The rows finished in the
+     * checkpoint are skipped and end the block, so a block is always a
+     * range of consecutive rows.
+     */
     bool read(std::string& block, int& first, int& last)
     {
-        m_first_id = m_last_id;
         int i = 0;
         block.clear();
+        first = last = m_last_id;
 
         if (m_is->fail())
             return false;
@@ -1016,35 +1844,271 @@ public:
             std::string tmp;
             std::getline(*m_is.get(), tmp);
 
-            if (not tmp.empty()) {
+            if (tmp.empty())
+                return not block.empty();
+
+            if (m_checkpoint and m_checkpoint->done(m_last_id)) {
                 ++m_last_id;
-                block += tmp;
-                block += '\n';
-                ++i;
-            } else {
-                first = m_first_id;
-                last = m_last_id;
+                if (i)
+                    return true;
 
-                return not block.empty();
+                first = last = m_last_id;
+                continue;
             }
+
+            ++m_last_id;
+            last = m_last_id;
+            block += tmp;
+            block += '\n';
+            ++i;
         }
-        first = m_first_id;
-        last = m_last_id;
 
         return true;
     }
 
+    /**
+     * @return The size of the output file.
+     */
+    uint64_t offset() const noexcept
+    {
+        return m_offset;
+    }
+
     void write(const std::string& block)
     {
         (*m_os.get()) << block;
         m_os->flush();
+        m_offset += block.size();
+    }
+
+    /**
+     * Start a binary output file: a magic string, the version of the
+     * format and the more output details option.
+     */
+    void write_binary_header(bool more_output_details)
+    {
+        std::string header(binary_file_magic, sizeof(binary_file_magic));
+        vle::value::BinaryWriter out(header);
+        out.writeUint8(1);
+        out.writeUint8(more_output_details ? 1 : 0);
+        write(header);
+    }
+
+    /**
+     * Write a packed block of the workers, after its size.
+     */
+    void write_binary(const std::string& block)
+    {
+        std::string size;
+        vle::value::BinaryWriter(size).writeUint64(block.size());
+        (*m_os.get()) << size;
+        m_offset += size.size();
+        write(block);
     }
 };
 
+/**
+ * Encode a csv block of the master into a binary block: the values of the
+ * columns are converted to the type of the values of the vpz.
+ */
+static std::string
+encode_block(const std::string& block, const Columns* columns)
+{
+    auto rows = split_rows(block);
+
+    if (columns) {
+        std::vector<std::string> cells;
+        for (auto& row : rows) {
+            boost::algorithm::split(
+              cells, row, boost::algorithm::is_any_of(","));
+
+            std::string encoded;
+            vle::value::BinaryWriter out(encoded);
+            out.writeUint32(static_cast<uint32_t>(cells.size()));
+            for (std::size_t i = 0, e = cells.size(); i != e; ++i)
+                out.writeValue(
+                  columns->parse(i, cleanup_token(cells[i])).get());
+
+            row = std::move(encoded);
+        }
+    }
+
+    return encode_rows(rows);
+}
+
+/**
+ * Build the result block of the rows of a worker pool.
+ */
+static std::string
+pack_results(const std::vector<std::string>& rows, bool binary, bool compress)
+{
+    if (binary)
+        return pack_block(encode_rows(rows), compress);
+
+    std::string block;
+    for (const auto& row : rows)
+        block += row;
+
+    return block;
+}
+
+/**
+ * Convert a binary output file of cvle into the csv output file of the
+ * text mode.
+ */
+int
+convert_to_csv(const std::string& input, const std::string& output) noexcept
+{
+    try {
+        std::ifstream ifs(input, std::ios::binary);
+        if (not ifs.is_open())
+            throw vle::utils::FileError(_("Fail to open file %s"),
+                                        input.c_str());
+
+        std::shared_ptr<std::ostream> os(&std::cout,
+                                         no_deleter<std::ostream>());
+        if (not output.empty())
+            os = open<std::ofstream>(output);
+        setup_stream(*os);
+
+        auto read = [&ifs](std::size_t size) {
+            std::string buffer(size, '\0');
+            if (size and not ifs.read(&buffer[0], size))
+                throw vle::utils::FileError(_("Truncated binary file"));
+            return buffer;
+        };
+
+        std::string header = read(sizeof(binary_file_magic) + 2);
+        if (header.compare(0,
+                           sizeof(binary_file_magic),
+                           binary_file_magic,
+                           sizeof(binary_file_magic)) or
+            header[sizeof(binary_file_magic)] != 1)
+            throw vle::utils::FileError(
+              _("%s is not a binary output file of cvle"), input.c_str());
+
+        bool more_output_details = header[sizeof(binary_file_magic) + 1];
+
+        for (;;) {
+            char size[8];
+            if (not ifs.read(size, sizeof(size))) {
+                if (ifs.gcount() == 0)
+                    break;
+                throw vle::utils::FileError(_("Truncated binary file"));
+            }
+
+            vle::value::BinaryReader in(size, size + sizeof(size));
+            auto rows = decode_rows(
+              unpack_block(read(static_cast<std::size_t>(in.readUint64()))));
+
+            for (const auto& row : rows) {
+                vle::value::BinaryReader record(row.data(),
+                                                row.data() + row.size());
+                *os << record.readString();
+                if (record.readUint8() == binary_views) {
+                    auto views = record.readValue();
+                    if (views and views->isMap())
+                        write_views(*os, views->toMap(), more_output_details);
+                } else {
+                    *os << record.readString();
+                }
+                *os << record.readString();
+            }
+        }
+
+        os->flush();
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Failed to convert the binary file: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Copy the blocks of an output file in the order of the input rows, using
+ * its checkpoint index. The merge of a binary output file is a binary
+ * output file.
+ */
+int
+merge_output(const std::string& input, const std::string& output) noexcept
+{
+    try {
+        Checkpoint checkpoint(input, false);
+        checkpoint.load();
+
+        std::ifstream ifs(input, std::ios::binary);
+        if (not ifs.is_open())
+            throw vle::utils::FileError(_("Fail to open file %s"),
+                                        input.c_str());
+
+        std::shared_ptr<std::ostream> os(&std::cout,
+                                         no_deleter<std::ostream>());
+        if (not output.empty()) {
+            auto ofs = std::make_shared<std::ofstream>(
+              output.c_str(), std::ios::out | std::ios::binary);
+            if (not ofs->is_open())
+                throw vle::utils::FileError(_("Fail to open file %s"),
+                                            output.c_str());
+            os = ofs;
+        }
+
+        auto copy = [&ifs, &os](uint64_t offset, uint64_t size) {
+            std::string buffer(static_cast<std::size_t>(size), '\0');
+            ifs.seekg(static_cast<std::streamoff>(offset));
+            if (size and not ifs.read(&buffer[0], buffer.size()))
+                throw vle::utils::FileError(_("Truncated output file"));
+            os->write(buffer.data(), buffer.size());
+        };
+
+        auto blocks = checkpoint.blocks();
+        std::sort(blocks.begin(),
+                  blocks.end(),
+                  [](const Checkpoint::Block& lhs,
+                     const Checkpoint::Block& rhs) {
+                      return lhs.first < rhs.first;
+                  });
+
+        copy(0, checkpoint.begin());
+        for (const auto& block : blocks)
+            copy(block.offset, block.size);
+
+        os->flush();
+        if (not os->good())
+            throw vle::utils::FileError(_("Fail to write the merged file"));
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Failed to merge the output file: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * The master reads the blocks of the input file and gives @c prefetch
+ * blocks in advance (the credits) to each worker rank: a worker starts its
+ * next block as soon as it finishes one, without waiting for the master.
+ * Each result received gives back a credit to its worker and is recorded
+ * in the checkpoint index of the output file.
+ *
+ * With @c master_threads, the master also simulates rows on its own
+ * worker pool. To keep the latency of the other ranks low, it runs one
+ * block at a time, read only after the blocks of the other ranks, and it
+ * waits for its threads only when no message of the other ranks is
+ * waiting.
+ */
 int
 run_as_master(const std::string& inputfile,
               const std::string& outputfile,
-              int blocksize)
+              int blocksize,
+              int prefetch,
+              const std::string& vpz,
+              bool binary,
+              bool compress,
+              bool more_output_details,
+              bool resume,
+              int master_threads,
+              const std::function<std::unique_ptr<Worker>()>& make_worker)
 {
     int ret = EXIT_SUCCESS;
     int blockid = 0;
@@ -1054,76 +2118,174 @@ run_as_master(const std::string& inputfile,
         int world_size;
         MPI_Comm_size(MPI_COMM_WORLD, &world_size);
 
-        Root r(inputfile, outputfile, blocksize);
-        std::vector<bool> workers(world_size, false);
+        std::unique_ptr<Checkpoint> checkpoint;
+        if (not outputfile.empty()) {
+            checkpoint = std::make_unique<Checkpoint>(outputfile, binary);
+            if (resume) {
+                checkpoint->load();
+                if (checkpoint->binary() != binary)
+                    throw vle::utils::ArgError(
+                      _("The checkpoint index %s was written by a run %s "
+                        "the binary mode"),
+                      checkpoint->file().c_str(),
+                      binary ? _("without") : _("with"));
+
+                printf(_("master resumes after %d blocks\n"),
+                       static_cast<int>(checkpoint->blocks().size()));
+                checkpoint->compact();
+            }
+        } else if (resume) {
+            throw vle::utils::ArgError(_("Resume needs an output file"));
+        }
+
+        Root r(inputfile,
+               outputfile,
+               blocksize,
+               binary,
+               resume ? checkpoint.get() : nullptr);
+        std::vector<int> credits(world_size, 0); // blocks sent, not received
+        std::list<PendingBlock> pending;
+        std::unique_ptr<Columns> columns; // types of the binary mode
         std::string block, header;
+        bool more = true; // Stop when all buffer are sent.
         r.header(header);
 
+        if (binary and not resume)
+            r.write_binary_header(more_output_details);
+
+        if (checkpoint and not resume)
+            checkpoint->start(r.offset());
+
+        if (binary) {
+            if (header != "_cvle_complex_values") {
+                VpzPtr exp = std::make_shared<vle::vpz::Vpz>();
+                if (vle::vpz::Vpz::isCompiledCacheEnabled())
+                    exp->parseFileCached(vpz);
+                else
+                    exp->parseFile(vpz);
+                columns = make_columns(header, exp, more_output_details);
+            }
+        }
+
         for (int rank = 1; rank != world_size; ++rank)
             mpi_send_string(rank, worker_block_header_tag, header);
 
-        for (int rank = 1; rank < world_size; ++rank) {
-            if (r.read(block, first, last)) {
-                mpi_send_block(rank, worker_block_todo_tag, block, first, last);
-                workers[rank] = true;
-            } else
-                break;
+        auto send_next = [&](int rank) {
+            more = more and r.read(block, first, last) and not block.empty();
+            if (more) {
+                printf(_("master sends block %d to %d\n"), blockid++, rank);
+                if (binary)
+                    block = pack_block(encode_block(block, columns.get()),
+                                       compress);
+                mpi_isend_block(rank,
+                                worker_block_todo_tag,
+                                std::move(block),
+                                first,
+                                last,
+                                pending);
+                credits[rank]++;
+            }
+        };
+
+        for (int i = 0; i < prefetch; ++i)
+            for (int rank = 1; rank < world_size; ++rank)
+                send_next(rank);
+
+        std::unique_ptr<WorkerPool> local;
+        if (master_threads > 0) {
+            local = std::make_unique<WorkerPool>(
+              master_threads, binary, make_worker);
+            local->init(header);
         }
 
-        bool end = false; // Stop when all buffer are sent.
-        int from;
+        auto run_next = [&]() {
+            if (not local or local->pending())
+                return;
+
+            more = more and r.read(block, first, last) and not block.empty();
+            if (more) {
+                printf(_("master runs block %d\n"), blockid++);
+                local->push(binary
+                              ? decode_rows(encode_block(block, columns.get()))
+                              : split_rows(block),
+                            first,
+                            last);
+            }
+        };
+
+        auto write_next = [&](int done_first, int done_last) {
+            if (binary)
+                r.write_binary(block);
+            else
+                r.write(block);
+
+            if (checkpoint)
+                checkpoint->add(done_first, done_last, r.offset());
+        };
+
+        run_next();
+
+        std::vector<std::string> rows;
+        int from, done_first, done_last;
         CommunicationTag tag;
-        while (end == false) {
-            std::tie(block, from, tag) = mpi_recv_string();
+        for (;;) {
+            bool remote = std::find_if(credits.begin(),
+                                       credits.end(),
+                                       [](int c) { return c > 0; }) !=
+                          credits.end();
 
-            assert(tag == worker_block_end_tag);
+            if (not remote and not(local and local->pending()))
+                break;
+
+            if (remote and (not local or mpi_message_ready(MPI_ANY_SOURCE))) {
+                std::tie(block, from, done_first, done_last, tag) =
+                  mpi_recv_block();
 
-            workers[from] = false;
-            r.write(block);
-            end = !r.read(block, first, last);
+                assert(tag == worker_block_end_tag);
 
-            if (not block.empty()) {
-                printf(_("master sends block %d to %d\n"), blockid++, from);
-                mpi_send_block(from, worker_block_todo_tag, block, first, last);
-                workers[from] = true;
+                credits[from]--;
+                write_next(done_first, done_last);
+                send_next(from);
+                mpi_complete_blocks(pending, false);
+                continue;
             }
-        }
 
-        while (std::find(workers.begin(), workers.end(), true) !=
-               workers.end()) {
-            std::tie(block, from, tag) = mpi_recv_string();
-            assert(tag == worker_block_end_tag);
-            workers[from] = false;
-            r.write(block);
+            if (local->pop(
+                  rows, done_first, done_last, std::chrono::milliseconds(1))) {
+                block = pack_results(rows, binary, compress);
+                write_next(done_first, done_last);
+                run_next();
+            }
         }
 
+        mpi_complete_blocks(pending, true);
+
         for (int rank = 1; rank < world_size; ++rank)
             mpi_send_string(rank, worker_end_tag, "ok");
     } catch (const std::exception& e) {
+        /* In binary mode, the master converts the rows: a bad value must
+         * stop the workers as it does in text mode. */
         std::fprintf(stderr, "master fails: %s\n", e.what());
-        ret = EXIT_SUCCESS;
+        MPI_Abort(MPI_COMM_WORLD, internal_failure_errorcode);
     }
 
     return ret;
 }
 
+/**
+ * A worker rank receives the blocks of the master and runs their rows on
+ * @c threads threads. While the threads simulate, the worker receives the
+ * next blocks and sends the results of the finished blocks.
+ */
 int
-run_as_worker(const std::string& vpz,
-              std::chrono::milliseconds timeout,
-              bool withoutspawn,
-              bool warnings,
-              bool more_output_details,
-              bool workspace_per_worker,
-              const std::string& workspace_prefix_path)
+run_as_worker(int threads,
+              bool binary,
+              bool compress,
+              const std::function<std::unique_ptr<Worker>()>& make_worker)
 {
     try {
-        Worker w(timeout,
-                 vpz,
-                 withoutspawn,
-                 warnings,
-                 more_output_details,
-                 workspace_per_worker,
-                 workspace_prefix_path);
+        WorkerPool w(threads, binary, make_worker);
+        std::vector<std::string> rows;
         std::string block;
         int from;
         int first, last;
@@ -1149,22 +2311,36 @@ run_as_worker(const std::string& vpz,
         //
 
         bool end = false;
-        while (not end) {
-            std::tie(block, first, last, tag) = mpi_worker();
-
-            switch (tag) {
-            case worker_end_tag:
-                end = true;
-                break;
-
-            case worker_block_todo_tag:
-                block = w.run(block, first, last);
-                mpi_send_string(0, worker_block_end_tag, block);
-                break;
+        while (not end or w.pending()) {
+            // Without block in progress, the worker waits for the master.
+            if (not end and (not w.pending() or mpi_message_ready(0))) {
+                std::tie(block, std::ignore, first, last, tag) =
+                  mpi_recv_block();
+
+                switch (tag) {
+                case worker_end_tag:
+                    end = true;
+                    break;
+
+                case worker_block_todo_tag:
+                    fprintf(stdout, "worker run row %d to %d\n", first, last);
+                    w.push(binary ? decode_rows(unpack_block(block))
+                                  : split_rows(block),
+                           first,
+                           last);
+                    break;
+
+                default:
+                    fprintf(stderr, "Internal error in MPI message order\n");
+                    MPI_Abort(MPI_COMM_WORLD, message_order_errorcode);
+                }
+                continue;
+            }
 
-            default:
-                fprintf(stderr, "Internal error in MPI message order\n");
-                MPI_Abort(MPI_COMM_WORLD, message_order_errorcode);
+            if (w.pop(rows, first, last, std::chrono::milliseconds(1))) {
+                fprintf(stdout, "worker finishes row %d to %d\n", first, last);
+                block = pack_results(rows, binary, compress);
+                mpi_send_block(0, worker_block_end_tag, block, first, last);
             }
         }
     } catch (const std::exception& e) {
@@ -1189,11 +2365,29 @@ show_help()
              "  output-file,o file              csv output file\n"
              "  withoutspawn                    Perform simulation into "
              "the worker process\n"
+             "  warm-start                      Restart the loaded models "
+             "with the conditions of each row\n"
              "  warnings                        Show warnings in output\n"
              "  template,t file                 Generate a template csv input "
              "file\n"
              "  block-size,b size               Set number of lines to be sent"
-             " [default 5000]\n"));
+             " [default 5000]\n"
+             "  prefetch size                   Set number of blocks sent in "
+             "advance to each worker [default 2]\n"
+             "  threads,j size                  Set number of threads of each "
+             "worker [default 1]\n"
+             "  master-threads size             Set number of simulation "
+             "threads of the master, 0 to disable [default 1]\n"
+             "  binary                          Send typed rows and binary "
+             "results, write a binary output file\n"
+             "  compress                        Compress the blocks of the "
+             "binary mode\n"
+             "  to-csv file                     Convert a binary output file "
+             "into the csv output file\n"
+             "  resume                          Skip the rows already in the "
+             "output file (see its .index file)\n"
+             "  merge file                      Write an output file in the "
+             "order of the input rows\n"));
 }
 
 struct mpi_session_manager
@@ -1201,10 +2395,17 @@ struct mpi_session_manager
     mpi_session_manager(int argc, char* argv[])
       : timeout(std::chrono::milliseconds::zero())
       , withoutspawn(0)
+      , warm_start(0)
       , warnings(0)
       , more_output_details(0)
       , workspace_per_worker(0)
       , block_size(5000)
+      , prefetch(2)
+      , threads(1)
+      , master_threads(1)
+      , binary(0)
+      , compress(0)
+      , resume(0)
       , status(EXIT_SUCCESS)
     {
         if (MPI_Init(&argc, &argv) != MPI_SUCCESS)
@@ -1220,15 +2421,24 @@ struct mpi_session_manager
     std::string input_file;
     std::string output_file;
     std::string template_file;
+    std::string binary_file;
+    std::string merge_file;
     std::string workspace_prefix_path;
     std::vector<std::string> vpz;
     std::string vpz_abs;
     std::chrono::milliseconds timeout;
     int withoutspawn;
+    int warm_start;
     int warnings;
     int more_output_details;
     int workspace_per_worker;
     int block_size;
+    int prefetch;
+    int threads;
+    int master_threads;
+    int binary;
+    int compress;
+    int resume;
     int status;
 };
 
@@ -1251,12 +2461,29 @@ main_mpi(vle::utils::ContextPtr ctx, mpi_session_manager& session)
                   generate_template(session.template_file, session.vpz_abs);
             }
         } else {
-            if (world_size == 1) {
-                fprintf(stderr, _("cvle needs two processors.\n"));
+            if (world_size == 1 and session.master_threads == 0) {
+                fprintf(stderr,
+                        _("cvle needs two processors or the simulations "
+                          "of the master.\n"));
                 status = EXIT_FAILURE;
             } else {
+                auto make_worker = [&session]() {
+                    return std::make_unique<Worker>(
+                      session.timeout,
+                      session.vpz_abs,
+                      session.withoutspawn,
+                      session.warm_start,
+                      session.warnings,
+                      session.more_output_details,
+                      session.workspace_per_worker,
+                      session.workspace_prefix_path);
+                };
+
                 if (rank == 0) {
                     printf(_("block size: %d\n"
+                             "prefetch  : %d\n"
+                             "threads   : %d\n"
+                             "master threads: %d\n"
                              "package   : %s\n"
                              "timeout   : %ld\n"
                              "input csv : %s\n"
@@ -1264,6 +2491,9 @@ main_mpi(vle::utils::ContextPtr ctx, mpi_session_manager& session)
                              "workspace prefix: %s\n"
                              "vpz       : %s\n"),
                            session.block_size,
+                           session.prefetch,
+                           session.threads,
+                           session.master_threads,
                            session.package_name.c_str(),
                            session.timeout.count(),
                            (session.input_file.empty())
@@ -1279,15 +2509,20 @@ main_mpi(vle::utils::ContextPtr ctx, mpi_session_manager& session)
 
                     status = run_as_master(session.input_file,
                                            session.output_file,
-                                           session.block_size);
-                } else {
-                    status = run_as_worker(session.vpz_abs,
-                                           session.timeout,
-                                           session.withoutspawn,
-                                           session.warnings,
+                                           session.block_size,
+                                           session.prefetch,
+                                           session.vpz_abs,
+                                           session.binary,
+                                           session.compress,
                                            session.more_output_details,
-                                           session.workspace_per_worker,
-                                           session.workspace_prefix_path);
+                                           session.resume,
+                                           session.master_threads,
+                                           make_worker);
+                } else {
+                    status = run_as_worker(session.threads,
+                                           session.binary,
+                                           session.compress,
+                                           make_worker);
                 }
             }
         }
@@ -1305,7 +2540,7 @@ main(int argc, char* argv[])
     mpi_session_manager session(argc, argv);
     int ret = EXIT_SUCCESS;
 
-    const char* const short_opts = "hP:i:o:t:b:w:";
+    const char* const short_opts = "hP:i:o:t:b:w:j:";
     const struct option long_opts[] = {
         { "help", 0, nullptr, 'h' },
         { "timeout", 1, nullptr, 0 },
@@ -1315,8 +2550,17 @@ main(int argc, char* argv[])
         { "template", 1, nullptr, 't' },
         { "workspace-prefix-path", 1, nullptr, 'w' },
         { "withoutspawn", 0, &session.withoutspawn, 1 },
+        { "warm-start", 0, &session.warm_start, 1 },
         { "warnings", 0, &session.warnings, 1 },
         { "block-size", 1, nullptr, 'b' },
+        { "prefetch", 1, nullptr, 0 },
+        { "threads", 1, nullptr, 'j' },
+        { "master-threads", 1, nullptr, 0 },
+        { "binary", 0, &session.binary, 1 },
+        { "compress", 0, &session.compress, 1 },
+        { "to-csv", 1, nullptr, 0 },
+        { "resume", 0, &session.resume, 1 },
+        { "merge", 1, nullptr, 0 },
         { "more-output-details", 0, &session.more_output_details, 1 },
         { nullptr, 0, nullptr, 0 }
     };
@@ -1344,6 +2588,33 @@ main(int argc, char* argv[])
                             ::optarg);
                     ret = EXIT_FAILURE;
                 }
+            } else if (not strcmp(long_opts[opt_index].name, "prefetch")) {
+                try {
+                    session.prefetch = std::stoi(::optarg);
+                    if (session.prefetch < 1) {
+                        ret = EXIT_FAILURE;
+                    }
+                } catch (const std::exception& /* e */) {
+                    fprintf(stderr, _("Bad prefetch: %s\n"), ::optarg);
+                    ret = EXIT_FAILURE;
+                }
+            } else if (not strcmp(long_opts[opt_index].name,
+                                  "master-threads")) {
+                try {
+                    session.master_threads = std::stoi(::optarg);
+                    if (session.master_threads < 0) {
+                        ret = EXIT_FAILURE;
+                    }
+                } catch (const std::exception& /* e */) {
+                    fprintf(stderr,
+                            _("Bad number of master threads: %s\n"),
+                            ::optarg);
+                    ret = EXIT_FAILURE;
+                }
+            } else if (not strcmp(long_opts[opt_index].name, "to-csv")) {
+                session.binary_file = ::optarg;
+            } else if (not strcmp(long_opts[opt_index].name, "merge")) {
+                session.merge_file = ::optarg;
             }
             break;
         case 'h':
@@ -1380,6 +2651,17 @@ main(int argc, char* argv[])
                 ret = EXIT_FAILURE;
             }
             break;
+        case 'j':
+            try {
+                session.threads = std::stoi(::optarg);
+                if (session.threads < 1) {
+                    ret = EXIT_FAILURE;
+                }
+            } catch (const std::exception& /* e */) {
+                fprintf(stderr, _("Bad number of threads: %s\n"), ::optarg);
+                ret = EXIT_FAILURE;
+            }
+            break;
         case '?':
         default:
             ret = EXIT_FAILURE;
@@ -1388,9 +2670,31 @@ main(int argc, char* argv[])
         };
     }
 
+#ifndef VLE_HAVE_ZLIB
+    if (session.compress) {
+        fprintf(stderr, _("cvle is built without compression (zlib)\n"));
+        ret = EXIT_FAILURE;
+    }
+#endif
+
     if (ret != EXIT_SUCCESS)
         return ret;
 
+    if (session.compress)
+        session.binary = 1;
+
+    // the conversion or the merge of an output file does not need a vpz
+    if (not session.binary_file.empty() or not session.merge_file.empty()) {
+        int rank = 0;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (rank != 0)
+            return EXIT_SUCCESS;
+
+        return session.binary_file.empty()
+                 ? merge_output(session.merge_file, session.output_file)
+                 : convert_to_csv(session.binary_file, session.output_file);
+    }
+
     session.vpz.assign(argv + ::optind, argv + argc);
     if (session.vpz.size() == 0) {
         fprintf(stderr, _("Require 1 vpz \n"));
@@ -240,8 +240,22 @@ show_help() noexcept
         "standard error output\n"
         "write-output  output simulation results into XML output file. "
         "Need a file name parameter.\n"
+        "profile       write the profile of the models (calls and time of "
+        "the\n"
+        "              DEVS functions, events per port) and of the bags "
+        "into a JSON\n"
+        "              file. Need a file name parameter.\n"
+        "trace         write the timeline of the bags (date, size, wall "
+        "clock\n"
+        "              time of the phases and of the threads) of the last "
+        "simulation\n"
+        "              into a Chrome trace event JSON file. Need a file "
+        "name\n"
+        "              parameter.\n"
         "timeout       limit the simulation duration with a timeout in "
         "miliseconds.\n"
+        "worker        serve the simulations of a parent process on the "
+        "standard input and output\n"
         "name          change the identifier of the experiment. To use in\n"
         "                combination with the condition parameter to\n"
         "                generate simulation's output into different file\n"
@@ -435,23 +449,46 @@ run_simulation(vle::utils::ContextPtr ctx,
                std::chrono::milliseconds timeout,
                const std::string& name,
                const std::string& output_file,
+               const std::string& profile_file,
+               const std::string& trace_file,
                const vle::ConditionUpdater& conds,
                CmdArgs::const_iterator it,
                CmdArgs::const_iterator end,
                std::shared_ptr<vle::utils::Package> pkg)
 {
+    if (not profile_file.empty() and
+        timeout != std::chrono::milliseconds::zero())
+        fprintf(stderr,
+                _("Profile is not available with a timeout (simulations"
+                  " run in a sub process)\n"));
+
+    if (not trace_file.empty() and
+        timeout != std::chrono::milliseconds::zero())
+        fprintf(stderr,
+                _("Trace is not available with a timeout (simulations"
+                  " run in a sub process)\n"));
+
     vle::manager::Simulation sim(ctx,
-                                 vle::manager::SIMULATION_NONE,
+                                 profile_file.empty()
+                                   ? vle::manager::SIMULATION_NONE
+                                   : vle::manager::SIMULATION_PROFILE,
                                  timeout);
+    vle::devs::Profile profile;
     int success = EXIT_SUCCESS;
 
+    sim.setTrace(trace_file);
+
     for (; (it != end) and (success == EXIT_SUCCESS); ++it) {
         std::string vpzAbsolutePath = search_vpz(*it, pkg);
         if (vpzAbsolutePath.empty()) {
             success = EXIT_FAILURE;
         } else {
             vle::manager::Error error;
-            auto vpz = std::make_unique<vle::vpz::Vpz>(vpzAbsolutePath);
+            auto vpz = std::make_unique<vle::vpz::Vpz>();
+            if (vle::vpz::Vpz::isCompiledCacheEnabled())
+                vpz->parseFileCached(vpzAbsolutePath);
+            else
+                vpz->parseFile(vpzAbsolutePath);
 
             if (vpz and not conds.empty())
                 conds.update(*vpz);
@@ -460,6 +497,7 @@ run_simulation(vle::utils::ContextPtr ctx,
                 vpz->project().experiment().setName(name);
 
             auto res = sim.run(std::move(vpz), &error);
+            profile.merge(sim.profile());
 
             if (error.code) {
                 fprintf(stderr,
@@ -488,6 +526,19 @@ run_simulation(vle::utils::ContextPtr ctx,
         }
     }
 
+    if (not profile_file.empty()) {
+        std::ofstream ofs(profile_file);
+
+        if (not ofs) {
+            fprintf(stderr,
+                    _("Fail to write profile file %s\n"),
+                    profile_file.c_str());
+            success = EXIT_FAILURE;
+        } else {
+            profile.writeJson(ofs);
+        }
+    }
+
     return success;
 }
 
@@ -512,6 +563,8 @@ init_package(vle::utils::Package& pkg, const CmdArgs& args)
 static int
 manage_package_mode(vle::utils::ContextPtr ctx,
                     const std::string& output_file,
+                    const std::string& profile_file,
+                    const std::string& trace_file,
                     const vle::ConditionUpdater& conds,
                     std::chrono::milliseconds timeout,
                     const std::string& name,
@@ -594,8 +647,16 @@ manage_package_mode(vle::utils::ContextPtr ctx,
             ret =
               run_manager(ctx, timeout, name, conds, it, end, processor, pkg);
         else
-            ret = run_simulation(
-              ctx, timeout, name, output_file, conds, it, end, pkg);
+            ret = run_simulation(ctx,
+                                 timeout,
+                                 name,
+                                 output_file,
+                                 profile_file,
+                                 trace_file,
+                                 conds,
+                                 it,
+                                 end,
+                                 pkg);
     }
 
     return ret;
@@ -762,6 +823,8 @@ manage_remote_mode(vle::utils::ContextPtr ctx, CmdArgs args)
 static int
 manage_nothing_mode(vle::utils::ContextPtr ctx,
                     const std::string& output_file,
+                    const std::string& profile_file,
+                    const std::string& trace_file,
                     const vle::ConditionUpdater& conds,
                     std::chrono::milliseconds timeout,
                     const std::string& name,
@@ -783,8 +846,16 @@ manage_nothing_mode(vle::utils::ContextPtr ctx,
     if (manager_mode)
         ret = run_manager(ctx, timeout, name, conds, it, end, processor, pkg);
     else
-        ret =
-          run_simulation(ctx, timeout, name, output_file, conds, it, end, pkg);
+        ret = run_simulation(ctx,
+                             timeout,
+                             name,
+                             output_file,
+                             profile_file,
+                             trace_file,
+                             conds,
+                             it,
+                             end,
+                             pkg);
 
     return ret;
 }
@@ -865,6 +936,8 @@ main(int argc, char** argv)
 {
     vle::ConditionUpdater conds;
     std::string output_file;
+    std::string profile_file;
+    std::string trace_file;
     std::string name;
     std::chrono::milliseconds timeout{ std::chrono::milliseconds::zero() };
     unsigned int mode = CLI_MODE_NOTHING;
@@ -872,6 +945,7 @@ main(int argc, char** argv)
     int processor_number = 1;
     int log_dest = 1;
     int restart_conf = 0;
+    int worker = 0;
     int manager = 0;
     int opt_index;
     int ret = EXIT_SUCCESS;
@@ -887,7 +961,10 @@ main(int argc, char** argv)
                                         { "log-stdout", 0, &log_dest, 1 },
                                         { "log-stderr", 0, &log_dest, 2 },
                                         { "write-output", 1, nullptr, 0 },
+                                        { "profile", 1, nullptr, 0 },
+                                        { "trace", 1, nullptr, 0 },
                                         { "timeout", 1, nullptr, 0 },
+                                        { "worker", 0, &worker, 1 },
                                         { "verbose", 1, nullptr, 'V' },
                                         { "processor", 1, nullptr, 'j' },
                                         { "manager", 0, nullptr, 'm' },
@@ -906,6 +983,10 @@ main(int argc, char** argv)
         case 0:
             if (not strcmp(long_opts[opt_index].name, "write-output")) {
                 output_file = ::optarg;
+            } else if (not strcmp(long_opts[opt_index].name, "profile")) {
+                profile_file = ::optarg;
+            } else if (not strcmp(long_opts[opt_index].name, "trace")) {
+                trace_file = ::optarg;
             } else if (not strcmp(long_opts[opt_index].name, "timeout")) {
                 try {
                     long int t = std::stol(::optarg);
@@ -1004,6 +1085,12 @@ main(int argc, char** argv)
     if (mode & CLI_MODE_END)
         return ret;
 
+    if (manager and not profile_file.empty())
+        fprintf(stderr, _("Profile is not available in manager mode\n"));
+
+    if (manager and not trace_file.empty())
+        fprintf(stderr, _("Trace is not available in manager mode\n"));
+
     //
     // Otherwise, starts the simulation engines
     //
@@ -1012,6 +1099,16 @@ main(int argc, char** argv)
                                       : std::min(verbose_level, 7);
 
     ctx->set_log_priority(verbose_level);
+
+    //
+    // If --worker, the standard output is the connection with the parent
+    // process
+    //
+    if (worker) {
+        ctx->set_log_function(std::make_unique<vle_log_standard>(stderr));
+        return vle::manager::Simulation::serve(ctx);
+    }
+
     if (log_dest == 1)
         ctx->set_log_function(std::make_unique<vle_log_standard>(stdout));
     else if (log_dest == 2)
@@ -1025,6 +1122,8 @@ main(int argc, char** argv)
     case CLI_MODE_PACKAGE:
         ret = manage_package_mode(ctx,
                                   output_file,
+                                  profile_file,
+                                  trace_file,
                                   conds,
                                   timeout,
                                   name,
@@ -1041,6 +1140,8 @@ main(int argc, char** argv)
     case CLI_MODE_NOTHING:
         ret = manage_nothing_mode(ctx,
                                   output_file,
+                                  profile_file,
+                                  trace_file,
                                   conds,
                                   timeout,
                                   name,
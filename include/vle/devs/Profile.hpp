@@ -0,0 +1,143 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_DEVS_PROFILE_HPP
+#define VLE_DEVS_PROFILE_HPP
+
+#include <vle/DllDefines.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace devs {
+
+/**
+ * The number of calls of a function of a model and the time spent (in
+ * seconds of wall clock) in these calls.
+ */
+struct ProfileCounter
+{
+    std::uint64_t calls = 0;
+    double time = 0.0;
+
+    void merge(const ProfileCounter& other) noexcept
+    {
+        calls += other.calls;
+        time += other.time;
+    }
+};
+
+/**
+ * The profile of an atomic model or of all the models of a dynamics
+ * library: the functions of the @c devs::Dynamics and the events of its
+ * ports.
+ */
+struct VLE_API ModelProfile
+{
+    enum Phase
+    {
+        OUTPUT,
+        INTERNAL,
+        EXTERNAL,
+        CONFLUENT,
+        TIME_ADVANCE,
+        OBSERVATION,
+        PHASE_COUNT
+    };
+
+    std::string library; /**< The package and the library of the
+                          * dynamics (package/library). */
+    std::uint64_t models = 0; /**< The number of models merged. */
+    std::array<ProfileCounter, PHASE_COUNT> phases;
+    std::map<std::string, std::uint64_t> output_events; /**< The events
+                                                         * built by the
+                                                         * output function
+                                                         * per port. */
+    std::map<std::string, std::uint64_t> input_events; /**< The events
+                                                        * received per
+                                                        * port. */
+
+    void merge(const ModelProfile& other);
+
+    /**
+     * @return The name used in the reports for a @c Phase.
+     */
+    static const char* phaseName(Phase phase) noexcept;
+};
+
+/**
+ * @c devs::Profile is the result of the profiler of the kernel: the
+ * profile of each atomic model and the histogram of the sizes of the bags
+ * (the number of models which have a transition at the same date). The
+ * profile is computed only on demand (see @c manager::SIMULATION_PROFILE)
+ * and the models are wrapped only while it is enabled.
+ */
+struct VLE_API Profile
+{
+    /** The atomic models by complete name (see
+     * @c vpz::BaseModel::getCompleteName). */
+    std::map<std::string, ModelProfile> models;
+
+    /** @c bags[i] is the number of bags of @c 2^i to @c 2^(i+1) - 1
+     * models, the empty bags are counted in @c bags[0]. */
+    std::vector<std::uint64_t> bags;
+
+    bool empty() const noexcept
+    {
+        return models.empty() and bags.empty();
+    }
+
+    /**
+     * Count a bag of @c size models into the histogram.
+     */
+    void addBag(std::size_t size);
+
+    /**
+     * Add the profiles of the models and the bags of @c other, for
+     * example to cumulate the profiles of several simulations.
+     */
+    void merge(const Profile& other);
+
+    /**
+     * @return The profiles of the models merged by dynamics library.
+     */
+    std::map<std::string, ModelProfile> libraries() const;
+
+    /**
+     * Write the profile in JSON: the histogram of the bags, the profiles
+     * by library and by model.
+     */
+    void writeJson(std::ostream& out) const;
+};
+}
+} // namespace vle devs
+
+#endif
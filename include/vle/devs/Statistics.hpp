@@ -0,0 +1,71 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_DEVS_STATISTICS_HPP
+#define VLE_DEVS_STATISTICS_HPP
+
+#include <cstdint>
+
+namespace vle {
+namespace devs {
+
+/**
+ * @c devs::Statistics counts the work of the kernel during a simulation:
+ * the bags, the calls of the functions of the models, the events routed
+ * and the time spent (in seconds of wall clock) in the phases of the
+ * processing of a bag. The statistics are computed only on demand (see
+ * @c manager::SIMULATION_STATISTICS).
+ */
+struct Statistics
+{
+    std::uint64_t bags = 0;
+    std::uint64_t outputs = 0;         /**< Calls of the output function. */
+    std::uint64_t output_events = 0;   /**< Events built by the outputs. */
+    std::uint64_t external_events = 0; /**< Events routed to a model. */
+    std::uint64_t internal_transitions = 0;
+    std::uint64_t external_transitions = 0;
+    std::uint64_t confluent_transitions = 0;
+    std::uint64_t observations = 0;
+
+    double output_time = 0.0;      /**< The output functions. */
+    double routing_time = 0.0;     /**< The routing of the events. */
+    double transition_time = 0.0;  /**< The transitions and the scheduling
+                                    * of the next internal events. */
+    double observation_time = 0.0; /**< The observations and the output
+                                    * plug-ins. */
+    double scheduler_time = 0.0;   /**< The build of the next bag. */
+
+    std::uint64_t transitions() const noexcept
+    {
+        return internal_transitions + external_transitions +
+               confluent_transitions;
+    }
+};
+}
+} // namespace vle devs
+
+#endif
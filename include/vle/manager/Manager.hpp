@@ -28,6 +28,7 @@
 #define VLE_MANAGER_MANAGER_HPP
 
 #include <chrono>
+#include <memory>
 #include <vle/DllDefines.hpp>
 #include <vle/manager/Types.hpp>
 #include <vle/utils/Context.hpp>
@@ -37,6 +38,8 @@
 namespace vle {
 namespace manager {
 
+class SimulationCache;
+
 /**
  * @c manager::Manager permits to run experimental plans.
  *
@@ -45,7 +48,45 @@ namespace manager {
  *
  */
 
-enum ParallelOptions {PARALLEL_MONO, PARALLEL_THREADS, PARALLEL_MPI};
+/**
+ * @c PARALLEL_PROCESSES runs the simulations in @c nbslots local worker
+ * processes (`vle --worker`), without MPI: a crash or a leak of a model
+ * only affects its worker process, which is restarted.
+ */
+enum ParallelOptions {PARALLEL_MONO, PARALLEL_THREADS, PARALLEL_MPI,
+    PARALLEL_PROCESSES};
+
+/**
+ * @c manager::PlanSink receives the outputs of each simulation of an
+ * experiment plan as soon as the simulation is finished, instead of the
+ * aggregated values returned at the end of the plan (see
+ * @c Manager::runPlan).
+ */
+class VLE_API PlanSink
+{
+public:
+    virtual ~PlanSink() = default;
+
+    /**
+     * @brief Receives the outputs of one simulation. Called once for each
+     * simulation of the plan, in no particular order. Calls are serialized
+     * by the manager, even with threads.
+     *
+     * @param[in] input, the input index of the simulation
+     * @param[in] replicate, the replicate index of the simulation
+     * @param[in] outputs, for each output id of the plan, the temporal
+     *                     integration of the output for this simulation:
+     *                     the last value, the max, the sum or the mse,
+     *                     or for the integration 'all' the complete
+     *                     series (a @c value::Tuple for real values, a
+     *                     @c value::Set otherwise)
+     *
+     * An exception stops the plan and is reported as an error.
+     */
+    virtual void write(unsigned int input,
+                       unsigned int replicate,
+                       std::unique_ptr<value::Map> outputs) = 0;
+};
 
 class VLE_API Manager
 {
@@ -87,6 +128,18 @@ public:
     void configure(const vle::value::Map& config);
     void configure(const devs::InitEventList& config);
 
+    /**
+     * Use a cache of the simulation results for the next plans run with
+     * the mono, threads or processes parallel options. The cache is also
+     * created by the configuration: 'simulation_cache' (the maximal
+     * number of results kept in memory, 0 to disable the cache) and
+     * 'simulation_cache_dir' (a directory to store the results).
+     *
+     * @param[in] cache, the cache, nullptr to disable the cache, for
+     *                   stochastic plans without fixed seeds
+     */
+    void setSimulationCache(std::shared_ptr<SimulationCache> cache);
+
     /**
      * get access to the random number generator
      */
@@ -140,6 +193,38 @@ public:
             std::unique_ptr<vpz::Vpz> exp,
             const devs::InitEventList& init,
             Error& err);
+
+    /**
+     * @brief Simulates the experiment plan and streams the outputs of
+     * each simulation to a sink. Nothing is aggregated, the memory used
+     * does not depend on the size of the plan.
+     *
+     * @param[in/optional] exp, the model to simulate, if not available, it
+     *                          is built from the init structure for
+     *                          configurations
+     * @param[in] init, structure for the configuration of simulations,
+     *                  either an init event list or a value Map
+     * @param[in] sink, receives the outputs of each simulation
+     * @param[out] err, an error structure
+     */
+    void runPlan(
+            const vle::value::Map& init,
+            PlanSink& sink,
+            Error& err);
+    void runPlan(
+            const devs::InitEventList& init,
+            PlanSink& sink,
+            Error& err);
+    void runPlan(
+            std::unique_ptr<vpz::Vpz> exp,
+            const vle::value::Map& init,
+            PlanSink& sink,
+            Error& err);
+    void runPlan(
+            std::unique_ptr<vpz::Vpz> exp,
+            const devs::InitEventList& init,
+            PlanSink& sink,
+            Error& err);
     /**
      * @brief Get the embedded model configured for specific input and
      * replicate values
@@ -28,7 +28,11 @@
 #define VLE_MANGER_SIMULATION_HPP
 
 #include <chrono>
+#include <memory>
+#include <string>
 #include <vle/DllDefines.hpp>
+#include <vle/devs/Profile.hpp>
+#include <vle/devs/Statistics.hpp>
 #include <vle/manager/Types.hpp>
 #include <vle/utils/Context.hpp>
 #include <vle/vpz/Vpz.hpp>
@@ -36,6 +40,8 @@
 namespace vle {
 namespace manager {
 
+class SimulationCache;
+
 /**
  * @c manager::Simulation permits to run single simulation.
  *
@@ -63,6 +69,98 @@ public:
     std::unique_ptr<value::Map> run(std::unique_ptr<vpz::Vpz> vpz,
                                     Error* error);
 
+    /**
+     * Run a simulation of a @c vpz::Vpz kept by the caller, for example a
+     * base experiment whose conditions are modified between the runs.
+     *
+     * With the @c SIMULATION_WARM_START option, if the models of the
+     * previous run are kept and the vpz has the same structure (models,
+     * dynamics and views, the locations of the outputs may differ), the
+     * run is a @c restart with the conditions, the locations of the
+     * outputs and the instance of the vpz: the vpz is neither copied nor sent again to
+     * the worker process, only the values of the conditions that changed
+     * are. Otherwise, the simulation in the current process works on a
+     * copy of the vpz and the worker process receives the whole vpz.
+     */
+    std::unique_ptr<value::Map> run(const vpz::Vpz& vpz, Error* error);
+
+    /**
+     * Use a cache of results: @c run and @c restart return the stored
+     * result of an identical experiment without simulation, and store the
+     * result of a successful simulation. The cache is not used with the
+     * @c SIMULATION_NO_RETURN option.
+     *
+     * @param cache the cache, possibly shared with other simulations, or
+     * nullptr to stop caching.
+     */
+    void setCache(std::shared_ptr<SimulationCache> cache);
+
+    /**
+     * Write the timeline of the bags of the next @c run and @c restart in
+     * the Chrome trace event format (chrome://tracing or the Perfetto UI):
+     * the date, the wall clock time and the size of each bag, its phases
+     * and the work of each thread of the parallel transitions. Each run
+     * overwrites the file. The trace is not written for a simulation in a
+     * worker process or a result of the cache.
+     *
+     * @param filename the file of the trace, or an empty string to stop
+     * tracing.
+     */
+    void setTrace(std::string filename);
+
+    /**
+     * Check if the models of the previous run are kept. It requires the
+     * @c SIMULATION_WARM_START option, a successful previous run in the
+     * current process and models without executive.
+     */
+    bool isRestartable() const;
+
+    /**
+     * Get the statistics of the kernel of the last @c run or @c restart,
+     * computed with the @c SIMULATION_STATISTICS option. They are empty
+     * for a simulation in a worker process or a result of the cache.
+     */
+    const devs::Statistics& statistics() const;
+
+    /**
+     * Get the profile of the models and of the bags of the last @c run or
+     * @c restart, computed with the @c SIMULATION_PROFILE option. It is
+     * empty for a simulation in a worker process or a result of the cache.
+     */
+    const devs::Profile& profile() const;
+
+    /**
+     * Run again the models of the previous run with other conditions,
+     * without loading the models, the dynamics plug-ins and the output
+     * plug-ins again. The dynamics are built again from the conditions.
+     *
+     * @param conditions the conditions of a @c vpz::Vpz that differs from
+     * the one of the previous run only by the values of its conditions.
+     */
+    std::unique_ptr<value::Map> restart(const vpz::Conditions& conditions,
+                                        Error* error);
+
+    /**
+     * Same as @c restart, with the locations of the @c outputs and another
+     * instance for the files of the views (see
+     * @c vpz::Project::setInstance).
+     */
+    std::unique_ptr<value::Map> restart(const vpz::Conditions& conditions,
+                                        const vpz::Outputs& outputs,
+                                        long instance,
+                                        Error* error);
+
+    /**
+     * Serve the simulations of the parent process in
+     * @c SIMULATION_SPAWN_PROCESS mode (the `vle --worker` command): the
+     * jobs are read from the standard input and the results are written
+     * on the standard output, until the end of the input. The output of
+     * the models is redirected to the standard error output.
+     *
+     * @return @c EXIT_SUCCESS at the end of the input.
+     */
+    static int serve(utils::ContextPtr context);
+
 private:
     class Pimpl;
     std::unique_ptr<Pimpl> mPimpl;
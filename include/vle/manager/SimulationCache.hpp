@@ -0,0 +1,154 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_SIMULATIONCACHE_HPP
+#define VLE_MANAGER_SIMULATIONCACHE_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include <memory>
+#include <string>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @c manager::SimulationCache stores the results of simulations to return
+ * them without simulation when the same experiment is run again (see
+ * @c Simulation::setCache and the @c simulation_cache option of
+ * @c Manager).
+ *
+ * A simulation is identified by a key, the canonical binary form of its
+ * project structure (models, dynamics, views), of the versions of the
+ * packages of its dynamics and outputs, and of the values of its
+ * conditions, seeds included. A 64 bits hash of the key indexes the
+ * results and names the files, the full key is stored with each result
+ * and compared on lookup. A stochastic experiment without a fixed seed
+ * must not use a cache (see @c enable).
+ *
+ * Only the returned @c value::Map is stored: the output plug-ins that
+ * write files are not run for a cached result.
+ *
+ * The results are kept in memory with a least recently used eviction and
+ * optionally written in a directory shared by several runs or processes.
+ * The cache can be shared by several threads.
+ */
+class VLE_API SimulationCache
+{
+public:
+    /**
+     * @param capacity The maximum number of results in memory, 0 for no
+     * limit.
+     * @param max_bytes The maximum size of the results in memory (encoded
+     * in the binary form of @c value::BinaryWriter), 0 for no limit.
+     * @param directory If not empty, the results are also written in this
+     * directory (one file per result, never evicted) and read back when
+     * they are not in memory.
+     */
+    SimulationCache(std::size_t capacity,
+                    std::size_t max_bytes = 0,
+                    std::string directory = std::string());
+
+    SimulationCache(const SimulationCache&) = delete;
+    SimulationCache& operator=(const SimulationCache&) = delete;
+
+    ~SimulationCache();
+
+    /**
+     * Compute the part of the key of the simulations of @c vpz which does
+     * not depend on the conditions: the structure of the project and the
+     * versions (the @c Description.txt file and the path, size and
+     * modification time of the plug-in libraries) of the binary packages
+     * of its dynamics and outputs.
+     *
+     * @throw utils::ArgError if a value can not be encoded.
+     */
+    static std::string structureKey(utils::ContextPtr context,
+                                    const vpz::Vpz& vpz);
+
+    /**
+     * Compute the key of a simulation from the key of its structure and
+     * its conditions.
+     *
+     * @throw utils::ArgError if a value can not be encoded.
+     */
+    static std::string key(const std::string& structure,
+                           const vpz::Conditions& conditions);
+
+    /**
+     * Enable or disable the cache. A disabled cache neither returns nor
+     * stores results.
+     */
+    void enable(bool enabled) noexcept;
+
+    bool isEnabled() const noexcept;
+
+    /**
+     * Get a copy of the result of a simulation.
+     *
+     * @return false if the result is not in the cache or if the cache is
+     * disabled.
+     */
+    bool get(const std::string& key, std::unique_ptr<value::Map>* result);
+
+    /**
+     * Store the result of a simulation, evicting the least recently used
+     * results to respect the limits.
+     */
+    void put(const std::string& key, const value::Map& result);
+
+    /**
+     * Remove the results in memory. The files of the directory are kept.
+     */
+    void clear();
+
+    /**
+     * @return The number of results in memory.
+     */
+    std::size_t size() const;
+
+    /**
+     * @return The number of successful calls to @c get.
+     */
+    std::size_t hits() const;
+
+    /**
+     * @return The number of unsuccessful calls to @c get on an enabled
+     * cache.
+     */
+    std::size_t misses() const;
+
+private:
+    class Pimpl;
+    std::unique_ptr<Pimpl> mPimpl;
+};
+}
+} // namespace vle manager
+
+#endif
@@ -81,7 +81,16 @@ enum SimulationOptions
     SIMULATION_NONE = 0,               /**< Default option. */
     SIMULATION_SPAWN_PROCESS = 1 << 0, /**< Launch the simulation in a
                                         * subprocess.  */
-    SIMULATION_NO_RETURN = 1 << 1      /**< The simulation result are empty. */
+    SIMULATION_NO_RETURN = 1 << 1,     /**< The simulation result are empty. */
+    SIMULATION_WARM_START = 1 << 2,    /**< Keep the loaded models to run
+                                        * them again with other
+                                        * conditions. */
+    SIMULATION_STATISTICS = 1 << 3,    /**< Compute the statistics of the
+                                        * kernel (see
+                                        * Simulation::statistics). */
+    SIMULATION_PROFILE = 1 << 4        /**< Profile the models and the
+                                        * bags (see
+                                        * Simulation::profile). */
 };
 
 inline SimulationOptions
@@ -22,6 +22,7 @@
 #include <vle/DllDefines.hpp>
 
 #include <ciso646>
+#include <ctime>
 
 namespace vle {
 namespace utils {
@@ -123,6 +124,13 @@ public:
 
     size_t file_size() const;
 
+    /**
+     * @return The time of the last modification of the file, in seconds
+     * since the epoch.
+     * @throw FileError if the file can not be read.
+     */
+    std::time_t last_write_time() const;
+
     bool is_directory() const;
 
     bool is_file() const;
@@ -320,11 +328,11 @@ public:
     Path operator*() const;
     DirectoryEntry* operator->() const;
 
-    friend void swap(DirectoryIterator& lhs, DirectoryIterator& rhs);
-    friend bool operator==(const DirectoryIterator& lhs,
-                           const DirectoryIterator& rhs);
-    friend bool operator!=(const DirectoryIterator& lhs,
-                           const DirectoryIterator& rhs);
+    friend VLE_API void swap(DirectoryIterator& lhs, DirectoryIterator& rhs);
+    friend VLE_API bool operator==(const DirectoryIterator& lhs,
+                                   const DirectoryIterator& rhs);
+    friend VLE_API bool operator!=(const DirectoryIterator& lhs,
+                                   const DirectoryIterator& rhs);
 };
 }
 } // namespace vle utils
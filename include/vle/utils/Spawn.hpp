@@ -28,6 +28,7 @@
 #define VLE_UTILS_DETAILS_SPAWN_HPP
 
 #include <chrono>
+#include <functional>
 #include <string>
 #include <vector>
 #include <vle/DllDefines.hpp>
@@ -51,14 +52,11 @@ namespace utils {
  * args.push_back("4");
  *
  * if (spawn.start("/bin/ping", "/home/homer", args; envp)) {
- *     std::string output, error;
+ *     spawn.waitFor(std::chrono::milliseconds::zero(),
+ *                   [](const std::string& output, const std::string& error) {
+ *                       std::cout << output << error;
+ *                   });
  *
- *     while (not spawn.isfinish()) {
- *         std::string output, error;
- *         spawn.get(&output, &error);
- *
- *         std::cout << output << " " << error << "\n";
- *     }
  *     std::string msg;
  *     bool success;
  *     if (spawn.status(&msg, &success))
@@ -74,6 +72,13 @@ class VLE_API Spawn
 public:
     static const unsigned long int default_buffer_size;
 
+    /**
+     * The function called by @c waitFor() with the data read from the
+     * standard output or from the standard error output of the process.
+     */
+    using OutputFunction =
+      std::function<void(const std::string& output, const std::string& error)>;
+
     /**
      * Default constructor.
      *
@@ -125,6 +130,30 @@ public:
      */
     bool wait();
 
+    /**
+     * Wait the end of the process or the expiration of the timeout without
+     * busy loop: the pipes and the end of the process are watched with
+     * poll(2) (and a pidfd on Linux). The @e output function is called as
+     * soon as data arrive on the pipes.
+     *
+     * @code
+     * if (not spawn.waitFor(timeout, nullptr)) {
+     *     spawn.kill();
+     *     spawn.wait();
+     * }
+     * @endcode
+     *
+     * @param timeout The maximum duration of the wait, zero to wait
+     * without limit.
+     * @param output The function called with the outputs of the process
+     * or nullptr to ignore them.
+     *
+     * @return true if the process is finished (@c status() can be used),
+     * false if the timeout expired.
+     */
+    bool waitFor(std::chrono::milliseconds timeout,
+                 const OutputFunction& output);
+
     /**
      * Try to kill the sub-process. If the process is not running, do
      * nothing. Do not forget to use the \c wait() function to get the
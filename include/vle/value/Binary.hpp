@@ -0,0 +1,154 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_VALUE_BINARY_HPP
+#define VLE_VALUE_BINARY_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <vle/value/Value.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace vle {
+namespace value {
+
+/**
+ * @brief A compact binary encoder for value::Value. Integers are stored in
+ * little endian and doubles as their IEEE-754 bit pattern so the output is
+ * independent of the host. The encoder appends into a caller provided
+ * buffer to allow the concatenation of several values.
+ *
+ * @code
+ * std::string buffer;
+ * value::BinaryWriter out(buffer);
+ * out.writeValue(map);
+ * @endcode
+ */
+class VLE_API BinaryWriter
+{
+public:
+    BinaryWriter(std::string& buffer)
+      : m_buffer(buffer)
+    {}
+
+    void writeUint8(uint8_t value);
+
+    void writeUint32(uint32_t value);
+
+    void writeUint64(uint64_t value);
+
+    void writeInt32(int32_t value)
+    {
+        writeUint32(static_cast<uint32_t>(value));
+    }
+
+    void writeDouble(double value);
+
+    void writeString(const std::string& value);
+
+    /**
+     * @brief Write a value, @c nullptr is allowed and is read back as an
+     * empty pointer.
+     * @param value The value to write.
+     * @throw utils::ArgError if the value (or a sub value) is a
+     * value::User.
+     */
+    void writeValue(const Value* value);
+
+    void writeValue(const Value& value)
+    {
+        writeValue(&value);
+    }
+
+    std::string& buffer()
+    {
+        return m_buffer;
+    }
+
+private:
+    std::string& m_buffer;
+};
+
+/**
+ * @brief Decoder of the BinaryWriter format. The reader does not copy the
+ * buffer, the memory between @c first and @c last must stay valid while
+ * reading.
+ */
+class VLE_API BinaryReader
+{
+public:
+    BinaryReader(const char* first, const char* last)
+      : m_first(first)
+      , m_last(last)
+    {}
+
+    /**
+     * @throw utils::ArgError if the buffer is too short.
+     */
+    uint8_t readUint8();
+
+    uint32_t readUint32();
+
+    uint64_t readUint64();
+
+    int32_t readInt32()
+    {
+        return static_cast<int32_t>(readUint32());
+    }
+
+    double readDouble();
+
+    std::string readString();
+
+    /**
+     * @brief Read a value written by @c BinaryWriter::writeValue.
+     * @return The value or an empty pointer.
+     * @throw utils::ArgError if the buffer is too short or corrupted.
+     */
+    std::unique_ptr<Value> readValue();
+
+    const char* position() const
+    {
+        return m_first;
+    }
+
+    bool empty() const
+    {
+        return m_first == m_last;
+    }
+
+private:
+    const char* require(std::size_t size);
+
+    const char* m_first;
+    const char* m_last;
+};
+}
+} // namespace vle value
+
+#endif
@@ -56,7 +56,7 @@ public:
 
     /**
      * @brief Build a new Class by copying the parameter. The vpz::Model
-     * hierarchy is clone in this function.
+     * hierarchy is shared until one of the two classes modifies it.
      * @param cls The class to copy.
      */
     Class(const Class& cls);
@@ -96,6 +96,11 @@ public:
 
     void setGraph(std::unique_ptr<BaseModel> graph);
 
+    /**
+     * @brief Release the hierarchy of Model. If the hierarchy is shared
+     * with a copy of this object, a clone is returned.
+     * @return The hierarchy of Model or nullptr.
+     */
     std::unique_ptr<BaseModel> graph();
 
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -113,14 +118,16 @@ public:
     void setNode(BaseModel* mdl);
 
     /**
-     * @brief Get a reference to the Model hierarchy.
+     * @brief Get a reference to the Model hierarchy. If the hierarchy is
+     * shared with a copy of this object, it is cloned first.
      * @return A reference to the Model, be carreful, you can damage
      * graph::Vpz instance.
      */
     BaseModel* node();
 
     /**
-     * @brief Get a reference to the Model hierarchy.
+     * @brief Get a reference to the Model hierarchy. The hierarchy may be
+     * shared with copies of this object and must not be modified.
      * @return A reference to the Model, be carreful, you can damage
      * graph::Vpz instance.
      */
@@ -201,8 +208,14 @@ public:
     void getAtomicModelList(std::vector<AtomicModel*>& list) const;
 
 private:
+    /* Owner of the hierarchy of Model, shared between copies. */
+    struct Graph;
+
+    /* Clone the hierarchy of Model if it is shared. */
+    void detach();
+
     std::string m_name;
-    std::unique_ptr<BaseModel> m_graph;
+    std::shared_ptr<Graph> m_graph;
     BaseModel* m_node;
 };
 }
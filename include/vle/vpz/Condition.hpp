@@ -27,6 +27,9 @@
 #ifndef VLE_VPZ_CONDITION_HPP
 #define VLE_VPZ_CONDITION_HPP
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -43,9 +46,27 @@ namespace vpz {
 using ConditionValues =
   std::unordered_map<std::string, std::shared_ptr<value::Value>>;
 
+/**
+ * @brief Define the XML representation of values not yet parsed,
+ * (portname, xml). XML buffers are shared between copies of a Condition.
+ */
+using ConditionLazyValues =
+  std::unordered_map<std::string, std::shared_ptr<const std::string>>;
+
 /**
  * @brief A condition define a couple model name, port name and a Value.
  * This class allow loading and writing a condition.
+ *
+ * The Sax parser stores the XML of the values instead of building them,
+ * values are parsed on the first access to the port (@c valueOfPort,
+ * @c conditionvalues, iterators).
+ *
+ * Copies of a Condition share their values until one of them is modified
+ * (copy-on-write): the first non-constant access (@c setValueToPort,
+ * non-constant @c valueOfPort, @c conditionvalues or iterators) clones the
+ * values of this condition only. Parsing of the lazy values is protected
+ * by a mutex, constant functions of copies can be used from several
+ * threads.
  */
 class VLE_API Condition : public Base
 {
@@ -62,13 +83,15 @@ public:
     Condition(const std::string& name);
 
     /**
-     * @brief Copy constructor. All values are cloned.
+     * @brief Copy constructor. Values are shared with @c cnd until one of
+     * the two conditions is modified.
      * @param cnd The Condition to copy.
      */
     Condition(const Condition& cnd);
 
     /**
-     * @brief Assignment operator. All values are cloned.
+     * @brief Assignment operator. Values are shared with @c cnd until one
+     * of the two conditions is modified.
      */
     Condition& operator=(const Condition& cnd);
 
@@ -157,6 +180,31 @@ public:
     const std::shared_ptr<value::Value>& valueOfPort(
       const std::string& portname) const;
 
+    /**
+     * @brief Return a reference to the value::Value of the specified port
+     * to allow its modification. Values shared with a copy of this
+     * condition are cloned first.
+     * @param portname the name of the port.
+     * @return A reference to a value::Value.
+     * @throw utils::ArgError if portname not exist.
+     */
+    std::shared_ptr<value::Value>& valueOfPort(const std::string& portname);
+
+    /**
+     * @brief Assign to the port the XML representation of its value. The
+     * value is parsed on the first access. This function is principaly
+     * used in Sax parser.
+     * @param portname The name of the port.
+     * @param xml The XML representation of a value::Value.
+     */
+    void setLazyValueToPort(const std::string& portname,
+                            std::shared_ptr<const std::string> xml);
+
+    /**
+     * @brief Get the number of ports with a value not yet parsed.
+     */
+    size_type lazyPortsSize() const;
+
     /**
      * @brief Return a reference to the value::Set of the latest added port.
      * This function is principaly used in Sax parser.
@@ -177,7 +225,9 @@ public:
      */
     inline const ConditionValues& conditionvalues() const
     {
-        return m_list;
+        parseLazyValues();
+
+        return m_values->list;
     }
 
     /**
@@ -186,7 +236,9 @@ public:
      */
     inline ConditionValues& conditionvalues()
     {
-        return m_list;
+        parseLazyValues();
+
+        return values().list;
     }
 
     /**
@@ -195,7 +247,7 @@ public:
      */
     iterator begin()
     {
-        return m_list.begin();
+        return conditionvalues().begin();
     }
 
     /**
@@ -204,7 +256,7 @@ public:
      */
     iterator end()
     {
-        return m_list.end();
+        return conditionvalues().end();
     }
 
     /**
@@ -214,7 +266,7 @@ public:
      */
     const_iterator begin() const
     {
-        return m_list.begin();
+        return conditionvalues().begin();
     }
 
     /**
@@ -223,7 +275,7 @@ public:
      */
     const_iterator end() const
     {
-        return m_list.end();
+        return conditionvalues().end();
     }
 
     /**
@@ -297,7 +349,27 @@ public:
 private:
     Condition() = delete;
 
-    ConditionValues m_list;  /* list of port, values. */
+    /* Values of the condition, shared between copies. The lazy values are
+     * parsed in place under the mutex since the result does not depend on
+     * the owner. */
+    struct Values
+    {
+        ConditionValues list;     /* list of port, values. */
+        ConditionLazyValues lazy; /* list of port, unparsed values. */
+        std::atomic<bool> has_lazy{ false };
+        std::mutex mutex;
+    };
+
+    /* Parse and move all the lazy values into the list. */
+    void parseLazyValues() const;
+
+    /* Parse and move the lazy value of the port into the list. */
+    void parseLazyValue(const std::string& portname) const;
+
+    /* Get the values to modify them, clone them if they are shared. */
+    Values& values();
+
+    std::shared_ptr<Values> m_values;
     std::string m_name;      /* name of the condition. */
     std::string m_last_port; /* latest added port. */
     bool m_ispermanent;
@@ -53,7 +53,9 @@ public:
     Model();
 
     /**
-     * @brief Copy constructor. The hierarchy of Model is cloned.
+     * @brief Copy constructor. The hierarchy of Model is shared until one
+     * of the two objects modifies it (@c node, @c graph, @c update* and
+     * @c purge* functions).
      * @param mdl The model to copy.
      */
     Model(const Model& mdl);
@@ -100,6 +102,11 @@ public:
 
     void setGraph(std::unique_ptr<BaseModel> graph);
 
+    /**
+     * @brief Release the hierarchy of Model. If the hierarchy is shared
+     * with a copy of this object, a clone is returned.
+     * @return The hierarchy of Model or nullptr.
+     */
     std::unique_ptr<BaseModel> graph();
 
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -117,14 +124,16 @@ public:
     void setNode(BaseModel* mdl);
 
     /**
-     * @brief Get a reference to the Model hierarchy.
+     * @brief Get a reference to the Model hierarchy. If the hierarchy is
+     * shared with a copy of this object, it is cloned first.
      * @return A reference to the Model, be carreful, you can damage
      * graph::Vpz instance.
      */
     BaseModel* node();
 
     /**
-     * @brief Get a reference to the Model hierarchy.
+     * @brief Get a reference to the Model hierarchy. The hierarchy may be
+     * shared with copies of this object and must not be modified.
      * @return A reference to the Model, be carreful, you can damage
      * graph::Vpz instance.
      */
@@ -183,7 +192,13 @@ public:
     BaseModel* findModelFromPath(const std::string& pathname) const;
 
 private:
-    std::unique_ptr<BaseModel> m_graph;
+    /* Owner of the hierarchy of Model, shared between copies. */
+    struct Graph;
+
+    /* Clone the hierarchy of Model if it is shared. */
+    void detach();
+
+    std::shared_ptr<Graph> m_graph;
     BaseModel* m_node{ nullptr };
 };
 
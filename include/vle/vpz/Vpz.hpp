@@ -27,6 +27,7 @@
 #ifndef VLE_VPZ_VPZ_HPP
 #define VLE_VPZ_VPZ_HPP
 
+#include <cstdint>
 #include <set>
 #include <string>
 #include <vle/DllDefines.hpp>
@@ -83,21 +84,47 @@ public:
     }
 
     /**
-     * @brief Open a VPZ file project.
+     * @brief Open a VPZ file project. The file can be a XML file, a XML
+     * file compressed with gzip or zstd (decompressed while parsing) or a
+     * compiled file produced by @c writeCompiled.
      * @param filename file to read.
      * @throw utils::ArgError if an error occured during loading.
      */
     void parseFile(const std::string& filename);
 
     /**
-     * @brief Open a VPZ from a buffer.
+     * @brief Open a VPZ file project using the compiled cache stored next
+     * to the XML file (see @c compiledFilename). If the cache is missing or
+     * does not match the content of the XML file, the XML file is parsed
+     * and the cache is (re)written. Failures to write the cache are
+     * ignored. The applications use the cache only if it is enabled (see
+     * @c isCompiledCacheEnabled).
+     * @param filename file to read.
+     * @throw utils::ArgError if an error occured during loading.
+     */
+    void parseFileCached(const std::string& filename);
+
+    /**
+     * @brief Write the compiled binary representation of the project.
+     * The file is written into a temporary file and renamed.
+     * @param filename file to write.
+     * @throw utils::FileError if the file can not be written.
+     */
+    void writeCompiled(const std::string& filename) const;
+
+    /**
+     * @brief Open a VPZ from a buffer. The buffer can be compressed with
+     * gzip or zstd.
      * @param buffer the buffer to parse XML.
      * @throw utils::ArgError if an error occured during loading.
      */
     void parseMemory(const std::string& buffer);
 
     /**
-     * @brief Write file into the current VPZ filename open.
+     * @brief Write file into the current VPZ filename open. If the filename
+     * ends with @c .gz or @c .zst, the XML is compressed while written.
+     * @throw utils::FileError if the file can not be written or if the
+     * compression is not available.
      */
     void write();
 
@@ -152,11 +179,30 @@ public:
 
     /**
      * @brief Add the vpz extension to filename if does not exist, If
-     * correct filename is passed, no modification is apply.
+     * correct filename is passed, no modification is apply. The extension
+     * is added before a compression extension: @c foo.gz becomes
+     * @c foo.vpz.gz.
      * @param filename string to change if no extension exist.
      */
     static void fixExtension(std::string& filename);
 
+    /**
+     * @brief Get the name of the compiled cache of a VPZ file:
+     * @c file.vpz becomes @c file.vpzc.
+     * @param filename the VPZ filename.
+     * @return the compiled filename.
+     */
+    static std::string compiledFilename(const std::string& filename);
+
+    /**
+     * @brief Check if the applications (vle, cvle) load the VPZ files with
+     * @c parseFileCached: the compiled cache is written next to the VPZ
+     * file, so it is opt-in, enabled by the @c VLE_VPZ_CACHE environment
+     * variable (any value except an empty string or @c 0).
+     * @return true if the compiled cache is enabled.
+     */
+    static bool isCompiledCacheEnabled();
+
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
      *
      * Get/Set functions
@@ -200,6 +246,10 @@ public:
     }
 
 private:
+    void writeCompiledFile(const std::string& filename, uint64_t hash) const;
+
+    void setDefaultSimulationEngine();
+
     bool m_isGzip{ true };
     std::string m_filename;
     vpz::Project m_project;
@@ -37,12 +37,15 @@
 #include "devs/InternalEvent.hpp"
 #include "devs/Simulator.hpp"
 #include "devs/Thread.hpp"
+#include "devs/TraceWriter.hpp"
 #include "utils/ContextPrivate.hpp"
 #include "utils/i18n.hpp"
 
 #include <boost/bind.hpp>
 
+#include <chrono>
 #include <functional>
+#include <iterator>
 #include <memory>
 
 using std::map;
@@ -70,6 +73,89 @@ depth(const std::unique_ptr<vle::devs::Dynamics>& mdl) noexcept
 
     return ret;
 }
+
+/** Accumulate the wall clock time of the successive phases of a bag into
+ * the fields of a @e vle::devs::Statistics and write them into the trace.
+ * Nothing is measured if the statistics and the trace are disabled.
+ */
+class phase_timer
+{
+public:
+    using clock = vle::devs::TraceWriter::clock;
+
+    phase_timer(bool statistics, vle::devs::TraceWriter* trace) noexcept
+      : m_trace(trace)
+      , m_statistics(statistics)
+    {
+        if (m_statistics or m_trace)
+            m_start = m_last = clock::now();
+    }
+
+    void lap(double& accumulator, const char* name)
+    {
+        if (not m_statistics and not m_trace)
+            return;
+
+        auto now = clock::now();
+        if (m_statistics)
+            accumulator +=
+              std::chrono::duration<double>(now - m_last).count();
+
+        if (m_trace)
+            m_trace->phase(name, m_last, now);
+
+        m_last = now;
+    }
+
+    clock::time_point start() const noexcept
+    {
+        return m_start;
+    }
+
+    clock::time_point last() const noexcept
+    {
+        return m_last;
+    }
+
+private:
+    clock::time_point m_start;
+    clock::time_point m_last;
+    vle::devs::TraceWriter* m_trace;
+    bool m_statistics;
+};
+
+/** Count an event of the output port @e port of @e source and the events
+ * received by its targets into the profiles of the simulators.
+ */
+void
+profile_events(const vle::devs::Simulator* source,
+               const std::string& port,
+               std::pair<vle::devs::Simulator::iterator,
+                         vle::devs::Simulator::iterator> targets)
+{
+    if (source->profile())
+        ++source->profile()->output_events[port];
+
+    for (auto it = targets.first; it != targets.second; ++it)
+        if (it->first->profile())
+            ++it->first->profile()->input_events[it->second];
+}
+
+void
+count_transitions(const std::vector<vle::devs::Simulator*>& simulators,
+                  vle::devs::Statistics& statistics) noexcept
+{
+    for (const auto* elem : simulators) {
+        if (elem->haveInternalEvent()) {
+            if (not elem->haveExternalEvents())
+                ++statistics.internal_transitions;
+            else
+                ++statistics.confluent_transitions;
+        } else {
+            ++statistics.external_transitions;
+        }
+    }
+}
 }
 
 namespace vle {
@@ -84,6 +170,8 @@ Coordinator::Coordinator(utils::ContextPtr context,
   , m_simulators_thread_pool(m_context)
   , m_modelFactory(context, m_eventViewList, dyn, cls, experiment)
   , m_isStarted(false)
+  , m_statistics_enabled(false)
+  , m_profile_enabled(false)
 {}
 
 void
@@ -96,11 +184,119 @@ Coordinator::init(const vpz::Model& mdls,
     m_durationTime = duration;
     buildViews(instance);
     addModels(mdls);
+
+    /* Flatten the hierarchy: each simulator gets the list of the atomic
+     * models connected to its output ports. Executive models update these
+     * lists when they change the structure. */
+    for (auto& elem : m_simulators)
+        elem->updateSimulatorTargets();
+
     m_isStarted = true;
 
     m_eventTable.init(current);
 }
 
+bool
+Coordinator::isRestartable() const
+{
+    if (not m_isStarted or not m_delete_model.empty())
+        return false;
+
+    for (const auto& elem : m_simulators)
+        if (elem->dynamics()->isExecutive())
+            return false;
+
+    return true;
+}
+
+void
+Coordinator::restart(const vpz::Conditions& conditions,
+                     Time current,
+                     Time duration,
+                     long instance)
+{
+    if (not isRestartable())
+        throw utils::InternalError(
+          _("Coordinator: can not restart a simulation with executives"));
+
+    m_currentTime = current;
+    m_durationTime = duration;
+    m_eventTable.clear();
+    m_timed_observation_scheduler.clear();
+    m_modelFactory.setConditions(conditions);
+    m_statistics = Statistics();
+    m_profile = Profile();
+
+    for (auto& elem : m_simulators)
+        elem->reset();
+
+    buildViews(instance);
+
+    for (auto& elem : m_simulators)
+        m_modelFactory.resetModel(*this, elem.get());
+
+    m_eventTable.init(current);
+}
+
+void
+Coordinator::setOutputLocations(const vpz::Outputs& outputs)
+{
+    auto& current = m_modelFactory.outputs();
+
+    for (const auto& elem : outputs.outputlist())
+        if (current.exist(elem.first))
+            current.get(elem.first).setStreamLocation(
+              elem.second.location());
+}
+
+void
+Coordinator::enableStatistics(bool enable)
+{
+    m_statistics_enabled = enable;
+    m_statistics = Statistics();
+}
+
+void
+Coordinator::enableProfile(bool enable)
+{
+    m_profile_enabled = enable;
+    m_profile = Profile();
+
+    for (auto& elem : m_simulators)
+        elem->enableProfile(enable);
+}
+
+void
+Coordinator::setTrace(const std::string& filename)
+{
+    m_trace.reset();
+    m_simulators_thread_pool.enableTrace(false);
+
+    if (filename.empty())
+        return;
+
+    m_trace = std::make_unique<TraceWriter>(filename);
+    for (std::size_t i = 1, e = m_simulators_thread_pool.workers(); i <= e;
+         ++i)
+        m_trace->thread(static_cast<long>(i),
+                        utils::format("worker %zu", i).c_str());
+
+    m_simulators_thread_pool.enableTrace(true);
+}
+
+Profile
+Coordinator::profile() const
+{
+    Profile ret = m_profile;
+
+    for (const auto& elem : m_simulators)
+        if (elem->profile())
+            ret.models[elem->getStructure()->getCompleteName()].merge(
+              *elem->profile());
+
+    return ret;
+}
+
 void
 Coordinator::run()
 {
@@ -120,20 +316,41 @@ Coordinator::run()
     const std::size_t nb_dynamics = bag.dynamics.size();
     const std::size_t nb_executive = bag.executives.size();
 
+    phase_timer timer(m_statistics_enabled, m_trace.get());
+    if (m_statistics_enabled) {
+        ++m_statistics.bags;
+        m_statistics.outputs += nb_dynamics + nb_executive;
+    }
+
     if (nb_dynamics > 0) {
         for (std::size_t i = 0; i != nb_dynamics; ++i)
             bag.dynamics[i]->output(m_currentTime);
 
+        timer.lap(m_statistics.output_time, "output");
         dispatchExternalEvent(bag.dynamics, nb_dynamics);
+        timer.lap(m_statistics.routing_time, "routing");
     }
 
     if (nb_executive > 0) {
         for (std::size_t i = 0; i != nb_executive; ++i)
             bag.executives[i]->output(m_currentTime);
 
+        timer.lap(m_statistics.output_time, "output");
         dispatchExternalEvent(bag.executives, nb_executive);
+        timer.lap(m_statistics.routing_time, "routing");
+    }
+
+    if (m_statistics_enabled) {
+        count_transitions(bag.dynamics, m_statistics);
+        count_transitions(bag.executives, m_statistics);
     }
 
+    const std::size_t bag_size = bag.dynamics.size() + bag.executives.size();
+    const Time bag_time = m_currentTime;
+
+    if (m_profile_enabled)
+        m_profile.addBag(bag_size);
+
     //
     // First we sort executives models according to the depth of the executive
     // model into the structure of the models.
@@ -154,6 +371,8 @@ Coordinator::run()
     //
     if (m_simulators_thread_pool.parallelize()) {
         m_simulators_thread_pool.for_each(bag.dynamics, m_currentTime);
+        if (m_trace)
+            m_simulators_thread_pool.trace(*m_trace);
     } else {
         for (auto& elem : bag.dynamics) {
             if (elem->haveInternalEvent()) {
@@ -190,12 +409,17 @@ Coordinator::run()
             m_eventTable.addInternal(elem, tn);
     }
 
+    timer.lap(m_statistics.transition_time, "transitions");
+
     //
     // Finally, we go through simulators and executive to get all observation
     // and dispatch to output plug-in.
     //
     for (auto& elem : bag.dynamics) {
         auto& observations = elem->getObservations();
+        if (m_statistics_enabled)
+            m_statistics.observations += observations.size();
+
         for (auto& obs : observations)
             obs.view->run(elem->dynamics().get(),
                           m_currentTime,
@@ -207,6 +431,9 @@ Coordinator::run()
 
     for (auto& elem : bag.executives) {
         auto& observations = elem->getObservations();
+        if (m_statistics_enabled)
+            m_statistics.observations += observations.size();
+
         for (auto& obs : observations)
             obs.view->run(elem->dynamics().get(),
                           m_currentTime,
@@ -234,6 +461,8 @@ Coordinator::run()
 
             if (not obs.empty()) {
                 m_currentTime = obs.back().mTime;
+                if (m_statistics_enabled)
+                    m_statistics.observations += obs.size();
 
                 for (auto& elem : obs) {
                     elem.run();
@@ -256,6 +485,8 @@ Coordinator::run()
         }
     }
 
+    timer.lap(m_statistics.observation_time, "observations");
+
     //
     // Finally, we destroy model and simulator if one executive delete a model
     //
@@ -264,6 +495,11 @@ Coordinator::run()
 
     m_eventTable.makeNextBag();
     m_currentTime = m_eventTable.getCurrentTime();
+
+    timer.lap(m_statistics.scheduler_time, "scheduler");
+
+    if (m_trace)
+        m_trace->bag(bag_time, bag_size, timer.start(), timer.last());
 }
 
 void
@@ -422,6 +658,8 @@ Coordinator::addModel(vpz::AtomicModel* model)
     assert(model && "Coordinator: nullptr model to add?");
 
     m_simulators.emplace_back(std::make_unique<Simulator>(model));
+    if (m_profile_enabled)
+        m_simulators.back()->enableProfile(true);
 
     return m_simulators.back().get();
 }
@@ -438,6 +676,9 @@ Coordinator::delAtomicModel(vpz::AtomicModel* atom,
 
     Simulator* satom = atom->get_simulator();
 
+    if (satom->profile())
+        m_profile.models[atom->getCompleteName()].merge(*satom->profile());
+
     for (auto& elem : m_eventViewList)
         elem.second.removeObservable(satom->dynamics().get());
 
@@ -475,14 +716,21 @@ Coordinator::dispatchExternalEvent(std::vector<Simulator*>& simulators,
             continue;
 
         auto& eventList = simulators[i]->result();
+        if (m_statistics_enabled)
+            m_statistics.output_events += eventList.size();
+
         for (auto& elem : eventList) {
             auto x = simulators[i]->targets(elem.getPortName());
+            if (m_statistics_enabled)
+                m_statistics.external_events +=
+                  std::distance(x.first, x.second);
 
-            if (x.first != x.second and x.first->second.first) {
-                for (auto jt = x.first; jt != x.second; ++jt)
-                    m_eventTable.addExternal(
-                      jt->second.first, elem.attributes(), jt->second.second);
-            }
+            if (m_profile_enabled)
+                profile_events(simulators[i], elem.getPortName(), x);
+
+            for (auto jt = x.first; jt != x.second; ++jt)
+                m_eventTable.addExternal(
+                  jt->first, elem.attributes(), jt->second);
         }
 
         simulators[i]->clear_result();
@@ -606,6 +854,9 @@ Coordinator::finish()
         }
     }
 
+    m_trace.reset();
+    m_simulators_thread_pool.enableTrace(false);
+
     return result;
 }
 
@@ -28,6 +28,8 @@
 #define VLE_DEVS_COORDINATOR_HPP 1
 
 #include <vle/DllDefines.hpp>
+#include <vle/devs/Profile.hpp>
+#include <vle/devs/Statistics.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/utils/Context.hpp>
 
@@ -79,6 +81,38 @@ public:
               Time duration,
               long instance);
 
+    /**
+     * @brief Test if the Coordinator can be restarted: the structure of
+     * the models is the one of the vpz::Model, no executive can change it.
+     */
+    bool isRestartable() const;
+
+    /**
+     * @brief Initialise again the Coordinator after a simulation, with new
+     * conditions. The structure of the models, the routing tables of the
+     * simulators and the resolved plug-ins are kept. The dynamics are
+     * built again with the new conditions and the output plug-ins are
+     * reopened, so nothing remains from the previous simulation.
+     *
+     * @param conditions the conditions of the new simulation.
+     * @param instance see \e init().
+     *
+     * @throw utils::InternalError if the Coordinator is not restartable.
+     */
+    void restart(const vpz::Conditions& conditions,
+                 Time current,
+                 Time duration,
+                 long instance);
+
+    /**
+     * @brief Assign the locations of the outputs used by the views of the
+     * next \e restart(). The outputs which are not in the loaded
+     * experiment are ignored.
+     *
+     * @param outputs the outputs of a vpz::Vpz with the same structure.
+     */
+    void setOutputLocations(const vpz::Outputs& outputs);
+
     /**
      * @brief Pop the next devs::CompleteEventBagModel from the
      * devs::EventTable and call devs::Simulator function.
@@ -86,6 +120,39 @@ public:
      */
     void run();
 
+    /**
+     * @brief Enable or disable the statistics of the \e run() function.
+     * The statistics are reset, and again by \e restart().
+     */
+    void enableStatistics(bool enable);
+
+    const Statistics& statistics() const
+    {
+        return m_statistics;
+    }
+
+    /**
+     * @brief Enable or disable the profile of the models. The models are
+     * wrapped into a profiler when they are built, call this function
+     * before \e init() or \e restart(). The profile is reset.
+     */
+    void enableProfile(bool enable);
+
+    /**
+     * @brief Build the profile of the simulation: the profiles of the
+     * current models, of the models deleted by executives and the
+     * histogram of the bags.
+     */
+    Profile profile() const;
+
+    /**
+     * @brief Write the timeline of the next bags into the file
+     * \e filename (see \e TraceWriter) until \e finish(). An empty \e filename
+     * disables the trace.
+     * @throw utils::FileError if the file can not be opened.
+     */
+    void setTrace(const std::string& filename);
+
     /**
      * @brief Build a new devs::Simulator from the dynamics library. Attach
      * to this model information of dynamics, condition and observable.
@@ -302,6 +369,16 @@ private:
 
     bool m_isStarted;
 
+    Statistics m_statistics;
+    bool m_statistics_enabled;
+
+    /* The histogram of the bags and the profiles of the deleted models. */
+    Profile m_profile;
+    bool m_profile_enabled;
+
+    /* The timeline of the bags, null if the trace is disabled. */
+    std::unique_ptr<TraceWriter> m_trace;
+
     /**
      * @brief Build, for each vpz::View a StreamWriter and View.
      *
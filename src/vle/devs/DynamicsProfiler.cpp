@@ -0,0 +1,146 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "devs/DynamicsInit.hpp"
+#include "devs/DynamicsProfiler.hpp"
+
+#include <chrono>
+
+#include <cassert>
+
+namespace {
+
+/** Count a call and accumulate its duration into a
+ * @e vle::devs::ProfileCounter when the scope exits, even with an
+ * exception.
+ */
+class profile_scope
+{
+public:
+    explicit profile_scope(vle::devs::ProfileCounter& counter) noexcept
+      : m_counter(counter)
+      , m_start(std::chrono::steady_clock::now())
+    {}
+
+    ~profile_scope() noexcept
+    {
+        auto end = std::chrono::steady_clock::now();
+
+        ++m_counter.calls;
+        m_counter.time +=
+          std::chrono::duration<double>(end - m_start).count();
+    }
+
+private:
+    vle::devs::ProfileCounter& m_counter;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // anonymous namespace
+
+namespace vle {
+namespace devs {
+
+DynamicsProfiler::DynamicsProfiler(const DynamicsInit& init,
+                                   const InitEventList& events,
+                                   ModelProfile& profile)
+  : Dynamics(init, events)
+  , mProfile(profile)
+{}
+
+Time
+DynamicsProfiler::init(Time time)
+{
+    assert(mDynamics && "DynamicsProfiler: missing set(Dynamics)");
+
+    return mDynamics->init(time);
+}
+
+void
+DynamicsProfiler::output(Time time, ExternalEventList& output) const
+{
+    assert(mDynamics && "DynamicsProfiler: missing set(Dynamics)");
+
+    profile_scope scope(mProfile.phases[ModelProfile::OUTPUT]);
+    mDynamics->output(time, output);
+}
+
+Time
+DynamicsProfiler::timeAdvance() const
+{
+    assert(mDynamics && "DynamicsProfiler: missing set(Dynamics)");
+
+    profile_scope scope(mProfile.phases[ModelProfile::TIME_ADVANCE]);
+    return mDynamics->timeAdvance();
+}
+
+void
+DynamicsProfiler::internalTransition(Time time)
+{
+    assert(mDynamics && "DynamicsProfiler: missing set(Dynamics)");
+
+    profile_scope scope(mProfile.phases[ModelProfile::INTERNAL]);
+    mDynamics->internalTransition(time);
+}
+
+void
+DynamicsProfiler::externalTransition(const ExternalEventList& event,
+                                     Time time)
+{
+    assert(mDynamics && "DynamicsProfiler: missing set(Dynamics)");
+
+    profile_scope scope(mProfile.phases[ModelProfile::EXTERNAL]);
+    mDynamics->externalTransition(event, time);
+}
+
+void
+DynamicsProfiler::confluentTransitions(Time time,
+                                       const ExternalEventList& extEventlist)
+{
+    assert(mDynamics && "DynamicsProfiler: missing set(Dynamics)");
+
+    profile_scope scope(mProfile.phases[ModelProfile::CONFLUENT]);
+    mDynamics->confluentTransitions(time, extEventlist);
+}
+
+std::unique_ptr<vle::value::Value>
+DynamicsProfiler::observation(const ObservationEvent& event) const
+{
+    assert(mDynamics && "DynamicsProfiler: missing set(Dynamics)");
+
+    profile_scope scope(mProfile.phases[ModelProfile::OBSERVATION]);
+    return mDynamics->observation(event);
+}
+
+void
+DynamicsProfiler::finish()
+{
+    assert(mDynamics && "DynamicsProfiler: missing set(Dynamics)");
+
+    mDynamics->finish();
+}
+}
+} // namespace vle devs
@@ -0,0 +1,91 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_DEVS_DYNAMICSPROFILER_HPP
+#define VLE_DEVS_DYNAMICSPROFILER_HPP
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/devs/Profile.hpp>
+
+namespace vle {
+namespace devs {
+
+/**
+ * A Dynamics proxy class that counts the calls of the functions of the
+ * wrapped Dynamics and the time spent in these calls. The counters are
+ * those of the \e Simulator: a simulator is processed by only one thread
+ * at a time, the counters need no synchronization.
+ */
+class DynamicsProfiler : public Dynamics
+{
+    std::unique_ptr<Dynamics> mDynamics;
+    ModelProfile& mProfile;
+
+public:
+    DynamicsProfiler(const DynamicsInit& init,
+                     const InitEventList& events,
+                     ModelProfile& profile);
+
+    ~DynamicsProfiler() override = default;
+
+    bool isExecutive() const override
+    {
+        return mDynamics->isExecutive();
+    }
+
+    bool isWrapper() const override
+    {
+        return mDynamics->isWrapper();
+    }
+
+    void set(std::unique_ptr<Dynamics> dyn)
+    {
+        mDynamics = std::move(dyn);
+    }
+
+    Time init(Time time) override;
+
+    void output(Time time, ExternalEventList& output) const override;
+
+    Time timeAdvance() const override;
+
+    void internalTransition(Time time) override;
+
+    void externalTransition(const ExternalEventList& event,
+                            Time time) override;
+
+    void confluentTransitions(Time time,
+                              const ExternalEventList& extEventlist) override;
+
+    std::unique_ptr<vle::value::Value> observation(
+      const ObservationEvent& event) const override;
+
+    void finish() override;
+};
+}
+} // namespace vle devs
+
+#endif
@@ -37,6 +37,7 @@
 #include "devs/DynamicsDbg.hpp"
 #include "devs/DynamicsInit.hpp"
 #include "devs/DynamicsObserver.hpp"
+#include "devs/DynamicsProfiler.hpp"
 #include "devs/ModelFactory.hpp"
 #include "devs/RootCoordinator.hpp"
 #include "devs/Simulator.hpp"
@@ -66,9 +67,58 @@ ModelFactory::createModel(Coordinator& coordinator,
                           const std::string& dynamics,
                           const std::vector<std::string>& conditions,
                           const std::string& observable)
+{
+    initModel(coordinator,
+              experiment_conditions,
+              coordinator.addModel(model),
+              dynamics,
+              conditions,
+              observable);
+}
+
+void
+ModelFactory::resetModel(Coordinator& coordinator, Simulator* sim)
+{
+    vpz::AtomicModel* model = sim->getStructure();
+
+    initModel(coordinator,
+              mExperiment.conditions(),
+              sim,
+              model->dynamics(),
+              model->conditions(),
+              model->observables());
+}
+
+std::shared_ptr<const value::Value>
+ModelFactory::initValue(const std::shared_ptr<value::Value>& value)
+{
+    if (not value)
+        return value;
+
+    auto it = mInitValues.find(value);
+    if (it == mInitValues.end())
+        it = mInitValues.emplace(value, value->clone()).first;
+
+    return it->second;
+}
+
+void
+ModelFactory::setConditions(const vpz::Conditions& conditions)
+{
+    mInitValues.clear();
+    mExperiment.conditions() = conditions;
+}
+
+void
+ModelFactory::initModel(Coordinator& coordinator,
+                        const vpz::Conditions& experiment_conditions,
+                        Simulator* sim,
+                        const std::string& dynamics,
+                        const std::vector<std::string>& conditions,
+                        const std::string& observable)
 {
     const vpz::Dynamic& dyn = mDynamics.get(dynamics);
-    auto sim = coordinator.addModel(model);
+    vpz::AtomicModel* model = sim->getStructure();
 
     InitEventList initValues;
 
@@ -84,7 +134,7 @@ ModelFactory::createModel(Coordinator& coordinator,
                         "name '%s'"),
                       elem.first.c_str());
 
-                initValues.add(elem.first, elem.second);
+                initValues.add(elem.first, initValue(elem.second));
             }
         }
     }
@@ -164,6 +214,30 @@ ModelFactory::createModelFromClass(Coordinator& coordinator,
     return mdl;
 }
 
+//
+// If the simulator is profiled, wrap the user dynamics into a profiler. The
+// profiler is the innermost proxy to measure only the user's functions.
+//
+std::unique_ptr<Dynamics>
+attachProfiler(const DynamicsInit& init,
+               const InitEventList& events,
+               devs::Simulator* atom,
+               const vpz::Dynamic& dyn,
+               std::unique_ptr<Dynamics> dynamics)
+{
+    auto* profile = atom->profile();
+    if (not profile)
+        return dynamics;
+
+    profile->library = dyn.package().empty()
+                         ? dyn.library()
+                         : dyn.package() + '/' + dyn.library();
+
+    auto profiler = std::make_unique<DynamicsProfiler>(init, events, *profile);
+    profiler->set(std::move(dynamics));
+    return std::move(profiler);
+}
+
 template<typename Factory>
 std::unique_ptr<Dynamics>
 buildNewDynamicsWrapper(utils::ContextPtr context,
@@ -175,12 +249,21 @@ buildNewDynamicsWrapper(utils::ContextPtr context,
     try {
         utils::PackageTable pkg_table;
 
-        return std::unique_ptr<Dynamics>(
+        auto dynamics = std::unique_ptr<Dynamics>(
           fct(DynamicsWrapperInit{ dyn.library(),
                                    context,
                                    *atom->getStructure(),
                                    pkg_table.get(dyn.package()) },
               events));
+
+        return attachProfiler(
+          DynamicsInit{ context,
+                        *atom->getStructure(),
+                        pkg_table.get(dyn.package()) },
+          events,
+          atom,
+          dyn,
+          std::move(dynamics));
     } catch (const std::exception& e) {
         throw utils::ModellingError(
           _("Atomic model wrapper `%s:%s' (from dynamics `%s'"
@@ -279,6 +362,8 @@ buildNewDynamics(utils::ContextPtr context,
                            *atom->getStructure(),
                            pkg_table.get(dyn.package()) };
         auto dynamics = std::unique_ptr<Dynamics>(fct(init, events));
+        dynamics =
+          attachProfiler(init, events, atom, dyn, std::move(dynamics));
 
         if (haveEventView(vpzviews, observable)) {
             auto observation = std::make_unique<DynamicsObserver>(
@@ -343,6 +428,8 @@ buildNewExecutive(utils::ContextPtr context,
                            pkg_table.get(dyn.package()) };
 
         auto executive = std::unique_ptr<Dynamics>(fct(executiveinit, events));
+        executive =
+          attachProfiler(init, events, atom, dyn, std::move(executive));
 
         if (haveEventView(vpzviews, observable)) {
             auto observation = std::make_unique<DynamicsObserver>(
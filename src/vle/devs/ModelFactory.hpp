@@ -39,6 +39,9 @@
 
 #include "devs/View.hpp"
 
+#include <memory>
+#include <unordered_map>
+
 namespace vle {
 namespace devs {
 
@@ -231,6 +234,22 @@ public:
       const std::vector<std::string>& inputs,
       const std::vector<std::string>& outputs);
 
+    /**
+     * @brief Replace the devs::Dynamics of an existing devs::Simulator by
+     * a new one built with the current conditions of the experiment. The
+     * simulator must be reset and the views reopened before.
+     * @param coordinator the coordinator of the simulator.
+     * @param sim the simulator of an atomic model of the vpz::Model.
+     */
+    void resetModel(Coordinator& coordinator, Simulator* sim);
+
+    /**
+     * @brief Replace the conditions of the experiment, for example before
+     * a restart. The values of the previous conditions given to the
+     * models are released.
+     */
+    void setConditions(const vpz::Conditions& conditions);
+
 private:
     utils::ContextPtr mContext;
     std::map<std::string, View>& mEventViews;
@@ -240,6 +259,17 @@ private:
     vpz::Experiment mExperiment; /**< A reference to the
                                    vpz::Experiment. */
 
+    /* The values of the conditions are shared between the copies of a
+     * vpz::Vpz, so the models of this simulation get a clone of each
+     * value, shared between the models of the simulation only. */
+    std::unordered_map<std::shared_ptr<value::Value>,
+                       std::shared_ptr<const value::Value>>
+      mInitValues;
+
+    /* Get the clone of a value of the conditions for the models. */
+    std::shared_ptr<const value::Value> initValue(
+      const std::shared_ptr<value::Value>& value);
+
     /**
      * Try to open the plug-in and return the type of opened plugin
      * (MODULE_DYNAMICS, MODULE_DYNAMICS_WRAPPER or MODULE_EXECUTIVE).
@@ -255,6 +285,16 @@ private:
     utils::Context::ModuleType open(const vpz::Dynamic& dyn,
                                     std::string* path);
 
+    /**
+     * @brief Build and initialize the devs::Dynamics of a simulator.
+     */
+    void initModel(Coordinator& coordinator,
+                   const vpz::Conditions& experiment_conditions,
+                   Simulator* sim,
+                   const std::string& dynamics,
+                   const std::vector<std::string>& conditions,
+                   const std::string& observable);
+
     /**
      * @brief Attach to the specified devs::Simulator reference a
      * devs::Dynamics structures load from a new Glib::Module.
@@ -0,0 +1,223 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/devs/Profile.hpp>
+
+#include <iomanip>
+#include <limits>
+
+namespace {
+
+void
+write_string(std::ostream& out, const std::string& str)
+{
+    out << '"';
+
+    for (auto c : str) {
+        switch (c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                    << static_cast<int>(c) << std::dec << std::setfill(' ');
+            else
+                out << c;
+        }
+    }
+
+    out << '"';
+}
+
+void
+write_events(std::ostream& out,
+             const char* name,
+             const std::map<std::string, std::uint64_t>& events)
+{
+    out << "      \"" << name << "\": {";
+
+    bool first = true;
+    for (const auto& elem : events) {
+        out << (first ? " " : ", ");
+        write_string(out, elem.first);
+        out << ": " << elem.second;
+        first = false;
+    }
+
+    out << (events.empty() ? "}" : " }");
+}
+
+void
+write_models(std::ostream& out,
+             const std::map<std::string, vle::devs::ModelProfile>& models,
+             bool with_library)
+{
+    using vle::devs::ModelProfile;
+
+    bool first = true;
+    for (const auto& elem : models) {
+        const auto& mdl = elem.second;
+
+        out << (first ? "\n" : ",\n") << "    ";
+        write_string(out, elem.first);
+        out << ": {\n";
+
+        if (with_library) {
+            out << "      \"library\": ";
+            write_string(out, mdl.library);
+            out << ",\n";
+        } else {
+            out << "      \"models\": " << mdl.models << ",\n";
+        }
+
+        out << "      \"phases\": {";
+        for (int i = 0; i != ModelProfile::PHASE_COUNT; ++i) {
+            out << (i ? ", " : " ") << '"'
+                << ModelProfile::phaseName(static_cast<ModelProfile::Phase>(i))
+                << "\": { \"calls\": " << mdl.phases[i].calls
+                << ", \"time\": " << mdl.phases[i].time << " }";
+        }
+        out << " },\n";
+
+        write_events(out, "output_events", mdl.output_events);
+        out << ",\n";
+        write_events(out, "input_events", mdl.input_events);
+        out << "\n    }";
+
+        first = false;
+    }
+
+    out << (models.empty() ? "}" : "\n  }");
+}
+
+} // anonymous namespace
+
+namespace vle {
+namespace devs {
+
+void
+ModelProfile::merge(const ModelProfile& other)
+{
+    if (library.empty())
+        library = other.library;
+
+    models += other.models;
+
+    for (int i = 0; i != PHASE_COUNT; ++i)
+        phases[i].merge(other.phases[i]);
+
+    for (const auto& elem : other.output_events)
+        output_events[elem.first] += elem.second;
+
+    for (const auto& elem : other.input_events)
+        input_events[elem.first] += elem.second;
+}
+
+const char*
+ModelProfile::phaseName(Phase phase) noexcept
+{
+    static const char* names[] = { "output",     "internal",
+                                   "external",   "confluent",
+                                   "ta",         "observation" };
+
+    return phase < PHASE_COUNT ? names[phase] : "";
+}
+
+void
+Profile::addBag(std::size_t size)
+{
+    std::size_t index = 0;
+    while (size > 1) {
+        size >>= 1;
+        ++index;
+    }
+
+    if (bags.size() <= index)
+        bags.resize(index + 1, 0);
+
+    ++bags[index];
+}
+
+void
+Profile::merge(const Profile& other)
+{
+    for (const auto& elem : other.models)
+        models[elem.first].merge(elem.second);
+
+    if (bags.size() < other.bags.size())
+        bags.resize(other.bags.size(), 0);
+
+    for (std::size_t i = 0, e = other.bags.size(); i != e; ++i)
+        bags[i] += other.bags[i];
+}
+
+std::map<std::string, ModelProfile>
+Profile::libraries() const
+{
+    std::map<std::string, ModelProfile> ret;
+
+    for (const auto& elem : models)
+        ret[elem.second.library].merge(elem.second);
+
+    return ret;
+}
+
+void
+Profile::writeJson(std::ostream& out) const
+{
+    const auto precision = out.precision();
+    out << std::setprecision(std::numeric_limits<double>::digits10);
+
+    out << "{\n  \"bags\": [";
+    for (std::size_t i = 0, e = bags.size(); i != e; ++i) {
+        const std::uint64_t min = i ? UINT64_C(1) << i : 0;
+        const std::uint64_t max = (UINT64_C(1) << (i + 1)) - 1;
+
+        out << (i ? ",\n" : "\n") << "    { \"min\": " << min
+            << ", \"max\": " << max << ", \"count\": " << bags[i] << " }";
+    }
+    out << (bags.empty() ? "],\n" : "\n  ],\n");
+
+    out << "  \"libraries\": {";
+    write_models(out, libraries(), false);
+    out << ",\n  \"models\": {";
+    write_models(out, models, true);
+    out << "\n}\n";
+
+    out << std::setprecision(precision);
+}
+}
+} // namespace vle devs
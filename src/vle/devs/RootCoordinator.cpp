@@ -38,6 +38,9 @@ RootCoordinator::RootCoordinator(utils::ContextPtr context)
   , m_begin(0)
   , m_currentTime(0)
   , m_end(1.0)
+  , m_instance(-1)
+  , m_statistics(false)
+  , m_profile(false)
   , m_coordinator(nullptr)
   , m_root(nullptr)
 {}
@@ -50,16 +53,56 @@ RootCoordinator::load(vpz::Vpz& io)
     m_begin = io.project().experiment().begin();
     m_end = m_begin + io.project().experiment().duration();
     m_currentTime = m_begin;
+    m_instance = io.project().instance();
+
+    /* The hierarchy of models may be shared with copies of the vpz. The
+     * simulators are attached to the atomic models, so take the ownership
+     * of the hierarchy before building them. */
+    auto& model = io.project().model();
+    model.setGraph(model.graph());
 
     m_coordinator = std::make_unique<Coordinator>(m_context,
                                                   io.project().dynamics(),
                                                   io.project().classes(),
                                                   io.project().experiment());
+    m_coordinator->enableStatistics(m_statistics);
+    m_coordinator->enableProfile(m_profile);
+    m_coordinator->setTrace(m_trace);
+
+    m_coordinator->init(model, m_currentTime, m_end, io.project().instance());
+
+    m_root = model.graph();
+}
+
+bool
+RootCoordinator::isRestartable() const
+{
+    return m_coordinator and m_coordinator->isRestartable();
+}
+
+void
+RootCoordinator::restart(const vpz::Conditions& conditions, long instance)
+{
+    assert(m_coordinator && "RootCoordinator: restart before load");
 
-    m_coordinator->init(
-      io.project().model(), m_currentTime, m_end, io.project().instance());
+    const auto& engine = conditions.get(
+      vpz::Experiment::defaultSimulationEngineCondName());
+    m_begin = engine.valueOfPort("begin")->toDouble().value();
+    m_end = m_begin + engine.valueOfPort("duration")->toDouble().value();
+    m_currentTime = m_begin;
+    m_instance = instance;
+    m_coordinator->enableStatistics(m_statistics);
+    m_coordinator->enableProfile(m_profile);
+    m_coordinator->setTrace(m_trace);
+    m_coordinator->restart(conditions, m_currentTime, m_end, m_instance);
+}
+
+void
+RootCoordinator::setOutputLocations(const vpz::Outputs& outputs)
+{
+    assert(m_coordinator && "RootCoordinator: restart before load");
 
-    m_root = io.project().model().graph();
+    m_coordinator->setOutputLocations(outputs);
 }
 
 void
@@ -101,5 +144,41 @@ RootCoordinator::outputs() const
     }
     return {};
 }
+
+void
+RootCoordinator::enableStatistics(bool enable)
+{
+    m_statistics = enable;
+}
+
+Statistics
+RootCoordinator::statistics() const
+{
+    if (m_coordinator) {
+        return m_coordinator->statistics();
+    }
+    return {};
+}
+
+void
+RootCoordinator::enableProfile(bool enable)
+{
+    m_profile = enable;
+}
+
+void
+RootCoordinator::setTrace(std::string filename)
+{
+    m_trace = std::move(filename);
+}
+
+Profile
+RootCoordinator::profile() const
+{
+    if (m_coordinator) {
+        return m_coordinator->profile();
+    }
+    return {};
+}
 }
 } // namespace vle devs
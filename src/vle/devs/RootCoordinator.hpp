@@ -36,6 +36,7 @@
 #include "devs/Coordinator.hpp"
 
 #include <memory>
+#include <string>
 
 namespace vle {
 namespace vpz {
@@ -79,6 +80,29 @@ public:
      */
     void load(vpz::Vpz& vp);
 
+    /**
+     * @brief Test if the loaded models can be simulated again with
+     * \e restart().
+     */
+    bool isRestartable() const;
+
+    /**
+     * @brief Prepare a new simulation of the loaded models with other
+     * conditions, without loading the models again. The conditions must
+     * come from a vpz::Vpz with the same structure, dynamics and views
+     * than the loaded one.
+     * @param conditions the conditions of the new simulation.
+     * @param instance the instance of the files of the views, see
+     * vpz::Project::instance().
+     */
+    void restart(const vpz::Conditions& conditions, long instance);
+
+    /**
+     * @brief Assign the locations of the outputs of the next \e restart(),
+     * see Coordinator::setOutputLocations().
+     */
+    void setOutputLocations(const vpz::Outputs& outputs);
+
     /**
      * @brief Initialise RootCoordinator and his Coordinator: initiale time
      * is define, coordinator init function is call.
@@ -118,6 +142,37 @@ public:
      */
     std::unique_ptr<value::Map> outputs() const;
 
+    /**
+     * @brief Compute the statistics of the kernel in the next \e load()
+     * or \e restart().
+     */
+    void enableStatistics(bool enable);
+
+    /**
+     * @brief Return the statistics of the kernel since the last \e load()
+     * or \e restart(), empty if they are disabled.
+     */
+    Statistics statistics() const;
+
+    /**
+     * @brief Profile the models and the bags in the next \e load() or
+     * \e restart().
+     */
+    void enableProfile(bool enable);
+
+    /**
+     * @brief Return the profile of the simulation since the last \e load()
+     * or \e restart(), empty if it is disabled.
+     */
+    Profile profile() const;
+
+    /**
+     * @brief Write the timeline of the bags of the next \e load() or
+     * \e restart() into the file \e filename, overwritten by each run. An
+     * empty \e filename disables the trace.
+     */
+    void setTrace(std::string filename);
+
     /**
      * @brief Return a reference to the random generator.
      * @return Return a reference to the random generator.
@@ -143,6 +198,13 @@ private:
     /** @brief Store the end date of the simulation. */
     devs::Time m_end;
 
+    /** @brief The instance of the vpz::Project, for the output files. */
+    long m_instance;
+
+    bool m_statistics;
+    bool m_profile;
+    std::string m_trace;
+
     std::unique_ptr<Coordinator> m_coordinator;
     std::unique_ptr<vpz::BaseModel> m_root;
 };
@@ -70,6 +70,18 @@ Scheduler::init(Time time)
     }
 }
 
+void
+Scheduler::clear()
+{
+    m_current_time = negativeInfinity;
+
+    m_current_bag.dynamics.clear();
+    m_current_bag.executives.clear();
+    m_current_bag.unique_simulators.clear();
+
+    m_scheduler.clear();
+}
+
 void
 Scheduler::addInternal(Simulator* simulator, Time time)
 {
@@ -155,6 +155,12 @@ public:
 
     void init(Time time);
 
+    /**
+     * @brief Remove all the events, the simulators must forget their
+     * handle.
+     */
+    void clear();
+
     void addInternal(Simulator* simulator, Time time);
     void addExternal(Simulator* simulator,
                      std::shared_ptr<value::Value> values,
@@ -192,6 +198,11 @@ class TimedObservationScheduler
     std::vector<ViewEvent> m_observation;
 
 public:
+    void clear() noexcept
+    {
+        m_observation.clear();
+    }
+
     void add(View* ptr, Time time, Time timestep)
     {
         assert(not isInfinity(time) && "addObservation: infinity time");
@@ -32,6 +32,8 @@
 #include "devs/Simulator.hpp"
 #include "utils/i18n.hpp"
 
+#include <algorithm>
+
 namespace vle {
 namespace devs {
 
@@ -46,64 +48,133 @@ Simulator::Simulator(vpz::AtomicModel* atomic)
     m_atomicModel->m_simulator = this;
 }
 
+namespace {
+
+struct target_port_less
+{
+    bool operator()(const Simulator::TargetPortList::value_type& lhs,
+                    const std::string& rhs) const
+    {
+        return lhs.first < rhs;
+    }
+};
+
+void
+build_targets(vpz::AtomicModel* atom,
+              const std::string& port,
+              Simulator::TargetSimulatorList& lst)
+{
+    vpz::ModelPortList result;
+    atom->getAtomicModelsTarget(port, result);
+
+    lst.clear();
+    for (auto& elem : result)
+        lst.emplace_back(
+          static_cast<vpz::AtomicModel*>(elem.first)->get_simulator(),
+          elem.second);
+}
+
+} // anonymous namespace
+
+void
+Simulator::updateSimulatorTargets()
+{
+    assert(m_atomicModel);
+
+    mTargetPorts.clear();
+    mTargets.clear();
+
+    TargetSimulatorList lst;
+    for (const auto& elem : m_atomicModel->getOutputPortList()) {
+        build_targets(m_atomicModel, elem.first, lst);
+        mTargetPorts.emplace_back(elem.first, mTargets.size());
+        mTargets.insert(mTargets.end(), lst.begin(), lst.end());
+    }
+}
+
 void
 Simulator::updateSimulatorTargets(const std::string& port)
 {
     assert(m_atomicModel);
 
-    mTargets.erase(port);
+    TargetSimulatorList lst;
+    build_targets(m_atomicModel, port, lst);
+    setTargetPort(port, lst);
+}
 
-    vpz::ModelPortList result;
-    m_atomicModel->getAtomicModelsTarget(port, result);
+void
+Simulator::setTargetPort(const std::string& port, TargetSimulatorList& lst)
+{
+    auto it = std::lower_bound(
+      mTargetPorts.begin(), mTargetPorts.end(), port, target_port_less());
 
-    if (result.begin() == result.end()) {
-        mTargets.emplace(port, TargetSimulator(nullptr, std::string()));
-        return;
+    if (it == mTargetPorts.end() or it->first != port) {
+        size_type offset =
+          it == mTargetPorts.end() ? mTargets.size() : it->second;
+        it = mTargetPorts.emplace(it, port, offset);
     }
 
-    for (auto& elem : result)
-        mTargets.emplace(
-          port,
-          TargetSimulator(
-            static_cast<vpz::AtomicModel*>(elem.first)->get_simulator(),
-            elem.second));
+    auto next = it + 1;
+    size_type first = it->second;
+    size_type last =
+      next == mTargetPorts.end() ? mTargets.size() : next->second;
+
+    mTargets.erase(mTargets.begin() + first, mTargets.begin() + last);
+    mTargets.insert(mTargets.begin() + first, lst.begin(), lst.end());
+
+    for (; next != mTargetPorts.end(); ++next)
+        next->second = next->second - (last - first) + lst.size();
+}
+
+Simulator::TargetPortList::iterator
+Simulator::findTargetPort(const std::string& port)
+{
+    auto it = std::lower_bound(
+      mTargetPorts.begin(), mTargetPorts.end(), port, target_port_less());
+
+    if (it != mTargetPorts.end() and it->first == port)
+        return it;
+
+    return mTargetPorts.end();
 }
 
 std::pair<Simulator::iterator, Simulator::iterator>
 Simulator::targets(const std::string& port)
 {
-    auto x = mTargets.equal_range(port);
+    auto it = findTargetPort(port);
 
-    // If the updateSimulatorTargets function was never call, we update
-    // the simulator targets and try to retrieve the newest simulator
-    // targets.
-    if (x.first == x.second) {
+    // If the targets of this port were never computed (port added by an
+    // executive model), we update the simulator targets.
+    if (it == mTargetPorts.end()) {
         updateSimulatorTargets(port);
-        x = mTargets.equal_range(port);
+        it = findTargetPort(port);
     }
 
-    if (x.first->second.first == nullptr)
-        return { mTargets.end(), mTargets.end() };
+    auto next = it + 1;
+    auto first = mTargets.begin() + it->second;
+    auto last = next == mTargetPorts.end() ? mTargets.end()
+                                           : mTargets.begin() + next->second;
 
-    return x;
+    return { first, last };
 }
 
 void
 Simulator::removeTargetPort(const std::string& port)
 {
-    auto it = mTargets.find(port);
-
-    if (it != mTargets.end()) {
-        mTargets.erase(it);
+    if (findTargetPort(port) != mTargetPorts.end()) {
+        TargetSimulatorList empty;
+        setTargetPort(port, empty);
+        mTargetPorts.erase(findTargetPort(port));
     }
 }
 
 void
 Simulator::addTargetPort(const std::string& port)
 {
-    assert(mTargets.find(port) == mTargets.end());
+    assert(findTargetPort(port) == mTargetPorts.end());
 
-    mTargets.insert(value_type(port, TargetSimulator(nullptr, std::string())));
+    TargetSimulatorList empty;
+    setTargetPort(port, empty);
 }
 
 void
@@ -121,6 +192,33 @@ Simulator::getName() const
     return m_atomicModel->getName();
 }
 
+void
+Simulator::reset() noexcept
+{
+    m_external_events.clear();
+    m_result.clear();
+    m_observations.clear();
+    m_tn = negativeInfinity;
+    m_have_handle = false;
+    m_have_internal = false;
+
+    if (m_profile) {
+        *m_profile = ModelProfile();
+        m_profile->models = 1;
+    }
+}
+
+void
+Simulator::enableProfile(bool enable)
+{
+    if (not enable) {
+        m_profile.reset();
+    } else if (not m_profile) {
+        m_profile = std::make_unique<ModelProfile>();
+        m_profile->models = 1;
+    }
+}
+
 void
 Simulator::finish()
 {
@@ -31,6 +31,7 @@
 #include <vle/devs/Dynamics.hpp>
 #include <vle/devs/ExternalEventList.hpp>
 #include <vle/devs/ObservationEvent.hpp>
+#include <vle/devs/Profile.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/vpz/AtomicModel.hpp>
 
@@ -52,11 +53,12 @@ class Simulator
 {
 public:
     typedef std::pair<Simulator*, std::string> TargetSimulator;
-    typedef std::multimap<std::string, TargetSimulator> TargetSimulatorList;
+    typedef std::vector<TargetSimulator> TargetSimulatorList;
     using const_iterator = TargetSimulatorList::const_iterator;
     using iterator = TargetSimulatorList::iterator;
     using size_type = TargetSimulatorList::size_type;
     using value_type = TargetSimulatorList::value_type;
+    typedef std::vector<std::pair<std::string, size_type>> TargetPortList;
 
     /**
      * @brief Build a new devs::Simulator with an empty devs::Dynamics, a
@@ -105,6 +107,14 @@ public:
 
     /*-*-*-*-*-*-*-*-*-*/
 
+    /**
+     * Browse model's structure to find Simulator connected to all the
+     * output ports. This flattening pass is done for all simulators when
+     * the simulation starts, the coupled models are not browsed anymore
+     * to route events.
+     */
+    void updateSimulatorTargets();
+
     /**
      * Browse model's structure to find Simulator connected to the
      * specified output port.
@@ -124,17 +134,36 @@ public:
     std::pair<iterator, iterator> targets(const std::string& port);
 
     /**
-     * @brief Add an empty target port.
-     * @param port Name of the port.
+     * @brief Remove a target port.
+     * @param port Name of the port to remove.
      */
     void removeTargetPort(const std::string& port);
 
     /**
-     * @brief Remove a target port.
-     * @param port Name of the port to remove.
+     * @brief Add an empty target port.
+     * @param port Name of the port.
      */
     void addTargetPort(const std::string& port);
 
+    /**
+     * @brief Forget the state of the previous simulation: pending events,
+     * observations, the profile and the handle in the scheduler. The
+     * targets are kept.
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Build or remove the profile of the simulator. The profile is
+     * filled by a \e DynamicsProfiler attached to the dynamics when the
+     * model is created (see \e ModelFactory).
+     */
+    void enableProfile(bool enable);
+
+    inline ModelProfile* profile() const noexcept
+    {
+        return m_profile.get();
+    }
+
     /*-*-*-*-*-*-*-*-*-*/
 
     Time init(Time time);
@@ -218,10 +247,25 @@ public:
 private:
     std::unique_ptr<Dynamics> m_dynamics;
     vpz::AtomicModel* m_atomicModel;
+    /* Assign the targets of the port, keep the compressed rows sorted. */
+    void setTargetPort(const std::string& port, TargetSimulatorList& lst);
+
+    /* Get the row of the port or mTargetPorts.end(). */
+    TargetPortList::iterator findTargetPort(const std::string& port);
+
+    /*
+     * Targets of the output ports in compressed sparse row form: the
+     * targets of the port mTargetPorts[i].first are stored in mTargets
+     * from mTargetPorts[i].second to mTargetPorts[i + 1].second (or the
+     * end of mTargets). mTargetPorts is sorted by port name. A port
+     * without entry is not yet computed.
+     */
+    TargetPortList mTargetPorts;
     TargetSimulatorList mTargets;
     ExternalEventList m_external_events;
     ExternalEventList m_result;
     std::vector<Observation> m_observations;
+    std::unique_ptr<ModelProfile> m_profile;
     std::string m_parents;
     Time m_tn;
     HandleT m_handle;
@@ -30,6 +30,7 @@
 #include <vle/utils/Context.hpp>
 
 #include "devs/Simulator.hpp"
+#include "devs/TraceWriter.hpp"
 #include "utils/ContextPrivate.hpp"
 #include "utils/i18n.hpp"
 
@@ -62,7 +63,20 @@ simulator_process(SimulatorT* simulator, Time time) noexcept
 
 class SimulatorProcessParallel
 {
+    /* The work of a thread in a for_each, only filled when the trace is
+     * enabled. Padded to keep the spans of two threads in different cache
+     * lines. */
+    struct span
+    {
+        TraceWriter::clock::time_point start;
+        TraceWriter::clock::time_point end;
+        long blocks = 0;
+        long models = 0;
+        char padding[64];
+    };
+
     std::vector<std::thread> m_workers;
+    std::vector<span> m_spans;
     std::atomic<long int> m_block_id;
     std::atomic<long int> m_block_count;
     std::atomic<bool> m_running_flag;
@@ -70,21 +84,36 @@ class SimulatorProcessParallel
     std::vector<Simulator*>* m_jobs;
     Time m_time;
     long m_block_size;
+    bool m_trace;
 
-    void run()
+    void process(long block, span& sp)
+    {
+        std::size_t begin = block * m_block_size;
+        std::size_t begin_plus_b = begin + m_block_size;
+        std::size_t end = std::min(m_jobs->size(), begin_plus_b);
+
+        if (m_trace and sp.blocks++ == 0)
+            sp.start = TraceWriter::clock::now();
+
+        if (m_trace)
+            sp.models += end - begin;
+
+        for (; begin < end; ++begin)
+            simulator_process((*m_jobs)[begin], m_time);
+
+        if (m_trace)
+            sp.end = TraceWriter::clock::now();
+    }
+
+    void run(std::size_t id)
     {
         while (m_running_flag.load(std::memory_order_relaxed)) {
-            auto block = m_block_id.fetch_sub(1, std::memory_order_relaxed);
+            auto block = m_block_id.fetch_sub(1, std::memory_order_acquire);
 
             if (block >= 0) {
-                std::size_t begin = block * m_block_size;
-                std::size_t begin_plus_b = begin + m_block_size;
-                std::size_t end = std::min(m_jobs->size(), begin_plus_b);
+                process(block, m_spans[id]);
 
-                for (; begin < end; ++begin)
-                    simulator_process((*m_jobs)[begin], m_time);
-
-                m_block_count.fetch_sub(1, std::memory_order_relaxed);
+                m_block_count.fetch_sub(1, std::memory_order_release);
             } else {
                 //
                 // TODO: Maybe we can use a yield instead of this
@@ -99,6 +128,7 @@ class SimulatorProcessParallel
 public:
     SimulatorProcessParallel(utils::ContextPtr context)
       : m_jobs(nullptr)
+      , m_trace(false)
     {
         long block_size = 8;
         {
@@ -126,10 +156,13 @@ public:
         m_block_count.store(-1, std::memory_order_relaxed);
         m_running_flag.store(true, std::memory_order_relaxed);
 
+        m_spans.resize(workers_count + 1);
+
         try {
             m_workers.reserve(workers_count);
             for (long i = 0; i != workers_count; ++i)
-                m_workers.emplace_back(&SimulatorProcessParallel::run, this);
+                m_workers.emplace_back(
+                  &SimulatorProcessParallel::run, this, i + 1);
         } catch (...) {
             m_running_flag.store(false, std::memory_order_relaxed);
             throw;
@@ -150,6 +183,41 @@ public:
         return not m_workers.empty();
     }
 
+    std::size_t workers() const noexcept
+    {
+        return m_workers.size();
+    }
+
+    /**
+     * @brief Record the spans of the threads in the next calls of
+     * @e for_each (see @e trace).
+     */
+    void enableTrace(bool enable) noexcept
+    {
+        m_trace = enable;
+    }
+
+    /**
+     * @brief Write the spans of the threads of the last @e for_each: the
+     * coordinator's thread is the thread 0 of the trace, the workers the
+     * threads 1 to n.
+     */
+    void trace(TraceWriter& trace)
+    {
+        for (std::size_t i = 0, e = m_spans.size(); i != e; ++i) {
+            auto& sp = m_spans[i];
+            if (sp.blocks)
+                trace.worker(static_cast<long>(i),
+                             sp.blocks,
+                             sp.models,
+                             sp.start,
+                             sp.end);
+
+            sp.blocks = 0;
+            sp.models = 0;
+        }
+    }
+
     bool for_each(std::vector<Simulator*>& simulators, Time time) noexcept
     {
         m_jobs = &simulators;
@@ -160,25 +228,20 @@ public:
                             ((simulators.size() % m_block_size) ? 1 : 0));
 
         m_block_count.store(sz, std::memory_order_relaxed);
-        m_block_id.store(sz, std::memory_order_relaxed);
+        m_block_id.store(sz, std::memory_order_release);
 
         for (;;) {
-            auto block = m_block_id.fetch_sub(1, std::memory_order_relaxed);
+            auto block = m_block_id.fetch_sub(1, std::memory_order_acquire);
 
             if (block < 0)
                 break;
 
-            std::size_t begin = block * m_block_size;
-            std::size_t begin_plus_b = begin + m_block_size;
-            std::size_t end = std::min(m_jobs->size(), begin_plus_b);
-
-            for (; begin < end; ++begin)
-                simulator_process((*m_jobs)[begin], m_time);
+            process(block, m_spans[0]);
 
-            m_block_count.fetch_sub(1, std::memory_order_relaxed);
+            m_block_count.fetch_sub(1, std::memory_order_release);
         }
 
-        while (m_block_count.load(std::memory_order_relaxed) >= 0)
+        while (m_block_count.load(std::memory_order_acquire) >= 0)
             std::this_thread::sleep_for(std::chrono::nanoseconds(1));
 
         m_jobs = nullptr;
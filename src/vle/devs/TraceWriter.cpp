@@ -0,0 +1,121 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Exception.hpp>
+
+#include "devs/TraceWriter.hpp"
+#include "utils/i18n.hpp"
+
+namespace vle {
+namespace devs {
+
+TraceWriter::TraceWriter(const std::string& filename)
+  : m_file(std::fopen(filename.c_str(), "w"))
+  , m_origin(clock::now())
+{
+    if (not m_file)
+        throw utils::FileError(_("TraceWriter: fail to open file `%s'"),
+                               filename.c_str());
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", m_file);
+    std::fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+               "\"args\":{\"name\":\"vle\"}}",
+               m_file);
+
+    thread(0, "coordinator");
+}
+
+TraceWriter::~TraceWriter() noexcept
+{
+    std::fputs("\n]}\n", m_file);
+    std::fclose(m_file);
+}
+
+void
+TraceWriter::begin(const char* name,
+             const char* phase,
+             long tid,
+             clock::time_point start)
+{
+    std::fprintf(m_file,
+                 ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%ld,"
+                 "\"ts\":%.3f",
+                 name,
+                 phase,
+                 tid,
+                 microseconds(start));
+}
+
+void
+TraceWriter::thread(long tid, const char* name)
+{
+    std::fprintf(m_file,
+                 ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 "\"tid\":%ld,\"args\":{\"name\":\"%s\"}}",
+                 tid,
+                 name);
+}
+
+void
+TraceWriter::bag(Time time,
+           std::size_t size,
+           clock::time_point start,
+           clock::time_point end)
+{
+    begin("bag", "X", 0, start);
+    std::fprintf(m_file,
+                 ",\"dur\":%.3f,\"args\":{\"time\":%.17g,\"size\":%zu}}",
+                 microseconds(end) - microseconds(start),
+                 time,
+                 size);
+}
+
+void
+TraceWriter::phase(const char* name,
+             clock::time_point start,
+             clock::time_point end)
+{
+    begin(name, "X", 0, start);
+    std::fprintf(
+      m_file, ",\"dur\":%.3f}", microseconds(end) - microseconds(start));
+}
+
+void
+TraceWriter::worker(long tid,
+              long blocks,
+              long models,
+              clock::time_point start,
+              clock::time_point end)
+{
+    begin("transitions", "X", tid, start);
+    std::fprintf(m_file,
+                 ",\"dur\":%.3f,\"args\":{\"blocks\":%ld,\"models\":%ld}}",
+                 microseconds(end) - microseconds(start),
+                 blocks,
+                 models);
+}
+}
+} // namespace vle devs
@@ -0,0 +1,115 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_DEVS_TRACEWRITER_HPP
+#define VLE_DEVS_TRACEWRITER_HPP
+
+#include <vle/devs/Time.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace vle {
+namespace devs {
+
+/**
+ * @brief Write a timeline of the simulation in the Chrome trace event
+ * format (a JSON file readable by chrome://tracing or the Perfetto UI).
+ * The coordinator writes the bags and their phases on the thread 0, the
+ * workers of the \e SimulatorProcessParallel their spans on the threads 1
+ * to n. Only the coordinator's thread writes into the file: the workers'
+ * spans are collected after each \e for_each.
+ */
+class TraceWriter
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Open the file and write the header of the trace.
+     * @throw utils::FileError if the file can not be opened.
+     */
+    explicit TraceWriter(const std::string& filename);
+
+    /**
+     * @brief Write the end of the trace and close the file.
+     */
+    ~TraceWriter() noexcept;
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /**
+     * @brief Name the thread @e tid of the trace.
+     */
+    void thread(long tid, const char* name);
+
+    /**
+     * @brief A bag of @e size models at the simulation date @e time.
+     */
+    void bag(Time time,
+             std::size_t size,
+             clock::time_point start,
+             clock::time_point end);
+
+    /**
+     * @brief A phase of a bag (output, routing, etc.).
+     */
+    void phase(const char* name,
+               clock::time_point start,
+               clock::time_point end);
+
+    /**
+     * @brief The work of the thread @e tid in a parallel transition phase:
+     * from the start of its first block to the end of its last block.
+     */
+    void worker(long tid,
+                long blocks,
+                long models,
+                clock::time_point start,
+                clock::time_point end);
+
+private:
+    std::FILE* m_file;
+    clock::time_point m_origin;
+
+    /* Write the separator and the common fields of an event. */
+    void begin(const char* name,
+               const char* phase,
+               long tid,
+               clock::time_point start);
+
+    double microseconds(clock::time_point time) const noexcept
+    {
+        return std::chrono::duration<double, std::micro>(time - m_origin)
+          .count();
+    }
+};
+}
+} // namespace vle devs
+
+#endif
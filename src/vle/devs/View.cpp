@@ -48,6 +48,7 @@ View::open(utils::ContextPtr ctx,
            std::unique_ptr<value::Value> parameters)
 {
     m_name = name;
+    m_observableList.clear();
 
     auto* symbol =
       vle::utils::get_symbol(ctx,
@@ -79,6 +80,7 @@ View::open(utils::ContextPtr ctx,
            std::unique_ptr<value::Value> parameters)
 {
     m_name = name;
+    m_observableList.clear();
 
     auto& fn = vle::utils::get_oov_factory(ctx, pluginname);
     m_plugin = std::unique_ptr<oov::Plugin>(fn(location));
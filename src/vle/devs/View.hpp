@@ -63,7 +63,8 @@ public:
     ~View() = default;
 
     /**
-     * Initialize plugin with specified information.
+     * Initialize plugin with specified information. A previous plug-in
+     * and its observables are forgotten.
      *
      * @param plugin the plugin's name.
      * @param location where the plugin write data.
@@ -80,7 +81,8 @@ public:
               std::unique_ptr<value::Value> parameters);
 
     /**
-     * Initialize plugin with specified information.
+     * Initialize plugin with specified information. A previous plug-in
+     * and its observables are forgotten.
      *
      * @param plugin the plugin's name.
      * @param package the plugin's package.
@@ -26,6 +26,7 @@
 
 #include <vle/manager/Manager.hpp>
 #include <vle/manager/Simulation.hpp>
+#include <vle/manager/SimulationCache.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/Tools.hpp>
@@ -49,6 +50,8 @@
 #include "manager/details/wrapper_init.hpp"
 #include "manager/details/manager_concepts.hpp"
 #include "manager/details/manager_initializations.hpp"
+#include "manager/details/work_queue.hpp"
+#include "manager/details/replicate_stopping.hpp"
 #include "manager/details/thread_specific.hpp"
 #include "manager/details/cvle_specific.hpp"
 
@@ -79,6 +82,7 @@ public:
     bool mRemoveMPIfiles;                 // for cvle
     bool mGenerateMPIhost;                // for cvle
     std::string mWorkingDir;             // for cvle (only ?)
+    std::shared_ptr<SimulationCache> mCache; // for mono and threads
 
     void
     checkSimulationOption()
@@ -103,7 +107,11 @@ public:
             mContext->log(VLE_LOG_WARNING, "[Manager] nb slots is set to 1"
                     "since no parallelization will be used\n");
         }
-        if (mParalleloption != PARALLEL_MONO and mNbslots < 2) {
+        if (mParalleloption == PARALLEL_PROCESSES and mNbslots < 1) {
+            mNbslots = 1;
+        }
+        if (mParalleloption != PARALLEL_MONO and
+                mParalleloption != PARALLEL_PROCESSES and mNbslots < 2) {
             mNbslots = 1;
             mParalleloption = PARALLEL_MONO;
             mContext->log(VLE_LOG_WARNING, "[Manager] parallelization is "
@@ -187,6 +195,8 @@ public:
                 mParalleloption = PARALLEL_THREADS;
             } else if (tmp == "mpi") {
                 mParalleloption = PARALLEL_MPI;
+            } else if (tmp == "processes") {
+                mParalleloption = PARALLEL_PROCESSES;
             } else if (tmp == "mono") {
                 mParalleloption = PARALLEL_MONO;
             } else {
@@ -208,11 +218,32 @@ public:
             }
         }
 
+        if (init.exist("simulation_warm_start", status)) {
+            if (init.getBoolean("simulation_warm_start", status)) {
+                mSimulationoption |= SIMULATION_WARM_START;
+            } else {
+                mSimulationoption &= ~SIMULATION_WARM_START;
+            }
+        }
+
         if (init.exist("simulation_timeout", status)) {
             mTimeout = std::chrono::milliseconds(
                     init.getInt("simulation_timeout", status));
         }
 
+        if (init.exist("simulation_cache", status)) {
+            int capacity = init.getInt("simulation_cache", status);
+            std::string dir;
+            if (init.exist("simulation_cache_dir", status)) {
+                dir = init.getString("simulation_cache_dir", status);
+            }
+            if (capacity > 0) {
+                mCache = std::make_shared<SimulationCache>(capacity, 0, dir);
+            } else {
+                mCache.reset();
+            }
+        }
+
         if (init.exist("rm_MPI_files", status)) {
             mRemoveMPIfiles = init.getBoolean("rm_MPI_files", status);
         }
@@ -227,6 +258,26 @@ public:
     }
 
 
+    /********************************************************/
+    ///the stopping rules of the replicates (stop_tolerance of the outputs)
+    static std::unique_ptr<replicate_stopping>
+    make_stopping(const ManagerObjects& manObj)
+    {
+        std::unique_ptr<replicate_stopping> ret(new replicate_stopping(
+                manObj.inputsSize(), manObj.replicasSize()));
+        for (unsigned int i = 0; i < manObj.mOutputs.size(); ++i) {
+            const ManOutput& out = *manObj.mOutputs[i];
+            if (out.stopTolerance > 0) {
+                ret->add(i, out.stopTolerance, out.stopConfidence,
+                        out.stopMinReplicates);
+            }
+        }
+        if (not ret->enabled()) {
+            return nullptr;
+        }
+        return ret;
+    }
+
     /********************************************************/
     ///run plan without parallelization
     std::unique_ptr<value::Map>
@@ -234,6 +285,7 @@ public:
             std::unique_ptr<vpz::Vpz> model,
             std::unique_ptr<ManagerObjects> manObj,
             const wrapper_init& init,
+            PlanSink* sink,
             manager::Error& err)
     {
         init_embedded_model(*model, *manObj, init, err);
@@ -252,28 +304,40 @@ public:
         mContext->log(VLE_LOG_NOTICE, "[Manager] simulation mono nb simus:"
                 " %u \n", (repSize*inputSize));
 
-        std::vector<std::thread> gp;
-        std::mutex results_mutex;
+        std::mutex error_mutex;
+        work_queue queue(inputSize, repSize);
+        std::unique_ptr<replicate_stopping> stopping = make_stopping(*manObj);
 
         thread_worker worker = thread_worker(mContext, *model, init,
-                *manObj, manObj->mOutputs, *results, results_mutex,
-                mTimeout, mSimulationoption, 0, 1, err);
+                *manObj, manObj->mOutputs, error_mutex,
+                mTimeout, mSimulationoption, queue, sink, stopping.get(),
+                mCache, err);
         worker();
         if (err.code) {
             return nullptr;
         }
+        if (not sink) {
+            std::vector<std::vector<std::unique_ptr<ManOutput>>> partials;
+            thread_reduce(manObj->mOutputs, partials, *results, 1, err);
+            if (err.code) {
+                return nullptr;
+            }
+        }
 
         mContext->log(VLE_LOG_NOTICE, "[Manager] end simulation"
                 " and aggregation without parallelization\n");
         return results;
     }
     /********************************************************/
-    ///run plan with threads
+    ///run plan with threads, with simulationoption spawn, each thread
+    ///drives its own worker process
     std::unique_ptr<value::Map>
     run_with_threads(
             std::unique_ptr<vpz::Vpz> model,
             std::unique_ptr<ManagerObjects> manObj,
             const wrapper_init& init,
+            SimulationOptions simulationoption,
+            PlanSink* sink,
             manager::Error& err)
     {
         init_embedded_model(*model, *manObj, init, err);
@@ -290,18 +354,38 @@ public:
         unsigned int repSize = manObj->replicasSize();
 
         mContext->log(VLE_LOG_NOTICE, "[Manager] simulation threads"
-                " (%d threads) nb simus: %u \n", mNbslots,
+                " (%d threads%s) nb simus: %u \n", mNbslots,
+                (simulationoption & SIMULATION_SPAWN_PROCESS) ?
+                        " with worker processes" : "",
                 (repSize*inputSize));
 
         std::vector<std::thread> gp;
-        std::mutex results_mutex;
+        std::mutex error_mutex;
+        work_queue queue(inputSize, repSize, manObj->mCostHint);
+        std::unique_ptr<replicate_stopping> stopping = make_stopping(*manObj);
+        if (stopping) {
+            // the threads take the next replicates of the inputs in turn,
+            // each input can stop before all its replicates are taken.
+            queue.interleave(stopping->min_replicates());
+        }
+
+        //each worker aggregates into its own outputs
+        std::vector<std::vector<std::unique_ptr<ManOutput>>> partials(
+                mNbslots);
+        for (auto& partial : partials) {
+            for (const auto& out : manObj->mOutputs) {
+                partial.emplace_back(out->clone());
+            }
+        }
+
         for (uint32_t i = 0; i < mNbslots; ++i) {
             utils::ContextPtr ctx = mContext->clone();
             ctx->set_log_function(std::unique_ptr<utils::Context::LogFunctor>(
                     new thread_log(i)));
             gp.emplace_back(thread_worker(ctx, *model, init,
-                    *manObj, manObj->mOutputs, *results, results_mutex,
-                    mTimeout, mSimulationoption, i, mNbslots, err));
+                    *manObj, partials[i], error_mutex,
+                    mTimeout, simulationoption, queue, sink, stopping.get(),
+                    mCache, err));
         }
 
         for (uint32_t i = 0; i < mNbslots; ++i)
@@ -311,6 +395,14 @@ public:
             return nullptr;
         }
 
+        if (not sink) {
+            thread_reduce(manObj->mOutputs, partials, *results, mNbslots,
+                    err);
+            if (err.code) {
+                return nullptr;
+            }
+        }
+
         mContext->log(VLE_LOG_NOTICE, "[Manager] end simulation and"
                 " aggregation using threads\n");
         return results;
@@ -323,6 +415,7 @@ public:
             std::unique_ptr<vpz::Vpz> model,
             std::unique_ptr<ManagerObjects> manObj,
             const wrapper_init& init,
+            PlanSink* sink,
             manager::Error& err)
     {
         init_embedded_model(*model, *manObj, init, err);
@@ -336,6 +429,11 @@ public:
         mContext->log(VLE_LOG_NOTICE, "[Manager] simulation with mpi"
                 " (%d slots) nb simus: %u \n", mNbslots,
                 (repSize*inputSize));
+        if (make_stopping(*manObj)) {
+            mContext->log(VLE_LOG_WARNING, "[Manager] the stop_tolerance of "
+                    "the outputs is ignored with mpi, all the replicates are "
+                    "simulated\n");
+        }
 
         //save vpz
         utils::Path tempVpzPath = make_temp(
@@ -421,18 +519,15 @@ public:
             return nullptr;
         }
         bool is_success = true;
-        std::string output, error;
-        while (not mspawn.isfinish()) {
-            if (mspawn.get(&output, &error)) {
-                mContext->log(VLE_LOG_INFO, output);
-                output.clear();
-                mContext->log(VLE_LOG_INFO, error);
-                error.clear();
-                std::this_thread::sleep_for(std::chrono::microseconds(200));
-            } else {
-                break;
-            }
-        }
+        std::string error;
+        mspawn.waitFor(
+          std::chrono::milliseconds::zero(),
+          [this](const std::string& out, const std::string& msg) {
+              if (not out.empty())
+                  mContext->log(VLE_LOG_INFO, out);
+              if (not msg.empty())
+                  mContext->log(VLE_LOG_INFO, msg);
+          });
         mspawn.wait();
         mspawn.status(&error, &is_success);
         if (! is_success) {
@@ -446,7 +541,7 @@ public:
                 "[Manager] simulation with mpi performed\n");
         //read output file
         std::unique_ptr<value::Map> results = cvle_read(tempOutCsv,
-                inputSize, repSize, manObj->mOutputs, err);
+                inputSize, repSize, manObj->mOutputs, sink, err);
         if (err.code) {
             return nullptr;
         }
@@ -456,6 +551,8 @@ public:
             tempOutCsv.remove();
             tempInCsv.remove();
             tempVpzPath.remove();
+            utils::Path(vpz::Vpz::compiledFilename(tempVpzPath.string()))
+              .remove();
             if (mGenerateMPIhost) {
                 tempHostFile.remove();
             }
@@ -463,6 +560,31 @@ public:
         return results;
     }
 
+    /*********************************************/
+    //read the cost_hint: a tuple or a set of numbers, one for each input
+    static std::vector<double>
+    costHintFromValue(const value::Value& val)
+    {
+        std::vector<double> ret;
+        if (val.isTuple()) {
+            ret = val.toTuple().value();
+        } else if (val.isSet()) {
+            for (const auto& elem : val.toSet().value()) {
+                if (elem and elem->isDouble()) {
+                    ret.push_back(elem->toDouble().value());
+                } else if (elem and elem->isInteger()) {
+                    ret.push_back(elem->toInteger().value());
+                } else {
+                    throw utils::ArgError("the cost_hint has a value which "
+                            "is not a number");
+                }
+            }
+        } else {
+            throw utils::ArgError("the cost_hint is not a tuple or a set");
+        }
+        return ret;
+    }
+
     /*********************************************/
     //init manager structures from wrapper init
     std::unique_ptr<ManagerObjects>
@@ -495,8 +617,18 @@ public:
                 } else if (parseOutput(conf, out_id)){
                     manObj->mOutputs.emplace_back(
                             new ManOutput(out_id, val));
+                } else if (conf == "cost_hint") {
+                    manObj->mCostHint = costHintFromValue(val);
                 }
             }
+            if (not manObj->mCostHint.empty()
+                    and manObj->mCostHint.size() != manObj->inputsSize()) {
+                throw utils::ArgError(utils::format(
+                        "the cost_hint has %u values, expected %u (the "
+                        "number of inputs)",
+                        (unsigned int)manObj->mCostHint.size(),
+                        manObj->inputsSize()));
+            }
             std::sort(manObj->mDefine.begin(), manObj->mDefine.end(),
                     ManDefineSorter());
             std::sort(manObj->mPropagate.begin(), manObj->mPropagate.end(),
@@ -593,7 +725,7 @@ public:
     // run wrapper
     std::unique_ptr<value::Map>
     runPlan(std::unique_ptr<vpz::Vpz> model, wrapper_init& init,
-            manager::Error& err)
+            PlanSink* sink, manager::Error& err)
     {
         std::unique_ptr<ManagerObjects> manObj = init_from_plan(init, err);
         if (err.code) return nullptr;
@@ -601,15 +733,20 @@ public:
         switch(mParalleloption) {
         case PARALLEL_MONO: {
             return run_without_parallelization(std::move(model),
-                    std::move(manObj), init, err);
+                    std::move(manObj), init, sink, err);
             break;
         } case PARALLEL_THREADS: {
             return run_with_threads(std::move(model),
-                    std::move(manObj), init, err);
+                    std::move(manObj), init, mSimulationoption, sink, err);
+            break;
+        } case PARALLEL_PROCESSES: {
+            return run_with_threads(std::move(model),
+                    std::move(manObj), init,
+                    mSimulationoption | SIMULATION_SPAWN_PROCESS, sink, err);
             break;
         } case PARALLEL_MPI: {
             return run_with_cvle(std::move(model),
-                    std::move(manObj), init, err);
+                    std::move(manObj), init, sink, err);
             break;
         }}
         return nullptr;
@@ -674,6 +811,12 @@ Manager::configure(const vd::InitEventList& config)
     mPimpl->configure(config_rec);
 }
 
+void
+Manager::setSimulationCache(std::shared_ptr<SimulationCache> cache)
+{
+    mPimpl->mCache = std::move(cache);
+}
+
 utils::Rand&
 Manager::random_number_generator()
 {
@@ -688,7 +831,7 @@ Manager::runPlan(const vle::value::Map& init
     wrapper_init init_rec(&init);
     std::unique_ptr<vpz::Vpz> model = build_embedded_model(
             init_rec, mPimpl->mContext, err);
-    return mPimpl->runPlan(std::move(model), init_rec, err);
+    return mPimpl->runPlan(std::move(model), init_rec, nullptr, err);
 }
 
 std::unique_ptr<value::Map>
@@ -698,7 +841,7 @@ Manager::runPlan(const vd::InitEventList& init
     wrapper_init init_rec(&init);
     std::unique_ptr<vpz::Vpz> model = build_embedded_model(
             init_rec, mPimpl->mContext, err);
-    return mPimpl->runPlan(std::move(model), init_rec, err);
+    return mPimpl->runPlan(std::move(model), init_rec, nullptr, err);
 }
 
 std::unique_ptr<value::Map>
@@ -707,7 +850,7 @@ Manager::runPlan(std::unique_ptr<vpz::Vpz> model
         , manager::Error& err)
 {
     wrapper_init init_rec(&init);
-    return mPimpl->runPlan(std::move(model), init_rec, err);
+    return mPimpl->runPlan(std::move(model), init_rec, nullptr, err);
 }
 
 std::unique_ptr<value::Map>
@@ -716,7 +859,45 @@ Manager::runPlan(std::unique_ptr<vpz::Vpz> model
         , manager::Error& err)
 {
     wrapper_init init_rec(&init);
-    return mPimpl->runPlan(std::move(model), init_rec, err);
+    return mPimpl->runPlan(std::move(model), init_rec, nullptr, err);
+}
+
+void
+Manager::runPlan(const vle::value::Map& init, PlanSink& sink
+        , manager::Error& err)
+{
+    wrapper_init init_rec(&init);
+    std::unique_ptr<vpz::Vpz> model = build_embedded_model(
+            init_rec, mPimpl->mContext, err);
+    mPimpl->runPlan(std::move(model), init_rec, &sink, err);
+}
+
+void
+Manager::runPlan(const vd::InitEventList& init, PlanSink& sink
+        , manager::Error& err)
+{
+    wrapper_init init_rec(&init);
+    std::unique_ptr<vpz::Vpz> model = build_embedded_model(
+            init_rec, mPimpl->mContext, err);
+    mPimpl->runPlan(std::move(model), init_rec, &sink, err);
+}
+
+void
+Manager::runPlan(std::unique_ptr<vpz::Vpz> model
+        , const vle::value::Map& init, PlanSink& sink
+        , manager::Error& err)
+{
+    wrapper_init init_rec(&init);
+    mPimpl->runPlan(std::move(model), init_rec, &sink, err);
+}
+
+void
+Manager::runPlan(std::unique_ptr<vpz::Vpz> model
+        , const vd::InitEventList& init, PlanSink& sink
+        , manager::Error& err)
+{
+    wrapper_init init_rec(&init);
+    mPimpl->runPlan(std::move(model), init_rec, &sink, err);
 }
 
 //specific getEmbedded signatures
@@ -26,17 +26,22 @@
 
 #include <vle/DllDefines.hpp>
 #include <vle/manager/Simulation.hpp>
+#include <vle/manager/SimulationCache.hpp>
 #include <vle/utils/Spawn.hpp>
 #include <vle/utils/Tools.hpp>
+#include <vle/value/Binary.hpp>
 
 #include "devs/RootCoordinator.hpp"
+#include "manager/SimulationWorker.hpp"
 #include "utils/ContextPrivate.hpp"
 #include "utils/i18n.hpp"
+#include "vpz/VpzBinary.hpp"
 
 #include <boost/format.hpp>
 #include <boost/timer.hpp>
 
 #include <fstream>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <utility>
@@ -88,8 +93,37 @@ public:
     utils::ContextPtr m_context;
     std::chrono::milliseconds m_timeout;
     utils::UnlinkPath m_vpz_file;
+    utils::UnlinkPath m_vpz_cache_file; // written by a vle with VLE_VPZ_CACHE
     utils::UnlinkPath m_output_file;
     SimulationOptions m_simulationoptions;
+    std::unique_ptr<devs::RootCoordinator> m_root;
+    devs::Statistics m_statistics;
+    devs::Profile m_profile;
+    std::string m_trace_file;
+
+    /* The worker process of the SIMULATION_SPAWN_PROCESS mode, started by
+     * the first run and restarted after a crash or a timeout. */
+    std::unique_ptr<SimulationWorker> m_worker;
+
+    /* The encoded values of the conditions of the last job of the worker,
+     * by condition and port. The caller may modify the values in place
+     * between two runs, a copy of the conditions would share them. */
+    std::map<std::pair<std::string, std::string>, std::string>
+      m_worker_values;
+    bool m_worker_restartable;
+
+    /* The structure of the models of the last run, without the locations
+     * of the outputs, in the SIMULATION_WARM_START mode, and its instance:
+     * a run of a vpz with the same structure restarts the models with the
+     * locations of its outputs. */
+    std::string m_structure;
+    long m_instance;
+
+    /* The cache of results and the key of the structure of the models of
+     * the last run, to compute the keys of the restarts. */
+    std::shared_ptr<SimulationCache> m_cache;
+    std::string m_cache_structure;
+    bool m_cache_structure_valid;
 
     Pimpl(utils::ContextPtr context,
           SimulationOptions simulationoptionts,
@@ -97,8 +131,13 @@ public:
       : m_context(std::move(context))
       , m_timeout(timeout)
       , m_vpz_file(make_temp("vle-%%%%-%%%%-%%%%-%%%%.vpz"))
+      , m_vpz_cache_file(vpz::Vpz::compiledFilename(m_vpz_file.string()))
       , m_output_file(make_temp("vle-%%%%-%%%%-%%%%-%%%%.value"))
       , m_simulationoptions(simulationoptionts)
+      , m_worker_restartable(false)
+      , m_instance(-1)
+      , m_cache_structure()
+      , m_cache_structure_valid(false)
     {
         if (timeout != std::chrono::milliseconds::zero())
             m_simulationoptions |= vle::manager::SIMULATION_SPAWN_PROCESS;
@@ -110,7 +149,12 @@ public:
         std::unique_ptr<value::Map> result;
         boost::timer timer;
         try {
-            devs::RootCoordinator root(m_context);
+            m_root = std::make_unique<devs::RootCoordinator>(m_context);
+            m_root->enableStatistics(m_simulationoptions &
+                                     SIMULATION_STATISTICS);
+            m_root->enableProfile(m_simulationoptions & SIMULATION_PROFILE);
+            m_root->setTrace(m_trace_file);
+            devs::RootCoordinator& root = *m_root;
 
             const double duration = vpz->project().experiment().duration();
 
@@ -155,6 +199,8 @@ public:
             error->code = -1;
         }
 
+        keepRoot(*error);
+
         return result;
     }
 
@@ -164,16 +210,20 @@ public:
         std::unique_ptr<value::Map> result;
 
         try {
-            devs::RootCoordinator root(m_context);
+            m_root = std::make_unique<devs::RootCoordinator>(m_context);
+            m_root->enableStatistics(m_simulationoptions &
+                                     SIMULATION_STATISTICS);
+            m_root->enableProfile(m_simulationoptions & SIMULATION_PROFILE);
+            m_root->setTrace(m_trace_file);
 
-            root.load(*vpz);
+            m_root->load(*vpz);
             vpz->clear();
             vpz.reset(nullptr);
 
-            root.init();
-            while (root.run()) {
+            m_root->init();
+            while (m_root->run()) {
             }
-            result = root.finish();
+            result = m_root->finish();
 
             error->code = 0;
         } catch (const std::exception& e) {
@@ -182,16 +232,222 @@ public:
             error->code = -1;
         }
 
+        keepRoot(*error);
         return result;
     }
 
-    std::unique_ptr<value::Map> runSubProcess(std::unique_ptr<vpz::Vpz> vpz,
+    std::unique_ptr<value::Map> runRestart(const vpz::Conditions& conditions,
+                                           const vpz::Outputs* outputs,
+                                           long instance,
+                                           Error* error)
+    {
+        std::unique_ptr<value::Map> result;
+
+        try {
+            m_context->debug(_(" - Coordinator restart ..........\n"));
+
+            if (outputs)
+                m_root->setOutputLocations(*outputs);
+            m_root->restart(conditions, instance);
+            m_root->init();
+            while (m_root->run()) {
+            }
+            result = m_root->finish();
+
+            error->code = 0;
+        } catch (const std::exception& e) {
+            error->message =
+              utils::format(_("\n/!\\ error reported: %s\n"), e.what());
+            error->code = -1;
+        }
+
+        keepRoot(*error);
+        return result;
+    }
+
+    /* The models are kept for the next run only in warm start mode and if
+     * the simulation succeeds. */
+    void keepRoot(const Error& error)
+    {
+        m_statistics = m_root->statistics();
+        if (m_simulationoptions & SIMULATION_PROFILE)
+            m_profile = m_root->profile();
+
+        if (error.code or
+            not(m_simulationoptions & SIMULATION_WARM_START) or
+            not m_root->isRestartable())
+            m_root.reset();
+    }
+
+    bool isRestartable() const noexcept
+    {
+        return m_root != nullptr or m_worker_restartable;
+    }
+
+    bool useCache() const
+    {
+        return m_cache and m_cache->isEnabled() and
+               not(m_simulationoptions & SIMULATION_NO_RETURN);
+    }
+
+    bool cacheKey(const vpz::Conditions& conditions, std::string* key)
+    {
+        try {
+            *key = SimulationCache::key(m_cache_structure, conditions);
+            return true;
+        } catch (const std::exception& e) {
+            m_context->warning(_("Simulation cache: %s\n"), e.what());
+            return false;
+        }
+    }
+
+    std::unique_ptr<value::Map> runWorker(const vpz::Vpz& vpz, Error* error)
+    {
+        std::string job;
+        try {
+            vpz::vpz_binary_write(vpz, 0, job);
+        } catch (const std::exception& e) {
+            error->code = -1;
+            error->message = e.what();
+            return {};
+        }
+
+        m_worker_values.clear();
+        try {
+            for (const auto& cnd :
+                 vpz.project().experiment().conditions().conditionlist())
+                for (const auto& port : cnd.second.conditionvalues())
+                    value::BinaryWriter(
+                      m_worker_values[{ cnd.first, port.first }])
+                      .writeValue(port.second.get());
+        } catch (const std::exception& /*e*/) {
+            m_worker_values.clear();
+        }
+
+        return callWorker((m_simulationoptions & SIMULATION_WARM_START)
+                            ? WorkerMessage::warm_vpz
+                            : WorkerMessage::vpz,
+                          job,
+                          error);
+    }
+
+    /* Only the values of the conditions that differ from the previous job
+     * are sent to the worker process. */
+    std::unique_ptr<value::Map> restartWorker(
+      const vpz::Conditions& conditions,
+      const vpz::Outputs* outputs,
+      long instance,
+      Error* error)
+    {
+        std::string job, encoded;
+        value::BinaryWriter out(job);
+        uint32_t overrides = 0;
+        std::size_t position = 0;
+
+        try {
+            out.writeUint64(static_cast<uint64_t>(instance));
+            if (outputs) {
+                const auto& list = outputs->outputlist();
+                out.writeUint32(static_cast<uint32_t>(list.size()));
+                for (const auto& elem : list) {
+                    out.writeString(elem.first);
+                    out.writeString(elem.second.location());
+                }
+            } else {
+                out.writeUint32(0);
+            }
+
+            position = job.size();
+            out.writeUint32(overrides);
+            for (const auto& cnd : conditions.conditionlist()) {
+                for (const auto& port : cnd.second.conditionvalues()) {
+                    encoded.clear();
+                    value::BinaryWriter(encoded).writeValue(
+                      port.second.get());
+
+                    auto& previous = m_worker_values[{ cnd.first,
+                                                       port.first }];
+                    if (previous == encoded)
+                        continue;
+
+                    previous.swap(encoded);
+                    out.writeString(cnd.first);
+                    out.writeString(port.first);
+                    out.writeValue(port.second.get());
+                    ++overrides;
+                }
+            }
+        } catch (const std::exception& e) {
+            m_worker_values.clear();
+            error->code = -1;
+            error->message = e.what();
+            return {};
+        }
+
+        std::string count;
+        value::BinaryWriter(count).writeUint32(overrides);
+        job.replace(position, count.size(), count);
+
+        return callWorker(WorkerMessage::conditions, job, error);
+    }
+
+    std::unique_ptr<value::Map> callWorker(WorkerMessage type,
+                                           const std::string& job,
+                                           Error* error)
+    {
+        m_worker_restartable = false;
+
+        if (not m_worker)
+            m_worker = std::make_unique<SimulationWorker>(m_context);
+
+        WorkerMessage answer_type;
+        std::string answer;
+
+        if (not m_worker->start(&error->message) or
+            not m_worker->call(
+              type, job, &answer_type, &answer, m_timeout, &error->message)) {
+            m_context->error(_("VLE worker failure: %s\n"),
+                             error->message.c_str());
+            error->code = -1;
+            return {};
+        }
+
+        try {
+            value::BinaryReader in(answer.data(),
+                                   answer.data() + answer.size());
+
+            if (answer_type == WorkerMessage::error) {
+                error->code = -1;
+                error->message = in.readString();
+                return {};
+            }
+
+            m_worker_restartable =
+              in.readUint8() and
+              (m_simulationoptions & SIMULATION_WARM_START);
+
+            auto result = in.readValue();
+            if (result and result->isMap())
+                return std::unique_ptr<value::Map>(
+                  static_cast<value::Map*>(result.release()));
+        } catch (const std::exception& e) {
+            error->code = -1;
+            error->message = e.what();
+        }
+
+        return {};
+    }
+
+    std::unique_ptr<value::Map> runSubProcess(const vpz::Vpz& vpz,
                                               Error* error)
     {
         auto pwd = utils::Path::current_path();
         std::string command;
 
-        vpz->write(m_vpz_file.string());
+        {
+            std::ofstream ofs(m_vpz_file.string());
+            ofs << vpz.writeToString();
+        }
 
         try {
             m_context->get_setting("vle.command.vle.simulation", &command);
@@ -208,61 +464,23 @@ public:
                 return {};
             }
 
-            std::string output, err;
             std::string message;
             bool success;
 
-            if (m_timeout != std::chrono::milliseconds::zero()) {
-                auto duration = m_timeout;
-                auto starttime = std::chrono::system_clock::now();
-
-                while (not spawn.isfinish()) {
-                    if (spawn.get(&output, &err)) {
-                        if (not output.empty()) {
-                            m_context->log(m_context->get_log_priority(),
-                                    "%s", output.c_str());
-                        }
-                        if (not err.empty()) {
-                            m_context->log(m_context->get_log_priority(),
-                                    "%s", err.c_str());
-                        }
-                        output.clear();
-                        err.clear();
-
-                        std::this_thread::sleep_for(
-                          std::chrono::microseconds(200));
-
-                        auto endtime = std::chrono::system_clock::now();
-                        auto elapsed = endtime - starttime;
-                        if (elapsed > duration) {
-                            printf("kill process. Too long\n");
-                            spawn.kill();
-                            break;
-                        }
-                    } else {
-                        break;
-                    }
-                }
-            } else {
-                while (not spawn.isfinish()) {
-                    if (spawn.get(&output, &err)) {
-                        if (not output.empty()) {
-                            m_context->log(m_context->get_log_priority(),
-                                    "%s", output.c_str());
-                        }
-                        if (not err.empty()) {
-                            m_context->log(m_context->get_log_priority(),
-                                    "%s", err.c_str());
-                        }
-                        output.clear();
-                        err.clear();
-
-                        std::this_thread::sleep_for(
-                          std::chrono::microseconds(200));
-                    } else {
-                        break;
-                    }
-                }
+            auto finished = spawn.waitFor(
+              m_timeout,
+              [this](const std::string& output, const std::string& err) {
+                  if (not output.empty())
+                      m_context->log(
+                        m_context->get_log_priority(), "%s", output.c_str());
+                  if (not err.empty())
+                      m_context->log(
+                        m_context->get_log_priority(), "%s", err.c_str());
+              });
+
+            if (not finished) {
+                printf("kill process. Too long\n");
+                spawn.kill();
             }
             spawn.wait();
             spawn.status(&message, &success);
@@ -292,6 +510,129 @@ public:
 
         return {};
     }
+    /* Restart the kept models, with the locations of the @c outputs if
+     * not null. */
+    std::unique_ptr<value::Map> restart(const vpz::Conditions& conditions,
+                                        const vpz::Outputs* outputs,
+                                        long instance,
+                                        Error* error)
+    {
+        if (not isRestartable()) {
+            error->code = -1;
+            error->message = _("Simulation: no model to restart");
+            return {};
+        }
+
+        error->code = 0;
+        m_statistics = devs::Statistics();
+        m_profile = devs::Profile();
+        m_instance = instance;
+
+        std::string key;
+        bool cached = useCache() and m_cache_structure_valid and
+                      cacheKey(conditions, &key);
+
+        std::unique_ptr<value::Map> result;
+        if (cached and m_cache->get(key, &result))
+            return result;
+
+        result = m_root
+                   ? runRestart(conditions, outputs, instance, error)
+                   : restartWorker(conditions, outputs, instance, error);
+
+        if (cached and not error->code and result)
+            m_cache->put(key, *result);
+
+        if (m_simulationoptions & manager::SIMULATION_NO_RETURN) {
+            return {};
+        } else {
+            return result;
+        }
+    }
+
+    /* In warm start mode, a vpz with the structure of the kept models
+     * restarts them with its conditions and the locations of its outputs
+     * (a workspace per simulation). Otherwise, the simulation in the
+     * current process takes the ownership of the vpz, a copy is made if
+     * the caller keeps it, and the other modes encode the whole vpz. */
+    std::unique_ptr<value::Map> run(const vpz::Vpz& vpz,
+                                    std::unique_ptr<vpz::Vpz> owned,
+                                    Error* error)
+    {
+        std::string structure;
+        if (m_simulationoptions & SIMULATION_WARM_START) {
+            try {
+                vpz::vpz_binary_write_structure(vpz, structure, false);
+            } catch (const std::exception& /*e*/) {
+                structure.clear();
+            }
+
+            if (not structure.empty() and structure == m_structure and
+                isRestartable())
+                return restart(vpz.project().experiment().conditions(),
+                               &vpz.project().experiment().views().outputs(),
+                               vpz.project().instance(),
+                               error);
+        }
+
+        m_structure = std::move(structure);
+        m_instance = vpz.project().instance();
+
+        error->code = 0;
+        std::unique_ptr<value::Map> result;
+        m_root.reset();
+        m_statistics = devs::Statistics();
+        m_profile = devs::Profile();
+
+        std::string key;
+        bool cached = false;
+        m_cache_structure_valid = false;
+        if (useCache()) {
+            try {
+                m_cache_structure =
+                  SimulationCache::structureKey(m_context, vpz);
+                m_cache_structure_valid = true;
+            } catch (const std::exception& e) {
+                m_context->warning(_("Simulation cache: %s\n"), e.what());
+            }
+
+            cached =
+              m_cache_structure_valid and
+              cacheKey(vpz.project().experiment().conditions(), &key);
+
+            if (cached and m_cache->get(key, &result)) {
+                m_worker_restartable = false;
+                return result;
+            }
+        }
+
+        if (m_simulationoptions & SIMULATION_SPAWN_PROCESS) {
+#ifdef _WIN32
+            result = runSubProcess(vpz, error);
+#else
+            result = runWorker(vpz, error);
+#endif
+        } else {
+            if (not owned)
+                owned = std::make_unique<vpz::Vpz>(vpz);
+
+            int log_level = m_context->get_log_priority();
+            if (log_level < VLE_LOG_DEBUG) {
+                result = runQuiet(std::move(owned), error);
+            } else {
+                result = runVerbose(std::move(owned), error);
+            }
+        }
+
+        if (cached and not error->code and result)
+            m_cache->put(key, *result);
+
+        if (m_simulationoptions & manager::SIMULATION_NO_RETURN) {
+            return {};
+        } else {
+            return result;
+        }
+    }
 };
 
 Simulation::Simulation(utils::ContextPtr context,
@@ -307,24 +648,69 @@ Simulation::~Simulation() = default;
 std::unique_ptr<value::Map>
 Simulation::run(std::unique_ptr<vpz::Vpz> vpz, Error* error)
 {
-    error->code = 0;
-    std::unique_ptr<value::Map> result;
-
-    if (mPimpl->m_simulationoptions & SIMULATION_SPAWN_PROCESS) {
-        result = mPimpl->runSubProcess(std::move(vpz), error);
-    } else {
-        int log_level = mPimpl->m_context->get_log_priority();
-        if (log_level < VLE_LOG_DEBUG) {
-            result = mPimpl->runQuiet(std::move(vpz), error);
-        } else {
-            result = mPimpl->runVerbose(std::move(vpz), error);
-        }
-    }
-    if (mPimpl->m_simulationoptions & manager::SIMULATION_NO_RETURN) {
-        return {};
-    } else {
-        return result;
-    }
+    const vpz::Vpz& ref = *vpz;
+
+    return mPimpl->run(ref, std::move(vpz), error);
+}
+
+std::unique_ptr<value::Map>
+Simulation::run(const vpz::Vpz& vpz, Error* error)
+{
+    return mPimpl->run(vpz, nullptr, error);
+}
+
+const devs::Statistics&
+Simulation::statistics() const
+{
+    return mPimpl->m_statistics;
+}
+
+const devs::Profile&
+Simulation::profile() const
+{
+    return mPimpl->m_profile;
+}
+
+bool
+Simulation::isRestartable() const
+{
+    return mPimpl->isRestartable();
+}
+
+std::unique_ptr<value::Map>
+Simulation::restart(const vpz::Conditions& conditions, Error* error)
+{
+    return mPimpl->restart(conditions, nullptr, mPimpl->m_instance, error);
+}
+
+std::unique_ptr<value::Map>
+Simulation::restart(const vpz::Conditions& conditions,
+                    const vpz::Outputs& outputs,
+                    long instance,
+                    Error* error)
+{
+    return mPimpl->restart(conditions, &outputs, instance, error);
+}
+
+void
+Simulation::setCache(std::shared_ptr<SimulationCache> cache)
+{
+    mPimpl->m_cache = std::move(cache);
+    mPimpl->m_cache_structure_valid = false;
+}
+
+void
+Simulation::setTrace(std::string filename)
+{
+    mPimpl->m_trace_file = std::move(filename);
+    if (mPimpl->m_root)
+        mPimpl->m_root->setTrace(mPimpl->m_trace_file);
+}
+
+int
+Simulation::serve(utils::ContextPtr context)
+{
+    return simulation_worker_serve(std::move(context));
 }
 }
 }
@@ -0,0 +1,394 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/manager/SimulationCache.hpp>
+#include <vle/utils/Filesystem.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/value/Binary.hpp>
+
+#include "vpz/VpzBinary.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+namespace vle {
+namespace manager {
+
+namespace {
+
+const char cache_magic[4] = { 'V', 'L', 'E', 'R' };
+
+uint64_t
+fnv1a(uint64_t hash, const std::string& buffer)
+{
+    for (auto c : buffer) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= UINT64_C(1099511628211);
+    }
+
+    return hash;
+}
+
+uint64_t
+fnv1a(const std::string& buffer)
+{
+    return fnv1a(UINT64_C(14695981039346656037), buffer);
+}
+
+/* The version of a binary package: its description file and the path,
+ * size and modification time of its plug-ins, from the first repository
+ * where it is found. */
+void
+write_package_version(utils::ContextPtr context,
+                      const std::string& package,
+                      value::BinaryWriter& out)
+{
+    out.writeString(package);
+
+    for (const auto& dir : context->getBinaryPackagesDir()) {
+        auto pkg = dir / package;
+        if (not pkg.is_directory())
+            continue;
+
+        std::ifstream ifs((pkg / "Description.txt").string(),
+                          std::ios::binary);
+        out.writeString(std::string(std::istreambuf_iterator<char>(ifs),
+                                    std::istreambuf_iterator<char>()));
+
+        for (auto type : { utils::Context::ModuleType::MODULE_DYNAMICS,
+                           utils::Context::ModuleType::MODULE_OOV }) {
+            for (const auto& module :
+                 context->get_dynamic_libraries(package, type)) {
+                out.writeString(module.path.string());
+                out.writeUint64(module.path.file_size());
+                out.writeUint64(
+                  static_cast<uint64_t>(module.path.last_write_time()));
+            }
+        }
+
+        return;
+    }
+}
+
+} // anonymous namespace
+
+class SimulationCache::Pimpl
+{
+public:
+    using entry = std::pair<std::string, std::string>; // key, result
+
+    std::mutex m_mutex;
+    std::list<entry> m_lru; // most recently used first
+    std::unordered_map<uint64_t, std::list<entry>::iterator> m_index;
+    std::size_t m_capacity;
+    std::size_t m_max_bytes;
+    std::size_t m_bytes;
+    std::size_t m_hits;
+    std::size_t m_misses;
+    std::string m_directory;
+    bool m_enabled;
+
+    Pimpl(std::size_t capacity, std::size_t max_bytes, std::string directory)
+      : m_capacity(capacity)
+      , m_max_bytes(max_bytes)
+      , m_bytes(0)
+      , m_hits(0)
+      , m_misses(0)
+      , m_directory(std::move(directory))
+      , m_enabled(true)
+    {
+        if (not m_directory.empty())
+            utils::Path(m_directory).create_directories();
+    }
+
+    utils::Path filename(const std::string& key) const
+    {
+        utils::Path ret(m_directory);
+        ret /= utils::format("%016llx.value",
+                             static_cast<unsigned long long>(fnv1a(key)));
+        return ret;
+    }
+
+    /* The file stores the full key after the magic: two keys with the
+     * same hash share a file name, the last written one wins. */
+    bool read_file(const std::string& key, std::string* buffer) const
+    {
+        std::ifstream ifs(filename(key).string(), std::ios::binary);
+        if (not ifs.is_open())
+            return false;
+
+        std::string file((std::istreambuf_iterator<char>(ifs)),
+                         std::istreambuf_iterator<char>());
+
+        if (file.size() < sizeof(cache_magic) or
+            file.compare(0, sizeof(cache_magic), cache_magic,
+                         sizeof(cache_magic)))
+            return false;
+
+        try {
+            value::BinaryReader in(file.data() + sizeof(cache_magic),
+                                   file.data() + file.size());
+            if (in.readString() != key)
+                return false;
+        } catch (const std::exception& /*e*/) {
+            return false;
+        }
+
+        buffer->assign(file,
+                       sizeof(cache_magic) + sizeof(uint32_t) + key.size(),
+                       std::string::npos);
+        return true;
+    }
+
+    /* The file is written under a temporary name and renamed, so a
+     * concurrent reader never sees a partial result. */
+    void write_file(const std::string& key, const std::string& buffer) const
+    {
+        auto file = filename(key);
+        auto tmp = utils::Path::unique_path(file.string() + "-%%%%-%%%%");
+
+        std::string header(cache_magic, sizeof(cache_magic));
+        value::BinaryWriter(header).writeString(key);
+
+        {
+            std::ofstream ofs(tmp.string(), std::ios::binary);
+            if (not ofs.is_open())
+                return;
+
+            ofs.write(header.data(), header.size());
+            ofs.write(buffer.data(), buffer.size());
+            if (not ofs.good()) {
+                ofs.close();
+                tmp.remove();
+                return;
+            }
+        }
+
+        if (not utils::Path::rename(tmp, file))
+            tmp.remove();
+    }
+
+    static std::size_t bytes(const entry& elem) noexcept
+    {
+        return elem.first.size() + elem.second.size();
+    }
+
+    /* The result of @c key in memory or nullptr. The index uses the hash
+     * of the keys, the full key is compared. */
+    entry* find(uint64_t hash, const std::string& key)
+    {
+        auto it = m_index.find(hash);
+        if (it == m_index.end() or it->second->first != key)
+            return nullptr;
+
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return &m_lru.front();
+    }
+
+    /* Two keys with the same hash can not be both in memory: the new
+     * result replaces the previous one. */
+    void insert(uint64_t hash, std::string key, std::string buffer)
+    {
+        auto it = m_index.find(hash);
+        if (it != m_index.end()) {
+            m_bytes -= bytes(*it->second);
+            m_lru.erase(it->second);
+            m_index.erase(it);
+        }
+
+        if (m_max_bytes and key.size() + buffer.size() > m_max_bytes)
+            return;
+
+        m_lru.emplace_front(std::move(key), std::move(buffer));
+        m_bytes += bytes(m_lru.front());
+        m_index[hash] = m_lru.begin();
+
+        while ((m_capacity and m_lru.size() > m_capacity) or
+               (m_max_bytes and m_bytes > m_max_bytes)) {
+            m_bytes -= bytes(m_lru.back());
+            m_index.erase(fnv1a(m_lru.back().first));
+            m_lru.pop_back();
+        }
+    }
+};
+
+SimulationCache::SimulationCache(std::size_t capacity,
+                                 std::size_t max_bytes,
+                                 std::string directory)
+  : mPimpl(std::make_unique<SimulationCache::Pimpl>(capacity,
+                                                    max_bytes,
+                                                    std::move(directory)))
+{}
+
+SimulationCache::~SimulationCache() = default;
+
+std::string
+SimulationCache::structureKey(utils::ContextPtr context, const vpz::Vpz& vpz)
+{
+    std::string buffer;
+    vpz::vpz_binary_write_structure(vpz, buffer);
+
+    std::set<std::string> packages;
+    for (const auto& elem : vpz.project().dynamics().dynamiclist())
+        packages.insert(elem.second.package());
+
+    for (const auto& elem :
+         vpz.project().experiment().views().outputs().outputlist())
+        packages.insert(elem.second.package());
+
+    value::BinaryWriter out(buffer);
+    for (const auto& package : packages)
+        write_package_version(context, package, out);
+
+    return buffer;
+}
+
+std::string
+SimulationCache::key(const std::string& structure,
+                     const vpz::Conditions& conditions)
+{
+    std::string buffer;
+    value::BinaryWriter(buffer).writeString(structure);
+    vpz::vpz_binary_write_conditions(conditions, buffer);
+
+    return buffer;
+}
+
+void
+SimulationCache::enable(bool enabled) noexcept
+{
+    std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+    mPimpl->m_enabled = enabled;
+}
+
+bool
+SimulationCache::isEnabled() const noexcept
+{
+    std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+    return mPimpl->m_enabled;
+}
+
+bool
+SimulationCache::get(const std::string& key,
+                     std::unique_ptr<value::Map>* result)
+{
+    const auto hash = fnv1a(key);
+    std::string buffer;
+    bool found = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+        if (not mPimpl->m_enabled)
+            return false;
+
+        if (auto* elem = mPimpl->find(hash, key)) {
+            buffer = elem->second;
+            found = true;
+            mPimpl->m_hits++;
+        } else if (mPimpl->m_directory.empty()) {
+            mPimpl->m_misses++;
+            return false;
+        }
+    }
+
+    /* The file is read without the lock, the other threads use the
+     * memory meanwhile. */
+    if (not found) {
+        found = mPimpl->read_file(key, &buffer);
+
+        std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+        if (not found) {
+            mPimpl->m_misses++;
+            return false;
+        }
+
+        mPimpl->insert(hash, key, buffer);
+        mPimpl->m_hits++;
+    }
+
+    value::BinaryReader in(buffer.data(), buffer.data() + buffer.size());
+    auto value = in.readValue();
+    if (not value or not value->isMap())
+        return false;
+
+    result->reset(static_cast<value::Map*>(value.release()));
+    return true;
+}
+
+void
+SimulationCache::put(const std::string& key, const value::Map& result)
+{
+    std::string buffer;
+    value::BinaryWriter(buffer).writeValue(&result);
+
+    {
+        std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+        if (not mPimpl->m_enabled)
+            return;
+
+        mPimpl->insert(fnv1a(key), key, buffer);
+    }
+
+    if (not mPimpl->m_directory.empty())
+        mPimpl->write_file(key, buffer);
+}
+
+void
+SimulationCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+    mPimpl->m_lru.clear();
+    mPimpl->m_index.clear();
+    mPimpl->m_bytes = 0;
+}
+
+std::size_t
+SimulationCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+    return mPimpl->m_lru.size();
+}
+
+std::size_t
+SimulationCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+    return mPimpl->m_hits;
+}
+
+std::size_t
+SimulationCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(mPimpl->m_mutex);
+    return mPimpl->m_misses;
+}
+}
+} // namespace vle manager
@@ -0,0 +1,476 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/manager/Simulation.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Spawn.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Map.hpp>
+
+#include "manager/SimulationWorker.hpp"
+#include "utils/i18n.hpp"
+#include "vpz/VpzBinary.hpp"
+
+#include <boost/format.hpp>
+
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+namespace vle {
+namespace manager {
+
+#ifndef _WIN32
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+enum class read_status
+{
+    success,
+    end,
+    timeout,
+    failure
+};
+
+bool
+write_all(int fd, const char* data, std::size_t size)
+{
+    while (size) {
+        auto n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 and errno == ENOTSOCK)
+            n = ::write(fd, data, size);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+
+    return true;
+}
+
+read_status
+read_all(int fd, char* data, std::size_t size, clock_type::time_point deadline)
+{
+    while (size) {
+        int wait = -1;
+        if (deadline != clock_type::time_point::max()) {
+            auto remaining =
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - clock_type::now());
+            if (remaining.count() <= 0)
+                return read_status::timeout;
+            wait = static_cast<int>(remaining.count());
+        }
+
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        auto ret = ::poll(&pfd, 1, wait);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return read_status::failure;
+        }
+        if (ret == 0)
+            continue;
+
+        auto n = ::read(fd, data, size);
+        if (n == 0)
+            return read_status::end;
+
+        if (n < 0) {
+            if (errno == EINTR or errno == EAGAIN)
+                continue;
+            return read_status::failure;
+        }
+
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+
+    return read_status::success;
+}
+
+bool
+write_frame(int fd, WorkerMessage type, const std::string& payload)
+{
+    std::string header;
+    value::BinaryWriter out(header);
+    out.writeUint8(static_cast<uint8_t>(type));
+    out.writeUint32(static_cast<uint32_t>(payload.size()));
+
+    return write_all(fd, header.data(), header.size()) and
+           write_all(fd, payload.data(), payload.size());
+}
+
+read_status
+read_frame(int fd,
+           WorkerMessage* type,
+           std::string* payload,
+           clock_type::time_point deadline)
+{
+    char header[5];
+    auto ret = read_all(fd, header, sizeof(header), deadline);
+    if (ret != read_status::success)
+        return ret;
+
+    value::BinaryReader in(header, header + sizeof(header));
+    *type = static_cast<WorkerMessage>(in.readUint8());
+    payload->resize(in.readUint32());
+
+    if (payload->empty())
+        return read_status::success;
+
+    return read_all(fd, &(*payload)[0], payload->size(), deadline);
+}
+
+std::string
+describe_status(int status)
+{
+    if (WIFEXITED(status))
+        return utils::format(_("worker process exited with code %d"),
+                             WEXITSTATUS(status));
+
+    if (WIFSIGNALED(status))
+        return utils::format(_("worker process killed by signal %d"),
+                             WTERMSIG(status));
+
+    return _("worker process failure");
+}
+
+} // anonymous namespace
+
+SimulationWorker::SimulationWorker(utils::ContextPtr context)
+  : m_context(std::move(context))
+  , m_socket(-1)
+  , m_pid(-1)
+{}
+
+SimulationWorker::~SimulationWorker()
+{
+    stop(false);
+}
+
+bool
+SimulationWorker::start(std::string* message)
+{
+    if (isStarted())
+        return true;
+
+    std::vector<std::string> argv;
+    try {
+        std::string command;
+        if (not m_context->get_setting("vle.command.vle.worker", &command))
+            throw utils::ArgError(_("missing vle.command.vle.worker"));
+
+        command =
+          (boost::format(command) % m_context->get_log_priority()).str();
+        utils::Spawn spawn(m_context);
+        argv = spawn.splitCommandLine(command);
+    } catch (const std::exception& e) {
+        *message = e.what();
+        return false;
+    }
+
+    /* Prepare the arguments before the fork: the child only calls async
+     * signal safe functions. */
+    std::vector<char*> args;
+    for (auto& elem : argv)
+        args.emplace_back(&elem[0]);
+    args.emplace_back(nullptr);
+
+    int fds[2];
+    int type = SOCK_STREAM;
+#ifdef SOCK_CLOEXEC
+    type |= SOCK_CLOEXEC;
+#endif
+    if (::socketpair(AF_UNIX, type, 0, fds)) {
+        *message = std::strerror(errno);
+        return false;
+    }
+#ifndef SOCK_CLOEXEC
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    ::setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    pid_t pid = ::fork();
+    if (pid == -1) {
+        *message = std::strerror(errno);
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        ::dup2(fds[1], STDIN_FILENO);
+        ::dup2(fds[1], STDOUT_FILENO);
+        ::execv(args[0], args.data());
+        ::_exit(127);
+    }
+
+    ::close(fds[1]);
+    m_socket = fds[0];
+    m_pid = static_cast<int>(pid);
+
+    return true;
+}
+
+bool
+SimulationWorker::call(WorkerMessage type,
+                       const std::string& payload,
+                       WorkerMessage* answer_type,
+                       std::string* answer,
+                       std::chrono::milliseconds timeout,
+                       std::string* message)
+{
+    if (not isStarted()) {
+        *message = _("worker process not started");
+        return false;
+    }
+
+    auto deadline = timeout == std::chrono::milliseconds::zero()
+                      ? clock_type::time_point::max()
+                      : clock_type::now() + timeout;
+
+    auto ret = write_frame(m_socket, type, payload)
+                 ? read_frame(m_socket, answer_type, answer, deadline)
+                 : read_status::failure;
+
+    if (ret == read_status::success)
+        return true;
+
+    if (ret == read_status::timeout) {
+        m_context->error(_("Simulation worker: timeout, kill process\n"));
+        stop(true);
+        *message = _("simulation timeout");
+    } else {
+        *message = describe_status(stop(true));
+    }
+
+    return false;
+}
+
+int
+SimulationWorker::stop(bool kill)
+{
+    int status = 0;
+    if (not isStarted())
+        return status;
+
+    if (kill)
+        ::kill(m_pid, SIGKILL);
+
+    /* Without input, the worker process stops. */
+    ::close(m_socket);
+
+    while (::waitpid(m_pid, &status, 0) == -1 and errno == EINTR)
+        ;
+
+    m_socket = -1;
+    m_pid = -1;
+
+    return status;
+}
+
+int
+simulation_worker_serve(utils::ContextPtr context)
+{
+    /* The standard input and output are the connection with the parent
+     * process. The models write on the standard error output instead. */
+    int input = ::dup(STDIN_FILENO);
+    int output = ::dup(STDOUT_FILENO);
+    if (input < 0 or output < 0)
+        return EXIT_FAILURE;
+
+    ::dup2(STDERR_FILENO, STDOUT_FILENO);
+    int null = ::open("/dev/null", O_RDONLY);
+    if (null >= 0) {
+        ::dup2(null, STDIN_FILENO);
+        ::close(null);
+    }
+
+    /* The simulation of the last vpz job, built with the warm start option
+     * of the parent process. */
+    std::unique_ptr<Simulation> simulation;
+    vpz::Conditions conditions;
+    vpz::Outputs outputs;
+    WorkerMessage type;
+    std::string job;
+
+    for (;;) {
+        auto ret =
+          read_frame(input, &type, &job, clock_type::time_point::max());
+        if (ret == read_status::end)
+            return EXIT_SUCCESS;
+        if (ret != read_status::success)
+            return EXIT_FAILURE;
+
+        std::string answer;
+        value::BinaryWriter out(answer);
+        Error error;
+
+        try {
+            std::unique_ptr<value::Map> result;
+            value::BinaryReader in(job.data(), job.data() + job.size());
+
+            switch (type) {
+            case WorkerMessage::vpz:
+            case WorkerMessage::warm_vpz: {
+                auto file = std::make_unique<vpz::Vpz>();
+                vpz::vpz_binary_read(
+                  *file, job.data(), job.data() + job.size());
+                conditions = file->project().experiment().conditions();
+                outputs = file->project().experiment().views().outputs();
+                simulation = std::make_unique<Simulation>(
+                  context,
+                  type == WorkerMessage::warm_vpz ? SIMULATION_WARM_START
+                                                  : SIMULATION_NONE,
+                  std::chrono::milliseconds::zero());
+                result = simulation->run(std::move(file), &error);
+                break;
+            }
+            case WorkerMessage::conditions: {
+                auto instance = static_cast<long>(in.readUint64());
+                for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+                    auto name = in.readString();
+                    auto location = in.readString();
+
+                    if (outputs.exist(name))
+                        outputs.get(name).setStreamLocation(location);
+                }
+
+                for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+                    auto name = in.readString();
+                    auto port = in.readString();
+                    std::shared_ptr<value::Value> value = in.readValue();
+
+                    if (not conditions.exist(name))
+                        conditions.add(vpz::Condition(name));
+                    conditions.get(name).setValueToPort(port, value);
+                }
+                if (not simulation)
+                    throw utils::ArgError(
+                      _("Simulation worker: no model to restart"));
+
+                result = simulation->restart(
+                  conditions, outputs, instance, &error);
+                break;
+            }
+            default:
+                throw utils::ArgError(_("Simulation worker: unknown job"));
+            }
+
+            if (not error.code) {
+                out.writeUint8(simulation->isRestartable() ? 1 : 0);
+                out.writeValue(result.get());
+            }
+        } catch (const std::exception& e) {
+            error.code = -1;
+            error.message = e.what();
+        }
+
+        if (error.code) {
+            answer.clear();
+            out.writeString(error.message);
+        }
+
+        if (not write_frame(output,
+                            error.code ? WorkerMessage::error
+                                       : WorkerMessage::result,
+                            answer))
+            return EXIT_FAILURE;
+    }
+}
+
+#else
+
+SimulationWorker::SimulationWorker(utils::ContextPtr context)
+  : m_context(std::move(context))
+  , m_socket(-1)
+  , m_pid(-1)
+{}
+
+SimulationWorker::~SimulationWorker() = default;
+
+bool
+SimulationWorker::start(std::string* message)
+{
+    *message = _("worker process not available on this system");
+    return false;
+}
+
+bool
+SimulationWorker::call(WorkerMessage /*type*/,
+                       const std::string& /*payload*/,
+                       WorkerMessage* /*answer_type*/,
+                       std::string* /*answer*/,
+                       std::chrono::milliseconds /*timeout*/,
+                       std::string* message)
+{
+    *message = _("worker process not available on this system");
+    return false;
+}
+
+int
+SimulationWorker::stop(bool /*kill*/)
+{
+    return 0;
+}
+
+int
+simulation_worker_serve(utils::ContextPtr context)
+{
+    context->error(_("Simulation worker: not available on this system\n"));
+    return EXIT_FAILURE;
+}
+
+#endif
+}
+} // namespace vle manager
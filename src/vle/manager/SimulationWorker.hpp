@@ -0,0 +1,126 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_SIMULATIONWORKER_HPP
+#define VLE_MANAGER_SIMULATIONWORKER_HPP
+
+#include <vle/utils/Context.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @brief Messages exchanged between a @c Simulation and its worker
+ * process. A message is a frame: the type (one byte), the size of the
+ * payload (four bytes, little endian) and the payload, encoded with
+ * @c value::BinaryWriter.
+ */
+enum class WorkerMessage : uint8_t
+{
+    vpz = 'V',        /**< A compiled vpz to load and run. */
+    warm_vpz = 'W',   /**< A compiled vpz to load and run, the models are
+                       * kept for the next conditions jobs
+                       * (@c SIMULATION_WARM_START). */
+    conditions = 'C', /**< The instance of the project, the (output,
+                       * location) pairs and the (condition, port, value)
+                       * overrides to apply to the previous job before
+                       * running the loaded models again. */
+    result = 'R',     /**< A restartable flag and the result map. */
+    error = 'E'       /**< An error message. */
+};
+
+/**
+ * @brief A long-lived `vle --worker` process that runs the simulations of
+ * the @c SIMULATION_SPAWN_PROCESS mode. The process is connected with a
+ * Unix socket to its standard input and output, its standard error output
+ * is the one of the current process.
+ *
+ * If the process crashes or does not answer before the timeout, it is
+ * killed and @c call() fails: @c start() must be called again.
+ */
+class SimulationWorker
+{
+public:
+    SimulationWorker(utils::ContextPtr context);
+
+    SimulationWorker(const SimulationWorker&) = delete;
+    SimulationWorker& operator=(const SimulationWorker&) = delete;
+
+    /**
+     * Close the connection, the process stops at the end of its input.
+     */
+    ~SimulationWorker();
+
+    /**
+     * Start the process with the `vle.command.vle.worker` command.
+     *
+     * @param [out] message the error message.
+     * @return false if the process can not be started.
+     */
+    bool start(std::string* message);
+
+    bool isStarted() const noexcept
+    {
+        return m_pid > 0;
+    }
+
+    /**
+     * Send a job and wait for its answer.
+     *
+     * @param timeout zero to wait without limit.
+     * @param [out] message the error message if the call fails.
+     * @return false if the process crashes or if the timeout expires.
+     */
+    bool call(WorkerMessage type,
+              const std::string& payload,
+              WorkerMessage* answer_type,
+              std::string* answer,
+              std::chrono::milliseconds timeout,
+              std::string* message);
+
+private:
+    /* Close the connection and wait for the end of the process.
+     * @return the status of the process. */
+    int stop(bool kill);
+
+    utils::ContextPtr m_context;
+    int m_socket;
+    int m_pid;
+};
+
+/**
+ * @brief The loop of the worker process, see @c Simulation::serve().
+ */
+int
+simulation_worker_serve(utils::ContextPtr context);
+}
+} // namespace vle manager
+
+#endif
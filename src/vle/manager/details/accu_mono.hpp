@@ -28,6 +28,8 @@
 
 #include <vle/utils/Exception.hpp>
 
+#include "quantile_sketch.hpp"
+
 namespace vle {
 namespace manager {
 
@@ -164,6 +166,9 @@ public:
             mvalues.reset(new std::vector<double>(acc.mvalues->begin(),
                     acc.mvalues->end()));
         }
+        if (acc.msketch) {
+            msketch.reset(new QuantileSketch(*acc.msketch));
+        }
     }
 
     /**
@@ -212,6 +217,32 @@ public:
         return mat;
     }
 
+    /**
+     * @brief use a bounded memory sketch for the QUANTILE storage
+     * instead of storing all the values (see QuantileSketch).
+     * @param error, the expected error on ranks, 0 for exact quantiles
+     */
+    inline void setQuantileError(double error)
+    {
+        if (accu != QUANTILE or error == 0.0 or msketch) {
+            return;
+        }
+        msketch.reset(new QuantileSketch(error));
+        for (double v : *mvalues) {
+            insertIntoSketch(v);
+        }
+        mvalues->clear();
+    }
+
+    /**
+     * @brief check the storage of quantiles
+     * @return true if quantiles are computed with a sketch
+     */
+    inline bool hasQuantileSketch() const
+    {
+        return msketch != nullptr;
+    }
+
     /**
      * @brief Inserts a real into the accumulator
      * @param v the real value
@@ -231,8 +262,12 @@ public:
             mcount++;
             break;
         } case QUANTILE: {
-            mvalues->push_back(v);
-            msorted = false;
+            if (msketch) {
+                insertIntoSketch(v);
+            } else {
+                mvalues->push_back(v);
+                msorted = false;
+            }
             break;
         } case ORDERED: {
             mvalues->push_back(v);
@@ -243,6 +278,58 @@ public:
         }
     }
 
+    /**
+     * @brief Inserts all the values of another accumulator, as if they were
+     * inserted into this accumulator. Sums, counts, min and max are
+     * combined, stored values are appended.
+     * @param acc, an accumulator with the same storage strategy
+     */
+    inline void merge(const AccuMono& acc)
+    {
+        if (acc.accu != accu) {
+            throw vle::utils::ArgError(" [accu_mono] merge of different "
+                    "accumulators");
+        }
+        switch (accu) {
+        case STANDARD: {
+            msum += acc.msum;
+            mcount += acc.mcount;
+            msquareSum += acc.msquareSum;
+            mmin = std::min(acc.mmin, mmin);
+            mmax = std::max(acc.mmax, mmax);
+            break;
+        } case MEAN: {
+            msum += acc.msum;
+            mcount += acc.mcount;
+            break;
+        } case QUANTILE: {
+            if (acc.msketch and not msketch) {
+                setQuantileError(acc.msketch->error());
+            }
+            if (msketch) {
+                if (acc.msketch) {
+                    msketch->merge(*acc.msketch);
+                    msum += acc.msum;
+                    mcount += acc.mcount;
+                    msquareSum += acc.msquareSum;
+                } else {
+                    for (double v : *acc.mvalues) {
+                        insertIntoSketch(v);
+                    }
+                }
+            } else {
+                mvalues->insert(mvalues->end(), acc.mvalues->begin(),
+                        acc.mvalues->end());
+                msorted = false;
+            }
+            break;
+        } case ORDERED: {
+            mvalues->insert(mvalues->end(), acc.mvalues->begin(),
+                    acc.mvalues->end());
+            break;
+        }}
+    }
+
     /**
      * @brief Mean statistic extractor
      * @return the mean value
@@ -256,6 +343,9 @@ public:
             break;
         } case QUANTILE:
           case ORDERED: {
+            if (msketch) {
+                return msum / mcount;
+            }
             double sum = std::accumulate(mvalues->begin(),mvalues->end(),0.0);
             return sum / mvalues->size();
         } default:
@@ -368,6 +458,9 @@ public:
             break;
         case QUANTILE:
         case ORDERED: {
+            if (msketch) {
+                return msquareSum;
+            }
             double squareSum = 0;
             std::vector<double>::const_iterator itb = mvalues->begin();
             std::vector<double>::const_iterator ite = mvalues->end();
@@ -391,6 +484,9 @@ public:
             break;
         case QUANTILE:
         case ORDERED:
+            if (msketch) {
+                return mcount;
+            }
             return mvalues->size();
             break;
         }
@@ -410,6 +506,9 @@ public:
             break;
         case QUANTILE:
         case ORDERED:
+            if (msketch) {
+                return msum;
+            }
             return std::accumulate(mvalues->begin(),mvalues->end(),0.0);
             break;
         }
@@ -497,6 +596,9 @@ public:
             throw vle::utils::ArgError(" [accu_mono] not available");
             break;
         case QUANTILE: {
+            if (msketch) {
+                return msketch->quantile(quantileOrder);
+            }
             if (!msorted) {
                 std::sort(mvalues->begin(),mvalues->end());
                 msorted = true;
@@ -575,9 +677,18 @@ public:
         mmax = std::numeric_limits<double>::min();
         msorted = false;
         mvalues.reset(nullptr);
+        msketch.reset(nullptr);
     }
 
 protected:
+    inline void insertIntoSketch(double v)
+    {
+        msketch->insert(v);
+        msum += v;
+        mcount++;
+        msquareSum += pow(v,2);
+    }
+
     //Type 7 of continuous quantile estimation (see R quantile doc)
     double quantileOnSortedVect(const std::vector<double>& x, double p)
     {
@@ -605,6 +716,7 @@ protected:
     double mmax;
     bool msorted;//true if the vector of values is sorted
     std::unique_ptr<std::vector<double>> mvalues;
+    std::unique_ptr<QuantileSketch> msketch;//bounded QUANTILE storage
     double mquantile; //default value of quantile for stat 'quantile'
     unsigned int mat;//default value of index for stat 'at'
 };
@@ -49,17 +49,18 @@ public:
      * @param  args, common accumulator initialization structure
      */
     AccuMulti(AccuType type) : accu(type),
-        init_size(false), mstats()
+        init_size(false), mquantileError(0), mstats()
     {
     }
     AccuMulti(AccuStat s) : accu(),
-        init_size(false), mstats()
+        init_size(false), mquantileError(0), mstats()
     {
         accu = AccuMono::storageTypeForStat(s);
     }
 
     AccuMulti(const AccuMulti& acc) : accu(acc.accu),
-        init_size(acc.init_size), mstats(acc.mstats.begin(), acc.mstats.end())
+        init_size(acc.init_size), mquantileError(acc.mquantileError),
+        mstats(acc.mstats.begin(), acc.mstats.end())
     {
     }
 
@@ -97,6 +98,7 @@ public:
             AccuMono& s = mstats[i];
             s.setDefaultQuantile(quantile);
             s.setDefaultAtIndex(at_index);
+            s.setQuantileError(mquantileError);
         }
     }
 
@@ -112,9 +114,23 @@ public:
             a.setDefaultAtIndex(at_index);
         }
     }
+    /**
+     * @brief use bounded memory sketches for QUANTILE storage
+     * @param error, the expected error on ranks, 0 for exact quantiles
+     */
+    inline void setQuantileError(double error)
+    {
+        mquantileError = error;
+        for (AccuMono& a : mstats){
+            a.setQuantileError(error);
+        }
+    }
 
     void insertAccuStat(AccuMulti& a, AccuStat s)
     {
+        if (size() == 0) {
+            setSize(a.size());
+        }
         if (a.size() != size()) {
             throw vle::utils::ArgError(" [accu_multi] error size ");
         }
@@ -147,6 +163,32 @@ public:
         }
     }
 
+    /**
+     * @brief Inserts all the values of another accumulator
+     * @param a, an accumulator with the same storage strategy and either
+     * the same size or empty
+     */
+    void merge(const AccuMulti& a)
+    {
+        if (a.size() == 0) {
+            return;
+        }
+        if (size() == 0) {
+            for (const AccuMono& s : a.mstats) {
+                mstats.emplace_back(s);
+                mstats.back().setDefaultQuantile(s.defaultQuantile());
+                mstats.back().setDefaultAtIndex(s.defaultAtIntex());
+            }
+            return;
+        }
+        if (a.size() != size()) {
+            throw vle::utils::ArgError(" [accu_multi] error size ");
+        }
+        for (unsigned int i=0; i < a.size() ; i++) {
+            mstats[i].merge(a.mstats[i]);
+        }
+    }
+
     /**
      * @brief generic get Stat
      * @param res[out], tuple filled with stat of all Accu
@@ -215,12 +257,16 @@ public:
      */
     inline unsigned int count()
     {
+        if (mstats.empty()) {
+            return 0;
+        }
         return mstats[0].count();
     }
 
 private:
     AccuType accu;
     bool init_size;
+    double mquantileError;
     std::vector<AccuMono> mstats;
 };
 
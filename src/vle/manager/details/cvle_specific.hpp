@@ -264,7 +264,7 @@ cvle_read_Matrix(std::ifstream& outFile, std::string& line,
 std::unique_ptr<value::Map>
 cvle_read(const utils::Path& tempOutCsv, unsigned int inputSize,
         unsigned int repSize, std::vector<std::unique_ptr<ManOutput>>& outputs,
-        manager::Error& err)
+        PlanSink* sink, manager::Error& err)
 {
     std::unique_ptr<value::Map> results = init_results(outputs, err);
     if (err.code) {
@@ -292,6 +292,7 @@ cvle_read(const utils::Path& tempOutCsv, unsigned int inputSize,
             break;
         }
         finishViews = false;
+        std::unique_ptr<value::Map> simResult(new value::Map());
         while(not finishViews){
             //read view:viewName
             if (not cvle_read_ViewHeader(outFile, line, tokens, viewName)) {
@@ -311,6 +312,10 @@ cvle_read(const utils::Path& tempOutCsv, unsigned int inputSize,
             if (not getInsight) {
                 insightsViewRows[viewName] = viewMatrix->rows();
             }
+            if (sink) {
+                simResult->add(viewName, std::move(viewMatrix));
+                continue;
+            }
             //insert replicate for
             std::unique_ptr<value::Value> aggrValue;
             for (unsigned int o=0; o< outputs.size(); o++) {
@@ -330,6 +335,21 @@ cvle_read(const utils::Path& tempOutCsv, unsigned int inputSize,
                 }
             }
         }
+        if (sink) {
+            try {
+                std::unique_ptr<value::Map> simOutputs(new value::Map());
+                for (auto& out : outputs) {
+                    simOutputs->add(out->id, out->extract(*simResult));
+                }
+                sink->write(inputId, inputRepl, std::move(simOutputs));
+            } catch (const std::exception& e) {
+                err.code = -1;
+                err.message = "[Manager] ";
+                err.message += vle::utils::format("Error in simu id=%d, "
+                        "repl=%d : %s", inputId, inputRepl, e.what());
+                return nullptr;
+            }
+        }
         nbSimus ++;
     }
     if (nbSimus != inputSize*repSize) {
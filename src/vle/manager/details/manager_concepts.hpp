@@ -163,9 +163,48 @@ public:
 
     virtual ~DelegateOut() {}
 
+    /**
+     * @brief insert a replicate and get the aggregated value if all
+     * inputs and all replicates have been inserted.
+     */
+    std::unique_ptr<vle::value::Value>
+    insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+    {
+        insert(outMat, currInput);
+        if (complete()) {
+            return finish();
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief insert a replicate without building the aggregated value
+     */
+    virtual void
+    insert(vle::value::Matrix& outMat, unsigned int currInput) = 0;
+
+    /**
+     * @brief move the replicates inserted into @c other (a delegate of the
+     * same type) into this delegate.
+     */
+    virtual void merge(DelegateOut& other) = 0;
+
+    /**
+     * @return true if all inputs and all replicates have been inserted.
+     */
+    virtual bool complete() const = 0;
+
+    /**
+     * @brief aggregate the replicates of the inputs which are not
+     * complete, for the inputs stopped before the last replicate (see
+     * @c replicate_stopping).
+     */
+    virtual void closeReplicates() = 0;
 
-    virtual std::unique_ptr<vle::value::Value>
-    insertReplicate(vle::value::Matrix& outMat, unsigned int currInput) = 0;
+    /**
+     * @brief build the aggregated value, available once.
+     */
+    virtual std::unique_ptr<vle::value::Value> finish() = 0;
 
     /**
      * Temporal integration, shared with other delegates
@@ -184,6 +223,13 @@ public:
     static AccuMono& getAccu(std::map<int, std::unique_ptr<AccuMono>>& accu,
             unsigned int index, const ManOutput& vleout);
 
+    /**
+     * Copy the columns of the filled inputs of a Table or a Matrix of
+     * aggregated values into another one, shared with 'all' delegates.
+     */
+    static void mergeInputs(value::Value& to, value::Value& from,
+            const std::vector<unsigned int>& inputs, bool managedouble);
+
 
     ManOutput& vleOut;
     bool manageDouble;
@@ -197,8 +243,11 @@ class DelOutStd : public DelegateOut
 public:
     DelOutStd(ManOutput& vleout);
 
-    std::unique_ptr<vle::value::Value> insertReplicate(
-            vle::value::Matrix& outMat, unsigned int currInput) override;
+    void insert(vle::value::Matrix& outMat, unsigned int currInput) override;
+    void merge(DelegateOut& other) override;
+    bool complete() const override;
+    void closeReplicates() override;
+    std::unique_ptr<vle::value::Value> finish() override;
 
     //for replicate aggregation for current input index
     std::map<int, std::unique_ptr<AccuMono>> mreplicateAccu;
@@ -213,13 +262,16 @@ class DelOutIntAggrALL : public DelegateOut
 public:
     DelOutIntAggrALL(ManOutput& vleout, bool managedouble);
 
-    std::unique_ptr<vle::value::Value> insertReplicate(
-            vle::value::Matrix& outMat, unsigned int currInput) override;
+    void insert(vle::value::Matrix& outMat, unsigned int currInput) override;
+    void merge(DelegateOut& other) override;
+    bool complete() const override;
+    void closeReplicates() override;
+    std::unique_ptr<vle::value::Value> finish() override;
 
     //for replicate aggregation for current input index
     std::map<int, std::unique_ptr<AccuMulti>> mreplicateAccu;
     std::unique_ptr<value::Value> minputAccu;
-    unsigned int nbInputsFilled;
+    std::vector<unsigned int> inputsFilled;
 };
 
 /**
@@ -230,8 +282,11 @@ class DelOutIntALL : public DelegateOut
 public:
     DelOutIntALL(ManOutput& vleout);
 
-    std::unique_ptr<vle::value::Value> insertReplicate(
-            vle::value::Matrix& outMat, unsigned int currInput) override;
+    void insert(vle::value::Matrix& outMat, unsigned int currInput) override;
+    void merge(DelegateOut& other) override;
+    bool complete() const override;
+    void closeReplicates() override;
+    std::unique_ptr<vle::value::Value> finish() override;
 
     //for replicate aggregation for current input index
     std::map<int, std::unique_ptr<AccuMulti>> mreplicateAccu;
@@ -246,13 +301,16 @@ class DelOutAggrALL : public DelegateOut
 public:
     DelOutAggrALL(ManOutput& vleout, bool managedouble);
 
-    std::unique_ptr<vle::value::Value> insertReplicate(
-            vle::value::Matrix& outMat, unsigned int currInput) override;
+    void insert(vle::value::Matrix& outMat, unsigned int currInput) override;
+    void merge(DelegateOut& other) override;
+    bool complete() const override;
+    void closeReplicates() override;
+    std::unique_ptr<vle::value::Value> finish() override;
 
     //for replicate aggregation for current input index
     std::map<int, std::unique_ptr<AccuMono>> mreplicateAccu;
     std::unique_ptr<value::Value> minputAccu;
-    unsigned int nbInputsFilled;
+    std::vector<unsigned int> inputsFilled;
 };
 
 /**
@@ -308,6 +366,60 @@ public:
     insertReplicate(vle::value::Matrix& outMat, unsigned int currInput,
             unsigned int nbIn, unsigned int nbRepl);
 
+    /**
+     * @brief insert a replicate from a map of views without building the
+     * aggregated value, see @c merge and @c finish.
+     * @param result, one simulation result (map of views)
+     * @param currInput, current input index
+     * @param nbInputs, nb inputs of the experiment plan (for allocation)
+     * @param nbReplicates, nb replicates of the experiment plan
+     */
+    void accumulate(value::Map& result, unsigned int currInput,
+            unsigned int nbInputs, unsigned int nbReplicates);
+
+    /**
+     * @brief move the replicates inserted into @c other, a clone of this
+     * output, into this output.
+     * @param other, the output to empty
+     */
+    void merge(ManOutput& other);
+
+    /**
+     * @brief build the aggregated value
+     * @return the input aggregated value if all inputs and all replicates
+     * have aggregated, nullptr otherwise
+     */
+    std::unique_ptr<value::Value> finish();
+
+    /**
+     * @brief aggregate the replicates of the inputs stopped before the
+     * last replicate, see @c DelegateOut::closeReplicates.
+     */
+    void closeReplicates();
+
+    /**
+     * @brief copy the configuration of the output without the inserted
+     * replicates, to aggregate a part of the experiment plan.
+     */
+    std::unique_ptr<ManOutput> clone() const;
+
+    /**
+     * @brief get the temporal integration of the output for one
+     * simulation, without aggregation
+     * @param result, one simulation result (map of views)
+     * @return the integrated value, or the complete series for the
+     * integration 'all'
+     */
+    std::unique_ptr<value::Value> extract(value::Map& result);
+
+    /**
+     * @brief get the temporal integration of the output for one
+     * simulation as a real, without modifying the simulation result, for
+     * the stopping rule of the replicates.
+     * @param result, one simulation result (map of views)
+     */
+    double observe(value::Map& result);
+
     bool parsePath(const std::string& path);
 
     std::string id;
@@ -326,6 +438,23 @@ public:
     std::unique_ptr<vle::value::Tuple> mse_observations;
     //optionnal for aggregate_replicate = "quantile"
     double replicateAggregationQuantile;
+    //optionnal for quantile aggregations, 0 for exact quantiles
+    double quantileError;
+    //optionnal stopping rule of the replicates, 0 to run all replicates:
+    //the half width of the confidence interval of the mean of replicates
+    double stopTolerance;
+    double stopConfidence;
+    unsigned int stopMinReplicates;
+
+private:
+    vle::value::Matrix& getView(value::Map& result);
+
+    void findColumn(const vle::value::Matrix& outMat);
+
+    DelegateOut& getDelegate(vle::value::Matrix& outMat, unsigned int nbIn,
+            unsigned int nbRepl);
+
+    void buildDelegate(bool manageDouble);
 };
 
 struct ManOutputSorter
@@ -346,6 +475,8 @@ struct ManagerObjects
     std::vector<std::unique_ptr<ManReplicate>> mReplicates;
     //view/path_to_atomic.port
     std::vector<std::unique_ptr<ManOutput>> mOutputs;
+    //expected cost of the simulations of each input (cost_hint)
+    std::vector<double> mCostHint;
 
     unsigned int inputsSize() const
     {
@@ -778,6 +909,7 @@ DelegateOut::getAccu(std::map<int, std::unique_ptr<AccuMulti>>& accus,
             vleout.replicateAggregationType));
     AccuMulti& ref = *ptr;
     ref.setDefaultQuantile(vleout.replicateAggregationQuantile);
+    ref.setQuantileError(vleout.quantileError);
     accus.insert(std::make_pair(index, std::move(ptr)));
     return ref;
 }
@@ -795,18 +927,49 @@ DelegateOut::getAccu(std::map<int, std::unique_ptr<AccuMono>>& accu,
             vleout.replicateAggregationType));
     AccuMono& ref = *ptr;
     ref.setDefaultQuantile(vleout.replicateAggregationQuantile);
+    ref.setQuantileError(vleout.quantileError);
     accu.insert(std::make_pair(index, std::move(ptr)));
     return ref;
 }
 
+void
+DelegateOut::mergeInputs(value::Value& to, value::Value& from,
+        const std::vector<unsigned int>& inputs, bool managedouble)
+{
+    if (managedouble) {
+        value::Table& tableTo = to.toTable();
+        value::Table& tableFrom = from.toTable();
+        if (tableTo.height() < tableFrom.height()) {
+            tableTo.resize(tableTo.width(), tableFrom.height());
+        }
+        for (unsigned int in : inputs) {
+            for (unsigned int i=0; i < tableFrom.height(); i++) {
+                tableTo.get(in, i) = tableFrom.get(in, i);
+            }
+        }
+    } else {
+        value::Matrix& matTo = to.toMatrix();
+        value::Matrix& matFrom = from.toMatrix();
+        if (matTo.rows() < matFrom.rows()) {
+            matTo.resize(matTo.columns(), matFrom.rows());
+        }
+        for (unsigned int in : inputs) {
+            for (unsigned int i=0; i < matFrom.rows(); i++) {
+                matTo.set(in, i, std::move(matFrom.give(in, i)));
+            }
+        }
+    }
+}
+
 DelOutStd::DelOutStd(ManOutput& vleout) : DelegateOut(vleout, true)
 {
     minputAccu.reset(new AccuMono(vleOut.inputAggregationType));
+    minputAccu->setQuantileError(vleOut.quantileError);
 }
 
 
-std::unique_ptr<vle::value::Value>
-DelOutStd::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+void
+DelOutStd::insert(vle::value::Matrix& outMat, unsigned int currInput)
 {
     //start insertion for double management only
     std::unique_ptr<value::Value> intVal = std::move(
@@ -825,23 +988,63 @@ DelOutStd::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
 
         }
     }
-    //test if aggregating inputs is finished
-    if (minputAccu->count() == vleOut.nbInputs) {
-        double res = minputAccu->getStat(vleOut.inputAggregationType);
-        minputAccu.reset(nullptr);
-        return value::Double::create(res);
+}
+
+void
+DelOutStd::merge(DelegateOut& other)
+{
+    DelOutStd& del = dynamic_cast<DelOutStd&>(other);
+    for (auto& repl : del.mreplicateAccu) {
+        AccuMono& accuRepl = DelegateOut::getAccu(mreplicateAccu, repl.first,
+                vleOut);
+        accuRepl.merge(*repl.second);
+        if (accuRepl.count() == vleOut.nbReplicates) {
+            minputAccu->insert(accuRepl.getStat(
+                    vleOut.replicateAggregationType));
+            mreplicateAccu.erase(repl.first);
+        }
+    }
+    del.mreplicateAccu.clear();
+    minputAccu->merge(*del.minputAccu);
+    del.minputAccu.reset(new AccuMono(vleOut.inputAggregationType));
+    del.minputAccu->setQuantileError(vleOut.quantileError);
+}
+
+void
+DelOutStd::closeReplicates()
+{
+    for (auto& repl : mreplicateAccu) {
+        minputAccu->insert(repl.second->getStat(
+                vleOut.replicateAggregationType));
     }
-    return nullptr;
+    mreplicateAccu.clear();
+}
+
+bool
+DelOutStd::complete() const
+{
+    return minputAccu and minputAccu->count() == vleOut.nbInputs;
+}
+
+std::unique_ptr<vle::value::Value>
+DelOutStd::finish()
+{
+    if (not complete()) {
+        return nullptr;
+    }
+    double res = minputAccu->getStat(vleOut.inputAggregationType);
+    minputAccu.reset(nullptr);
+    return value::Double::create(res);
 }
 
 DelOutIntAggrALL::DelOutIntAggrALL(ManOutput& vleout, bool managedouble):
         DelegateOut(vleout, managedouble), mreplicateAccu(),
-        minputAccu(nullptr), nbInputsFilled(0)
+        minputAccu(nullptr), inputsFilled()
 {
 }
 
-std::unique_ptr<vle::value::Value>
-DelOutIntAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+void
+DelOutIntAggrALL::insert(vle::value::Matrix& outMat, unsigned int currInput)
 {
     if (not minputAccu) {
         if (manageDouble) {
@@ -876,7 +1079,7 @@ DelOutIntAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currI
                         std::move(outMat.give(vleOut.colIndex, i)));
             }
         }
-        nbInputsFilled++;
+        inputsFilled.push_back(currInput);
     } else {
         AccuMulti& accuRepl = DelegateOut::getAccu(mreplicateAccu, currInput,
                 vleOut);
@@ -885,13 +1088,67 @@ DelOutIntAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currI
             accuRepl.fillStat(minputAccu->toTable(),
                     currInput, vleOut.replicateAggregationType);
             mreplicateAccu.erase(currInput);
-            nbInputsFilled++;
+            inputsFilled.push_back(currInput);
         }
     }
-    if (nbInputsFilled == vleOut.nbInputs) {
-        return std::move(minputAccu);
+}
+
+void
+DelOutIntAggrALL::merge(DelegateOut& other)
+{
+    DelOutIntAggrALL& del = dynamic_cast<DelOutIntAggrALL&>(other);
+    if (not del.minputAccu) {
+        return;
     }
-    return nullptr;
+    if (not minputAccu) {
+        minputAccu = std::move(del.minputAccu);
+        inputsFilled = std::move(del.inputsFilled);
+    } else {
+        mergeInputs(*minputAccu, *del.minputAccu, del.inputsFilled,
+                manageDouble);
+        inputsFilled.insert(inputsFilled.end(), del.inputsFilled.begin(),
+                del.inputsFilled.end());
+        del.minputAccu.reset(nullptr);
+    }
+    del.inputsFilled.clear();
+    for (auto& repl : del.mreplicateAccu) {
+        AccuMulti& accuRepl = DelegateOut::getAccu(mreplicateAccu, repl.first,
+                vleOut);
+        accuRepl.merge(*repl.second);
+        if (accuRepl.count() == vleOut.nbReplicates) {
+            accuRepl.fillStat(minputAccu->toTable(),
+                    repl.first, vleOut.replicateAggregationType);
+            mreplicateAccu.erase(repl.first);
+            inputsFilled.push_back(repl.first);
+        }
+    }
+    del.mreplicateAccu.clear();
+}
+
+void
+DelOutIntAggrALL::closeReplicates()
+{
+    for (auto& repl : mreplicateAccu) {
+        repl.second->fillStat(minputAccu->toTable(),
+                repl.first, vleOut.replicateAggregationType);
+        inputsFilled.push_back(repl.first);
+    }
+    mreplicateAccu.clear();
+}
+
+bool
+DelOutIntAggrALL::complete() const
+{
+    return minputAccu and inputsFilled.size() == vleOut.nbInputs;
+}
+
+std::unique_ptr<vle::value::Value>
+DelOutIntAggrALL::finish()
+{
+    if (not complete()) {
+        return nullptr;
+    }
+    return std::move(minputAccu);
 }
 
 DelOutIntALL::DelOutIntALL(ManOutput& vleout): DelegateOut(vleout, true),
@@ -899,11 +1156,12 @@ DelOutIntALL::DelOutIntALL(ManOutput& vleout): DelegateOut(vleout, true),
 {
 }
 
-std::unique_ptr<vle::value::Value>
-DelOutIntALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+void
+DelOutIntALL::insert(vle::value::Matrix& outMat, unsigned int currInput)
 {
     if (not minputAccu) {
         minputAccu.reset(new AccuMulti(vleOut.inputAggregationType));
+        minputAccu->setQuantileError(vleOut.quantileError);
     }
     if (vleOut.nbReplicates == 1){//one can put directly into results
         minputAccu->insertColumn(outMat, vleOut.colIndex);
@@ -917,18 +1175,66 @@ DelOutIntALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput
             mreplicateAccu.erase(currInput);
         }
     }
-    if (minputAccu->count() == vleOut.nbInputs) {
-        std::unique_ptr<value::Table> res(new value::Table(1,
-                minputAccu->size()));
-        minputAccu->fillStat(*res, 0, vleOut.inputAggregationType);
-        return std::move(res);
+}
+
+void
+DelOutIntALL::merge(DelegateOut& other)
+{
+    DelOutIntALL& del = dynamic_cast<DelOutIntALL&>(other);
+    if (not del.minputAccu) {
+        return;
     }
-    return nullptr;
+    if (not minputAccu) {
+        minputAccu.reset(new AccuMulti(vleOut.inputAggregationType));
+        minputAccu->setQuantileError(vleOut.quantileError);
+    }
+    minputAccu->merge(*del.minputAccu);
+    del.minputAccu.reset(nullptr);
+    for (auto& repl : del.mreplicateAccu) {
+        AccuMulti& accuRepl = DelegateOut::getAccu(mreplicateAccu, repl.first,
+                vleOut);
+        accuRepl.merge(*repl.second);
+        if (accuRepl.count() == vleOut.nbReplicates) {
+            minputAccu->insertAccuStat(accuRepl,
+                    vleOut.replicateAggregationType);
+            mreplicateAccu.erase(repl.first);
+        }
+    }
+    del.mreplicateAccu.clear();
+}
+
+void
+DelOutIntALL::closeReplicates()
+{
+    for (auto& repl : mreplicateAccu) {
+        minputAccu->insertAccuStat(*repl.second,
+                vleOut.replicateAggregationType);
+    }
+    mreplicateAccu.clear();
+}
+
+bool
+DelOutIntALL::complete() const
+{
+    return minputAccu and minputAccu->count() == vleOut.nbInputs;
+}
+
+std::unique_ptr<vle::value::Value>
+DelOutIntALL::finish()
+{
+    if (not complete()) {
+        return nullptr;
+    }
+    std::unique_ptr<value::Table> res(new value::Table(1,
+            minputAccu->size()));
+    minputAccu->fillStat(*res, 0, vleOut.inputAggregationType);
+    minputAccu.reset(nullptr);
+    return std::move(res);
 }
 
 DelOutAggrALL::DelOutAggrALL(ManOutput& vleout, bool managedouble):
         DelegateOut(vleout, managedouble), mreplicateAccu(),
-        minputAccu(nullptr), nbInputsFilled(0)
+        minputAccu(nullptr), inputsFilled()
 {
     if (manageDouble) {
         minputAccu.reset(new value::Table(vleOut.nbInputs,1));
@@ -937,8 +1243,8 @@ DelOutAggrALL::DelOutAggrALL(ManOutput& vleout, bool managedouble):
     }
 }
 
-std::unique_ptr<vle::value::Value>
-DelOutAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput)
+void
+DelOutAggrALL::insert(vle::value::Matrix& outMat, unsigned int currInput)
 {
     std::unique_ptr<value::Value> intVal = std::move(
             integrateReplicate(vleOut, outMat));
@@ -952,7 +1258,7 @@ DelOutAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInpu
 
         }
 
-        nbInputsFilled++;
+        inputsFilled.push_back(currInput);
     } else {
         AccuMono& accuRepl = DelegateOut::getAccu(mreplicateAccu, currInput,
                 vleOut);
@@ -961,13 +1267,58 @@ DelOutAggrALL::insertReplicate(vle::value::Matrix& outMat, unsigned int currInpu
             minputAccu->toTable().get(currInput, 0)=
                     accuRepl.getStat(vleOut.replicateAggregationType);
             mreplicateAccu.erase(currInput);
-            nbInputsFilled++;
+            inputsFilled.push_back(currInput);
         }
     }
-    if (nbInputsFilled == vleOut.nbInputs) {
-        return std::move(minputAccu);
+}
+
+void
+DelOutAggrALL::merge(DelegateOut& other)
+{
+    DelOutAggrALL& del = dynamic_cast<DelOutAggrALL&>(other);
+    mergeInputs(*minputAccu, *del.minputAccu, del.inputsFilled,
+            manageDouble);
+    inputsFilled.insert(inputsFilled.end(), del.inputsFilled.begin(),
+            del.inputsFilled.end());
+    del.inputsFilled.clear();
+    for (auto& repl : del.mreplicateAccu) {
+        AccuMono& accuRepl = DelegateOut::getAccu(mreplicateAccu, repl.first,
+                vleOut);
+        accuRepl.merge(*repl.second);
+        if (accuRepl.count() == vleOut.nbReplicates) {
+            minputAccu->toTable().get(repl.first, 0)=
+                    accuRepl.getStat(vleOut.replicateAggregationType);
+            mreplicateAccu.erase(repl.first);
+            inputsFilled.push_back(repl.first);
+        }
     }
-    return nullptr;
+    del.mreplicateAccu.clear();
+}
+
+void
+DelOutAggrALL::closeReplicates()
+{
+    for (auto& repl : mreplicateAccu) {
+        minputAccu->toTable().get(repl.first, 0)=
+                repl.second->getStat(vleOut.replicateAggregationType);
+        inputsFilled.push_back(repl.first);
+    }
+    mreplicateAccu.clear();
+}
+
+bool
+DelOutAggrALL::complete() const
+{
+    return minputAccu and inputsFilled.size() == vleOut.nbInputs;
+}
+
+std::unique_ptr<vle::value::Value>
+DelOutAggrALL::finish()
+{
+    if (not complete()) {
+        return nullptr;
+    }
+    return std::move(minputAccu);
 }
 
 
@@ -975,7 +1326,8 @@ ManOutput::ManOutput() : id(), view(), absolutePort(), colIndex(-1),
         shared(true), integrationType(LAST), replicateAggregationType(S_mean),
         inputAggregationType(S_at), nbInputs(0), nbReplicates(0),
         delegate(nullptr), mse_times(nullptr), mse_observations(nullptr),
-        replicateAggregationQuantile(0.5)
+        replicateAggregationQuantile(0.5), quantileError(0),
+        stopTolerance(0), stopConfidence(0.95), stopMinReplicates(3)
 {
 }
 
@@ -984,7 +1336,8 @@ ManOutput::ManOutput(const std::string& _id, const vle::value::Value& val) :
         integrationType(LAST), replicateAggregationType(S_mean),
         inputAggregationType(S_at), nbInputs(0), nbReplicates(0),
         delegate(nullptr), mse_times(nullptr), mse_observations(nullptr),
-        replicateAggregationQuantile(0.5)
+        replicateAggregationQuantile(0.5), quantileError(0),
+        stopTolerance(0), stopConfidence(0.95), stopMinReplicates(3)
 {
     std::string tmp;
     if (val.isString()) {
@@ -1038,6 +1391,15 @@ ManOutput::ManOutput(const std::string& _id, const vle::value::Value& val) :
                         "output_",  id.c_str()));
             }
         }
+        if (m.exist("quantile_error")) {
+            quantileError = m.getDouble("quantile_error");
+            if (not (quantileError > 0 and quantileError < 1)) {
+                throw utils::ArgError(utils::format(
+                        "[Manager] : error in configuration of the output "
+                        "'%s%s', the quantile_error must be in ]0, 1[",
+                        "output_",  id.c_str()));
+            }
+        }
         if (not error) {
             if (m.exist("integration")) {
                 tmp = m.getString("integration");
@@ -1078,6 +1440,24 @@ ManOutput::ManOutput(const std::string& _id, const vle::value::Value& val) :
                     "'%s%s' with a map",
                     "output_",  id.c_str()));
         }
+        if (m.exist("stop_tolerance")) {
+            stopTolerance = m.getDouble("stop_tolerance");
+            if (m.exist("stop_confidence")) {
+                stopConfidence = m.getDouble("stop_confidence");
+            }
+            if (m.exist("stop_min_replicates")) {
+                stopMinReplicates = std::max(2,
+                        m.getInt("stop_min_replicates"));
+            }
+            if (not (stopTolerance > 0) or integrationType == ALL or
+                    not (stopConfidence > 0 and stopConfidence < 1)) {
+                throw utils::ArgError(utils::format(
+                        "[Manager] : error in configuration of the output "
+                        "'%s%s', the stop_tolerance must be positive, the "
+                        "stop_confidence in ]0, 1[ and the integration "
+                        "not 'all'", "output_",  id.c_str()));
+            }
+        }
     }
 }
 
@@ -1128,6 +1508,124 @@ std::unique_ptr<value::Value>
 ManOutput::insertReplicate(value::Map& result,
         unsigned int currInput, unsigned int nbInputs,
         unsigned int nbReplicates)
+{
+    return insertReplicate(getView(result), currInput, nbInputs,
+            nbReplicates);
+}
+
+
+std::unique_ptr<value::Value>
+ManOutput::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput,
+        unsigned int nbIn, unsigned int nbRepl)
+{
+    return getDelegate(outMat, nbIn, nbRepl).insertReplicate(outMat,
+            currInput);
+}
+
+void
+ManOutput::accumulate(value::Map& result, unsigned int currInput,
+        unsigned int nbIn, unsigned int nbRepl)
+{
+    value::Matrix& outMat = getView(result);
+    getDelegate(outMat, nbIn, nbRepl).insert(outMat, currInput);
+}
+
+void
+ManOutput::merge(ManOutput& other)
+{
+    if (not other.delegate) {
+        return;
+    }
+    if (not delegate) {
+        nbReplicates = other.nbReplicates;
+        nbInputs = other.nbInputs;
+        colIndex = other.colIndex;
+        buildDelegate(other.delegate->manageDouble);
+    }
+    delegate->merge(*other.delegate);
+}
+
+std::unique_ptr<value::Value>
+ManOutput::finish()
+{
+    if (not delegate) {
+        return nullptr;
+    }
+    return delegate->finish();
+}
+
+void
+ManOutput::closeReplicates()
+{
+    if (delegate) {
+        delegate->closeReplicates();
+    }
+}
+
+std::unique_ptr<ManOutput>
+ManOutput::clone() const
+{
+    std::unique_ptr<ManOutput> ret(new ManOutput());
+    ret->id = id;
+    ret->view = view;
+    ret->absolutePort = absolutePort;
+    ret->shared = shared;
+    ret->integrationType = integrationType;
+    ret->replicateAggregationType = replicateAggregationType;
+    ret->inputAggregationType = inputAggregationType;
+    if (mse_times) {
+        ret->mse_times.reset(new value::Tuple(*mse_times));
+    }
+    if (mse_observations) {
+        ret->mse_observations.reset(new value::Tuple(*mse_observations));
+    }
+    ret->replicateAggregationQuantile = replicateAggregationQuantile;
+    ret->quantileError = quantileError;
+    ret->stopTolerance = stopTolerance;
+    ret->stopConfidence = stopConfidence;
+    ret->stopMinReplicates = stopMinReplicates;
+    return ret;
+}
+
+std::unique_ptr<value::Value>
+ManOutput::extract(value::Map& result)
+{
+    value::Matrix& outMat = getView(result);
+    findColumn(outMat);
+    if (integrationType != ALL) {
+        return DelegateOut::integrateReplicate(*this, outMat);
+    }
+    if (outMat.get(colIndex,1)->isDouble()) {
+        std::unique_ptr<value::Tuple> res(new value::Tuple(outMat.rows()-1));
+        for (unsigned int i=1; i < outMat.rows(); i++) {
+            (*res)[i-1] = outMat.getDouble(colIndex, i);
+        }
+        return std::move(res);
+    }
+    std::unique_ptr<value::Set> res(new value::Set());
+    for (unsigned int i=1; i < outMat.rows(); i++) {
+        if (shared) {
+            res->add(outMat.get(colIndex, i)->clone());
+        } else {
+            res->add(std::move(outMat.give(colIndex, i)));
+        }
+    }
+    return std::move(res);
+}
+
+double
+ManOutput::observe(value::Map& result)
+{
+    value::Matrix& outMat = getView(result);
+    findColumn(outMat);
+    if (integrationType == LAST) {
+        return outMat.getDouble(colIndex, outMat.rows() - 1);
+    }
+    return DelegateOut::integrateReplicate(*this, outMat)->toDouble().value();
+}
+
+vle::value::Matrix&
+ManOutput::getView(value::Map& result)
 {
     value::Map::iterator it = result.find(view);
     if (it == result.end()) {
@@ -1135,34 +1633,38 @@ ManOutput::insertReplicate(value::Map& result,
                 "[Manager] view '%s' not found)",
                 view.c_str()));
     }
-    value::Matrix& outMat = value::toMatrixValue(*it->second);
-    return insertReplicate(outMat, currInput, nbInputs, nbReplicates);
+    return value::toMatrixValue(*it->second);
 }
 
+void
+ManOutput::findColumn(const vle::value::Matrix& outMat)
+{
+    //performs some checks on output matrix
+    if (outMat.rows() < 2){
+        throw vu::ArgError("[Manager] expect at least 2 rows");
+    }
+    //get col index
+    colIndex = 9999;
+    for (unsigned int i=0; i < outMat.columns(); i++) {
+        if (outMat.getString(i,0) == absolutePort) {
+            colIndex = i;
+        }
+    }
+    if (colIndex == 9999) {
+        throw vu::ArgError(utils::format(
+                "[Manager] view.port '%s' not found)",
+                absolutePort.c_str()));
+    }
+}
 
-std::unique_ptr<value::Value>
-ManOutput::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput,
-        unsigned int nbIn, unsigned int nbRepl)
+DelegateOut&
+ManOutput::getDelegate(vle::value::Matrix& outMat, unsigned int nbIn,
+        unsigned int nbRepl)
 {
     if (not delegate){
         nbReplicates = nbRepl;
         nbInputs = nbIn;
-        //performs some checks on output matrix
-        if (outMat.rows() < 2){
-            throw vu::ArgError("[Manager] expect at least 2 rows");
-        }
-        //get col index
-        colIndex = 9999;
-        for (unsigned int i=0; i < outMat.columns(); i++) {
-            if (outMat.getString(i,0) == absolutePort) {
-                colIndex = i;
-            }
-        }
-        if (colIndex == 9999) {
-            throw vu::ArgError(utils::format(
-                    "[Manager] view.port '%s' not found)",
-                    absolutePort.c_str()));
-        }
+        findColumn(outMat);
         bool manageDouble = true;
         if (not outMat.get(colIndex,1)->isDouble()) {
             if (nbReplicates != 1 or
@@ -1175,21 +1677,27 @@ ManOutput::insertReplicate(vle::value::Matrix& outMat, unsigned int currInput,
             }
             manageDouble = false;
         }
-        if (integrationType == ALL) {
-            if (inputAggregationType == S_at) {
-                delegate.reset(new DelOutIntAggrALL(*this, manageDouble));
-            } else {
-                delegate.reset(new DelOutIntALL(*this));
-            }
+        buildDelegate(manageDouble);
+    }
+    return *delegate;
+}
+
+void
+ManOutput::buildDelegate(bool manageDouble)
+{
+    if (integrationType == ALL) {
+        if (inputAggregationType == S_at) {
+            delegate.reset(new DelOutIntAggrALL(*this, manageDouble));
         } else {
-            if (inputAggregationType == S_at) {
-                delegate.reset(new DelOutAggrALL(*this, manageDouble));
-            } else {
-                delegate.reset(new DelOutStd(*this));
-            }
+            delegate.reset(new DelOutIntALL(*this));
+        }
+    } else {
+        if (inputAggregationType == S_at) {
+            delegate.reset(new DelOutAggrALL(*this, manageDouble));
+        } else {
+            delegate.reset(new DelOutStd(*this));
         }
     }
-    return delegate->insertReplicate(outMat, currInput);
 }
 
 bool
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2015-2015 INRA
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_QUANTILE_SKETCH_HPP_
+#define VLE_MANAGER_QUANTILE_SKETCH_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <vle/utils/Exception.hpp>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @brief Bounded memory quantile estimation (a deterministic variant of the
+ * KLL sketch). The values are stored into levels of at most @c capacity
+ * values; a value of level h stands for 2^h inserted values. When a level
+ * is full, it is sorted and one value out of two is moved to the next
+ * level.
+ *
+ * A compaction of the level h moves the rank of any value by at most 2^h,
+ * the sum of these errors is kept and a compaction that would exceed
+ * @c error * @c count grows the capacity (initially 2 / error) instead.
+ * The error on the rank of a quantile is therefore at most
+ * @c error * @c count (see @c rankError) and the memory is
+ * O(log^2(count) / error). Sketches are mergeable: the merge of the
+ * sketches of parts of the values is a sketch of all the values. While no
+ * level is compacted (less than @c capacity values), the quantiles are
+ * exact.
+ */
+class QuantileSketch
+{
+public:
+    /**
+     * @param error the expected error on ranks, in ]0, 1[.
+     */
+    QuantileSketch(double error)
+      : merror(error)
+      , mcapacity(0)
+      , mstep(0)
+      , mcount(0)
+      , mrankError(0)
+      , mmin(std::numeric_limits<double>::max())
+      , mmax(std::numeric_limits<double>::lowest())
+      , mlevels(1)
+      , mparity(1, false)
+    {
+        if (not(error > 0.0 and error < 1.0)) {
+            throw vle::utils::ArgError(
+              " [quantile_sketch] error must be in ]0, 1[");
+        }
+        mcapacity = std::max<std::size_t>(
+          8, static_cast<std::size_t>(std::ceil(2.0 / error)));
+        mcapacity += mcapacity % 2;
+        mstep = mcapacity;
+    }
+
+    inline void insert(double v)
+    {
+        mmin = std::min(v, mmin);
+        mmax = std::max(v, mmax);
+        mcount++;
+        mlevels[0].push_back(v);
+        if (mlevels[0].size() >= mcapacity) {
+            compress();
+        }
+    }
+
+    /**
+     * @brief Inserts all the values summarized by @c other.
+     */
+    void merge(const QuantileSketch& other)
+    {
+        if (other.mcount == 0) {
+            return;
+        }
+        mmin = std::min(other.mmin, mmin);
+        mmax = std::max(other.mmax, mmax);
+        mcount += other.mcount;
+        mrankError += other.mrankError;
+        mcapacity = std::max(mcapacity, other.mcapacity);
+        if (mlevels.size() < other.mlevels.size()) {
+            mlevels.resize(other.mlevels.size());
+            mparity.resize(other.mlevels.size(), false);
+        }
+        for (std::size_t h = 0; h < other.mlevels.size(); ++h) {
+            mlevels[h].insert(mlevels[h].end(),
+                              other.mlevels[h].begin(),
+                              other.mlevels[h].end());
+        }
+        compress();
+    }
+
+    /**
+     * @return the expected error on ranks.
+     */
+    inline double error() const
+    {
+        return merror;
+    }
+
+    /**
+     * @return the bound of the error on the ranks of the quantiles for
+     * the current values, lower or equal to @c error.
+     */
+    inline double rankError() const
+    {
+        return mcount ? static_cast<double>(mrankError) / mcount : 0.0;
+    }
+
+    /**
+     * @return the number of inserted values.
+     */
+    inline uint64_t count() const
+    {
+        return mcount;
+    }
+
+    /**
+     * @return the number of values stored.
+     */
+    std::size_t size() const
+    {
+        std::size_t ret = 0;
+        for (const auto& level : mlevels) {
+            ret += level.size();
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Quantile estimation, with the same interpolation as the
+     * exact quantile of @c AccuMono (type 7 of R).
+     * @param p the quantile order in [0, 1].
+     */
+    double quantile(double p) const
+    {
+        if (mcount == 0) {
+            throw vle::utils::ArgError(" [quantile_sketch] empty sketch");
+        }
+
+        std::vector<std::pair<double, uint64_t>> items;
+        items.reserve(size());
+        for (std::size_t h = 0; h < mlevels.size(); ++h) {
+            for (double v : mlevels[h]) {
+                items.emplace_back(v, uint64_t{ 1 } << h);
+            }
+        }
+        std::sort(items.begin(), items.end());
+
+        double h = (mcount - 1) * p;
+        uint64_t j = static_cast<uint64_t>(std::floor(h));
+        double g = h - j;
+        double lo = valueAtRank(items, j);
+        if (g == 0.0) {
+            return lo;
+        }
+        return (1 - g) * lo + g * valueAtRank(items, j + 1);
+    }
+
+private:
+    double valueAtRank(const std::vector<std::pair<double, uint64_t>>& items,
+                       uint64_t rank) const
+    {
+        if (rank == 0) {
+            return mmin;
+        }
+        if (rank >= mcount - 1) {
+            return mmax;
+        }
+        uint64_t cumul = 0;
+        for (const auto& item : items) {
+            cumul += item.second;
+            if (rank < cumul) {
+                return item.first;
+            }
+        }
+        return mmax;
+    }
+
+    void compress()
+    {
+        for (std::size_t h = 0; h < mlevels.size(); ++h) {
+            if (mlevels[h].size() < mcapacity) {
+                continue;
+            }
+
+            // Too many compactions: keep the error bound with a larger
+            // capacity.
+            if (mrankError + (uint64_t{ 1 } << h) > merror * mcount) {
+                while (mlevels[h].size() >= mcapacity) {
+                    mcapacity += mstep;
+                }
+                continue;
+            }
+
+            if (h + 1 == mlevels.size()) {
+                mlevels.emplace_back();
+                mparity.push_back(false);
+            }
+
+            std::vector<double>& level = mlevels[h];
+            std::sort(level.begin(), level.end());
+
+            // An odd value stays in the level. The kept half alternates
+            // between odd and even positions to balance the errors.
+            double rest = 0;
+            bool hasRest = level.size() % 2 == 1;
+            if (hasRest) {
+                rest = level.back();
+                level.pop_back();
+            }
+            for (std::size_t i = mparity[h] ? 1 : 0; i < level.size();
+                 i += 2) {
+                mlevels[h + 1].push_back(level[i]);
+            }
+            mparity[h] = not mparity[h];
+            mrankError += uint64_t{ 1 } << h;
+            level.clear();
+            if (hasRest) {
+                level.push_back(rest);
+            }
+        }
+    }
+
+    double merror;
+    std::size_t mcapacity;
+    std::size_t mstep;
+    uint64_t mcount;
+    uint64_t mrankError; /* sum of the weights of the compacted levels. */
+    double mmin;
+    double mmax;
+    std::vector<std::vector<double>> mlevels;
+    std::vector<bool> mparity;
+};
+}
+} // namespace vle manager
+
+#endif
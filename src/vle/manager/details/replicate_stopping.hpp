@@ -0,0 +1,225 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_DETAILS_REPLICATE_STOPPING_HPP_
+#define VLE_MANAGER_DETAILS_REPLICATE_STOPPING_HPP_
+
+#include "manager/details/accu_mono.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @brief The stopping rule of the replicates of an experiment plan. The
+ * replicates of an input are run until, for each output with a stopping
+ * rule (the @c stop_tolerance of the output), the half width of the
+ * confidence interval of the mean of the replicates is below the
+ * tolerance, or until all the replicates of the plan are run.
+ *
+ * The confidence interval uses the quantile of the Student distribution
+ * and the mean and variance of the running @c AccuMono of each input.
+ */
+class replicate_stopping
+{
+public:
+    /**
+     * @param inputs the number of inputs.
+     * @param replicates the number of replicates of each input, the
+     * maximal number of replicates run.
+     */
+    replicate_stopping(unsigned int inputs, unsigned int replicates)
+      : mInputs(inputs)
+      , mReplicates(replicates)
+      , mStopped(inputs, false)
+    {}
+
+    replicate_stopping(const replicate_stopping&) = delete;
+    replicate_stopping& operator=(const replicate_stopping&) = delete;
+
+    /**
+     * @brief Add the stopping rule of an output.
+     * @param output the index of the output in the outputs of the plan.
+     * @param tolerance the maximal half width of the confidence interval.
+     * @param confidence the level of the confidence interval.
+     * @param min_replicates the minimal number of replicates, at least 2.
+     */
+    void add(unsigned int output,
+             double tolerance,
+             double confidence,
+             unsigned int min_replicates)
+    {
+        mRules.emplace_back();
+        rule& r = mRules.back();
+        r.output = output;
+        r.tolerance = tolerance;
+        r.confidence = confidence;
+        r.min_replicates = std::max(2u, min_replicates);
+        r.accus.reserve(mInputs);
+        for (unsigned int i = 0; i < mInputs; ++i)
+            r.accus.emplace_back(STANDARD);
+    }
+
+    /**
+     * @return true if at least one rule is added and the plan has more
+     * than one replicate.
+     */
+    bool enabled() const
+    {
+        return not mRules.empty() and mReplicates > 1;
+    }
+
+    /**
+     * @return the number of replicates of an input run before the rules
+     * can be satisfied.
+     */
+    unsigned int min_replicates() const
+    {
+        unsigned int ret = 0;
+        for (const auto& r : mRules)
+            ret = std::max(ret, r.min_replicates);
+        return std::min(ret, mReplicates);
+    }
+
+    /**
+     * @return the indices of the outputs with a stopping rule, in the
+     * order of the values of @c insert.
+     */
+    std::vector<unsigned int> outputs() const
+    {
+        std::vector<unsigned int> ret;
+        for (const auto& r : mRules)
+            ret.push_back(r.output);
+        return ret;
+    }
+
+    /**
+     * @brief Insert the observed values of one replicate of @c input.
+     * Thread safe.
+     * @param values the value of each output of @c outputs.
+     * @param[out] count the number of replicates of @c input inserted.
+     * @return true when the rules are satisfied for the first time: the
+     * remaining replicates of @c input are not needed.
+     */
+    bool insert(unsigned int input,
+                const std::vector<double>& values,
+                unsigned int& count)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mStopped[input])
+            return false;
+
+        bool stop = true;
+        for (std::size_t i = 0; i < mRules.size(); ++i) {
+            rule& r = mRules[i];
+            AccuMono& accu = r.accus[input];
+            accu.insert(values[i]);
+            count = accu.count();
+
+            if (count < r.min_replicates or
+                student_quantile(r.confidence, count - 1) *
+                    accu.stdDeviation() / std::sqrt(count) > r.tolerance)
+                stop = false;
+        }
+
+        mStopped[input] = stop;
+        return stop;
+    }
+
+    /**
+     * @brief The quantile of the Student distribution with @c df degrees
+     * of freedom for a two-sided confidence interval.
+     * @return t such as P(|T| <= t) = @c confidence.
+     */
+    static double student_quantile(double confidence, unsigned int df)
+    {
+        const double pi = 3.14159265358979323846;
+        double low = 0, high = pi / 2;
+
+        for (int i = 0; i < 64; ++i) {
+            double theta = (low + high) / 2;
+            if (student_probability(theta, df) < confidence)
+                low = theta;
+            else
+                high = theta;
+        }
+
+        return std::sqrt(static_cast<double>(df)) * std::tan((low + high) / 2);
+    }
+
+private:
+    /* P(|T| <= t) with theta = atan(t / sqrt(df)), from the finite sums for
+     * an integer degree of freedom (Abramowitz and Stegun, 26.7.3 and
+     * 26.7.4). */
+    static double student_probability(double theta, unsigned int df)
+    {
+        const double pi = 3.14159265358979323846;
+        double c2 = std::cos(theta) * std::cos(theta);
+        double term = 1, sum = 1;
+
+        if (df % 2) {
+            if (df == 1)
+                return 2 / pi * theta;
+
+            for (unsigned int k = 3; k + 2 <= df; k += 2) {
+                term *= (k - 1.0) / k * c2;
+                sum += term;
+            }
+            return 2 / pi *
+                   (theta + std::sin(theta) * std::cos(theta) * sum);
+        }
+
+        for (unsigned int k = 2; k + 2 <= df; k += 2) {
+            term *= (k - 1.0) / k * c2;
+            sum += term;
+        }
+        return std::sin(theta) * sum;
+    }
+
+    struct rule
+    {
+        unsigned int output;
+        double tolerance;
+        double confidence;
+        unsigned int min_replicates;
+        std::vector<AccuMono> accus; // for each input
+    };
+
+    std::mutex mMutex;
+    std::vector<rule> mRules;
+    unsigned int mInputs;
+    unsigned int mReplicates;
+    std::vector<bool> mStopped;
+};
+}
+} // namespace vle manager
+
+#endif
@@ -94,7 +94,18 @@ struct thread_log : vle::utils::Context::LogFunctor
 
 /**
  * The @c worker is a boost thread functor to execute threaded
- * source code.
+ * source code. The simulations are taken from a @c work_queue shared by
+ * all the workers of the plan. Each worker aggregates its simulations into
+ * its own outputs, merged by @c thread_reduce, or streams them to a
+ * @c PlanSink.
+ *
+ * With the @c SIMULATION_WARM_START option (the @c simulation_warm_start
+ * configuration of the manager), a worker keeps its loaded models from
+ * one simulation to the next one: only the conditions are copied and the
+ * dynamics are built again, unless the models contain executives.
+ *
+ * With a @c replicate_stopping, the remaining replicates of an input are
+ * dropped from the @c work_queue once its stopping rules are satisfied.
  *
  */
 struct thread_worker
@@ -104,12 +115,13 @@ struct thread_worker
     const wrapper_init& mInit;
     const ManagerObjects& mManObjs;
     std::vector<std::unique_ptr<ManOutput>>& mOutputs;//to fill
-    value::Map&               mResults;//to fill
     std::mutex&                mMutex;
     std::chrono::milliseconds mTimeout;
     SimulationOptions         mSimulationOption;
-    uint32_t                  mIndex;
-    uint32_t                  mThreads;
+    work_queue&               mQueue;
+    PlanSink*                 mSink;
+    replicate_stopping*       mStopping;
+    std::shared_ptr<SimulationCache> mCache;
     Error&                    mError;//tofill
 
     thread_worker(utils::ContextPtr context,
@@ -117,17 +129,20 @@ struct thread_worker
             const wrapper_init& init,
             const ManagerObjects& manObjs,
             std::vector<std::unique_ptr<ManOutput>>& outputs,//to fill
-            value::Map& results,
-            std::mutex& results_mutex,
+            std::mutex& error_mutex,
             std::chrono::milliseconds timeout,
             SimulationOptions simulationOption,
-            uint32_t index,
-            uint32_t threads,
+            work_queue& queue,
+            PlanSink* sink,
+            replicate_stopping* stopping,
+            std::shared_ptr<SimulationCache> cache,
             Error& error):
                 mContext(context), mVpz(vpz), mInit(init), mManObjs(manObjs),
-                mOutputs(outputs), mResults(results), mMutex(results_mutex),
+                mOutputs(outputs), mMutex(error_mutex),
                 mTimeout(timeout), mSimulationOption(simulationOption),
-                mIndex(index), mThreads(threads), mError(error)
+                mQueue(queue), mSink(sink), mStopping(stopping),
+                mCache(std::move(cache)),
+                mError(error)
     {}
 
     ~thread_worker() = default;
@@ -138,12 +153,25 @@ struct thread_worker
         unsigned int M = mManObjs.replicasSize();
 
         std::shared_ptr<value::Value> temp_val;
-        for (unsigned int  i =  mIndex; i < M*N; i += mThreads) {
-            unsigned int inputIndex = i / M;
-            unsigned int replIndex = i % M;
-            Simulation sim(mContext, mSimulationOption, mTimeout);
-
-            std::unique_ptr<vpz::Vpz> vpz_loc(new vpz::Vpz(mVpz));
+        unsigned int inputIndex, replIndex;
+        std::vector<unsigned int> stopOutputs;
+        std::vector<double> stopValues;
+        if (mStopping) {
+            stopOutputs = mStopping->outputs();
+        }
+        Simulation sim(mContext, mSimulationOption, mTimeout);
+        sim.setCache(mCache);
+        while (mQueue.pop(inputIndex, replIndex)) {
+            std::unique_ptr<vpz::Vpz> vpz_loc;
+            std::unique_ptr<vpz::Conditions> cond_loc;
+            if (sim.isRestartable()) {
+                cond_loc.reset(new vpz::Conditions(
+                        mVpz.project().experiment().conditions()));
+            } else {
+                vpz_loc.reset(new vpz::Vpz(mVpz));
+            }
+            vpz::Conditions& conditions = vpz_loc ?
+                    vpz_loc->project().experiment().conditions() : *cond_loc;
 
             for (auto& tmp_input : mManObjs.mInputs) {
                 const value::Value& exp = tmp_input->values(mInit);
@@ -160,15 +188,18 @@ struct thread_worker
                     if (N == 1) {
                         temp_val.reset(exp.clone().release());
                     } else {
-                        mError.code = -1;
-                        mError.message = "[Manager] error thread";
+                        std::lock_guard<std::mutex> lock(mMutex);
+                        mQueue.clear();
+                        if (not mError.code) {
+                            mError.code = -1;
+                            mError.message = "[Manager] error thread";
+                        }
                         return ;
                     }
                     break;
                 }
-                vpz_loc->project().experiment().conditions()
-                                  .get(tmp_input->cond)
-                                  .setValueToPort(tmp_input->port, temp_val);
+                conditions.get(tmp_input->cond)
+                        .setValueToPort(tmp_input->port, temp_val);
             }
             for (auto& tmp_repl : mManObjs.mReplicates) {
                 const value::Value& exp = tmp_repl->values(mInit);
@@ -185,57 +216,135 @@ struct thread_worker
                     if (M == 1) {
                         temp_val.reset(exp.clone().release());
                     } else {
-                        mError.code = -1;
-                        mError.message = "[Manager] error thread";
+                        std::lock_guard<std::mutex> lock(mMutex);
+                        mQueue.clear();
+                        if (not mError.code) {
+                            mError.code = -1;
+                            mError.message = "[Manager] error thread";
+                        }
                         return ;
                     }
                 }
-                vpz_loc->project().experiment().conditions()
-                                  .get(tmp_repl->cond)
-                                  .setValueToPort(tmp_repl->port, temp_val);
+                conditions.get(tmp_repl->cond)
+                        .setValueToPort(tmp_repl->port, temp_val);
             }
             Error error_loc;
-            auto simresult = sim.run(std::move(vpz_loc), &error_loc);
+            auto simresult = vpz_loc ? sim.run(std::move(vpz_loc), &error_loc)
+                    : sim.restart(conditions, &error_loc);
 
-            //////////////////
-            mMutex.lock();
-            if (mError.code) {
-                mMutex.unlock();
-                return;
-            }
             if (error_loc.code) {
-                mError.code = error_loc.code;
-                mError.message = "[Manager error] simulation input="+
-                        std::to_string(inputIndex)+
-                        ", replicate="+std::to_string(replIndex)+" : "+
-                        error_loc.message;
-                mMutex.unlock();
+                std::lock_guard<std::mutex> lock(mMutex);
+                mQueue.clear();
+                if (not mError.code) {
+                    mError.code = error_loc.code;
+                    mError.message = "[Manager error] simulation input="+
+                            std::to_string(inputIndex)+
+                            ", replicate="+std::to_string(replIndex)+" : "+
+                            error_loc.message;
+                }
                 return ;
             }
             try {
-                std::unique_ptr<value::Value> aggr_value;
-                for (unsigned int out=0; out<mOutputs.size(); out++) {
-                    ManOutput& mout = *mOutputs[out];
-                    aggr_value = mout.insertReplicate(*simresult,
-                            inputIndex, N, M);
-                    if (aggr_value) {
-                        mResults.set(mout.id, std::move(aggr_value));
+                if (mStopping) {
+                    stopValues.clear();
+                    for (auto out : stopOutputs) {
+                        stopValues.push_back(
+                                mOutputs[out]->observe(*simresult));
+                    }
+                    unsigned int count = 0;
+                    if (mStopping->insert(inputIndex, stopValues, count)) {
+                        mQueue.stop(inputIndex);
+                        mContext->log(VLE_LOG_NOTICE, "[Manager] input %u "
+                                "stopped after %u replicates\n", inputIndex,
+                                count);
+                    }
+                }
+                if (mSink) {
+                    std::unique_ptr<value::Map> outputs(new value::Map());
+                    for (auto& mout : mOutputs) {
+                        outputs->add(mout->id, mout->extract(*simresult));
+                    }
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mSink->write(inputIndex, replIndex, std::move(outputs));
+                } else {
+                    for (auto& mout : mOutputs) {
+                        mout->accumulate(*simresult, inputIndex, N, M);
                     }
                 }
             } catch ( const std::exception& e) {
-                mError.code = -1;
-                mError.message = "[Manager error] aggregation input="+
-                        std::to_string(inputIndex)+
-                        ", replicate="+std::to_string(replIndex)+" : "+
-                        e.what();
-                mMutex.unlock();
+                std::lock_guard<std::mutex> lock(mMutex);
+                mQueue.clear();
+                if (not mError.code) {
+                    mError.code = -1;
+                    mError.message = "[Manager error] aggregation input="+
+                            std::to_string(inputIndex)+
+                            ", replicate="+std::to_string(replIndex)+" : "+
+                            e.what();
+                }
                 return ;
             }
-            mMutex.unlock();
         }
     }
 };
 
+/**
+ * Merge the outputs filled by the workers into the outputs of the plan and
+ * fill the results with the aggregated values. The outputs are independent
+ * and reduced in parallel by @c threads threads.
+ *
+ */
+inline void
+thread_reduce(std::vector<std::unique_ptr<ManOutput>>& outputs,
+        std::vector<std::vector<std::unique_ptr<ManOutput>>>& partials,
+        value::Map& results, unsigned int threads, Error& error)
+{
+    std::vector<std::unique_ptr<value::Value>> values(outputs.size());
+    std::mutex error_mutex;
+    work_queue queue(outputs.size(), 1);
+
+    auto reduce = [&]() {
+        unsigned int out, unused;
+        while (queue.pop(out, unused)) {
+            try {
+                for (auto& partial : partials) {
+                    outputs[out]->merge(*partial[out]);
+                }
+                //inputs stopped by a replicate_stopping
+                outputs[out]->closeReplicates();
+                values[out] = outputs[out]->finish();
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                queue.clear();
+                if (not error.code) {
+                    error.code = -1;
+                    error.message = "[Manager error] aggregation output=" +
+                            outputs[out]->id + " : " + e.what();
+                }
+                return;
+            }
+        }
+    };
+
+    threads = std::max(1u, std::min(threads, queue.size()));
+    std::vector<std::thread> gp;
+    for (unsigned int i = 1; i < threads; ++i) {
+        gp.emplace_back(reduce);
+    }
+    reduce();
+    for (auto& th : gp) {
+        th.join();
+    }
+
+    if (error.code) {
+        return;
+    }
+    for (unsigned int out = 0; out < outputs.size(); ++out) {
+        if (values[out]) {
+            results.set(outputs[out]->id, std::move(values[out]));
+        }
+    }
+}
+
 }
 } // namespace vle manager
 
@@ -0,0 +1,163 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_DETAILS_WORK_QUEUE_HPP_
+#define VLE_MANAGER_DETAILS_WORK_QUEUE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @brief A queue of the simulations (input, replicate) of an experiment
+ * plan shared by the @c thread_worker. Each worker takes the next
+ * simulation when it finishes the previous one, so a worker never waits
+ * while simulations remain.
+ *
+ * If a cost hint (the expected cost of the simulations of each input) is
+ * provided, the inputs are dispatched from the most expensive to the
+ * cheapest, to avoid a long simulation at the end of the plan. The
+ * replicates of an input are dispatched consecutively.
+ *
+ * The remaining replicates of an input can be dropped with @c stop, when
+ * the replicates already run are enough (see @c replicate_stopping). With
+ * @c interleave, only the first replicates of the inputs are dispatched
+ * consecutively, so that the threads do not take all the replicates of
+ * an input before the results of the first ones are known.
+ */
+class work_queue
+{
+public:
+    /**
+     * @param inputs the number of inputs.
+     * @param replicates the number of replicates of each input.
+     * @param costs the expected cost of each input or an empty vector.
+     * The size of a non empty @c costs must be @c inputs.
+     */
+    work_queue(unsigned int inputs,
+               unsigned int replicates,
+               const std::vector<double>& costs = {})
+      : mOrder(inputs)
+      , mStopped(new std::atomic<bool>[inputs])
+      , mReplicates(replicates)
+      , mGrouped(replicates)
+      , mSize(inputs * replicates)
+      , mNext(0)
+    {
+        std::iota(mOrder.begin(), mOrder.end(), 0u);
+        for (unsigned int i = 0; i < inputs; ++i)
+            mStopped[i].store(false, std::memory_order_relaxed);
+
+        if (costs.size() == inputs) {
+            std::stable_sort(mOrder.begin(),
+                             mOrder.end(),
+                             [&costs](unsigned int a, unsigned int b) {
+                                 return costs[a] > costs[b];
+                             });
+        }
+    }
+
+    work_queue(const work_queue&) = delete;
+    work_queue& operator=(const work_queue&) = delete;
+
+    /**
+     * @brief Take the next simulation of the plan. Thread safe.
+     * @param[out] input the input index of the simulation.
+     * @param[out] replicate the replicate index of the simulation.
+     * @return false if all the simulations are already taken.
+     */
+    bool pop(unsigned int& input, unsigned int& replicate)
+    {
+        for (;;) {
+            unsigned int i = mNext.fetch_add(1, std::memory_order_relaxed);
+            if (i >= mSize)
+                return false;
+
+            const auto inputs = static_cast<unsigned int>(mOrder.size());
+            if (i < inputs * mGrouped) {
+                input = mOrder[i / mGrouped];
+                replicate = i % mGrouped;
+            } else {
+                i -= inputs * mGrouped;
+                input = mOrder[i % inputs];
+                replicate = mGrouped + i / inputs;
+            }
+
+            if (not mStopped[input].load(std::memory_order_relaxed))
+                return true;
+        }
+    }
+
+    /**
+     * @brief Dispatch the first @c grouped replicates of each input
+     * consecutively, then the next replicates in turn: the replicate r of
+     * every input not stopped before the replicate r + 1. To call before
+     * the first @c pop.
+     */
+    void interleave(unsigned int grouped)
+    {
+        mGrouped = std::min(grouped, mReplicates);
+    }
+
+    /**
+     * @brief Drop the replicates of @c input not yet taken. Thread safe.
+     * The simulations of @c input already taken are not interrupted.
+     */
+    void stop(unsigned int input)
+    {
+        mStopped[input].store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drop the remaining simulations, for instance after an error.
+     */
+    void clear()
+    {
+        mNext.store(mSize, std::memory_order_relaxed);
+    }
+
+    unsigned int size() const
+    {
+        return mSize;
+    }
+
+private:
+    std::vector<unsigned int> mOrder;
+    std::unique_ptr<std::atomic<bool>[]> mStopped;
+    unsigned int mReplicates;
+    unsigned int mGrouped;
+    unsigned int mSize;
+    std::atomic<unsigned int> mNext;
+};
+}
+} // namespace vle manager
+
+#endif
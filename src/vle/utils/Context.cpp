@@ -331,8 +331,8 @@ Context::clone()
     ContextPtr nctx = std::make_shared<Context>();
     nctx->m_pimpl->m_prefix = m_pimpl->m_prefix;
     nctx->m_pimpl->m_home = m_pimpl->m_home;
-    for (auto s : nctx->m_pimpl->settings) {
-        nctx->m_pimpl->settings.insert(s);
+    for (const auto& s : m_pimpl->settings) {
+        nctx->m_pimpl->settings[s.first] = s.second;
     }
     nctx->m_pimpl->modules = m_pimpl->modules;
     nctx->m_pimpl->log_priority = m_pimpl->log_priority;
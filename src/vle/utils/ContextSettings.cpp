@@ -138,6 +138,15 @@ Context::reset_settings() noexcept
     simulation += " -V '%1%' --write-output '%2%' '%3%'";
 #endif
     m_pimpl->settings["vle.command.vle.simulation"] = simulation;
+
+    std::string worker = "";
+#ifdef _WIN32
+    worker = "vle.exe -V '%1%' --worker";
+#else
+    worker = utils::format("vle-%s", vle::string_version_abi().c_str());
+    worker += " -V '%1%' --worker";
+#endif
+    m_pimpl->settings["vle.command.vle.worker"] = worker;
 }
 
 bool
@@ -42,6 +42,46 @@
 namespace vle {
 namespace utils {
 
+namespace {
+
+/* Log the output of the download command line by line: the chunks read
+ * from the pipes may stop anywhere in a line. */
+class line_logger
+{
+public:
+    explicit line_logger(ContextPtr context)
+      : m_context(std::move(context))
+    {}
+
+    void append(const std::string& chunk)
+    {
+        m_buffer += chunk;
+
+        std::string::size_type begin = 0, end;
+        while ((end = m_buffer.find('\n', begin)) != std::string::npos) {
+            m_context->debug(
+              "%s\n", m_buffer.substr(begin, end - begin).c_str());
+            begin = end + 1;
+        }
+
+        m_buffer.erase(0, begin);
+    }
+
+    void flush()
+    {
+        if (not m_buffer.empty()) {
+            m_context->debug("%s\n", m_buffer.c_str());
+            m_buffer.clear();
+        }
+    }
+
+private:
+    ContextPtr m_context;
+    std::string m_buffer;
+};
+
+} // anonymous namespace
+
 struct DownloadManager::Pimpl
 {
     ContextPtr mContext;
@@ -117,24 +157,18 @@ struct DownloadManager::Pimpl
                 return;
             }
 
-            std::string output, error;
-            while (not spawn.isfinish()) {
-                if (spawn.get(&output, &error)) {
-                    if (not output.empty()) {
-                        mContext->debug("%s", output.c_str());
-                        output.clear();
-                    }
-                    if (not error.empty()) {
-                        mContext->debug("%s", error.c_str());
-                        error.clear();
-                    }
-                    std::this_thread::sleep_for(
-                      std::chrono::microseconds(200));
-                } else
-                    break;
-            }
+            line_logger output_log(mContext), error_log(mContext);
+            spawn.waitFor(
+              std::chrono::milliseconds::zero(),
+              [&output_log, &error_log](const std::string& output,
+                                        const std::string& error) {
+                  output_log.append(output);
+                  error_log.append(error);
+              });
 
             spawn.wait();
+            output_log.flush();
+            error_log.flush();
 
             std::string message;
             bool success;
@@ -148,6 +148,23 @@ Path::file_size() const
     return (size_t)sb.st_size;
 }
 
+std::time_t
+Path::last_write_time() const
+{
+#if defined(_WIN32)
+    struct _stati64 sb;
+    if (_wstati64(wstring().c_str(), &sb) != 0)
+        throw FileError(_("Path::last_write_time(): cannot stat file %s"),
+                        string().c_str());
+#else
+    struct stat sb;
+    if (stat(string().c_str(), &sb) != 0)
+        throw FileError(_("Path::last_write_time(): cannot stat file %s"),
+                        string().c_str());
+#endif
+    return sb.st_mtime;
+}
+
 bool
 Path::is_directory() const
 {
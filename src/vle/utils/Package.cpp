@@ -41,7 +41,6 @@
 #include <fstream>
 #include <ostream>
 #include <stack>
-#include <thread>
 
 #include <cstring>
 
@@ -460,48 +459,19 @@ Package::isSuccess() const
 bool
 Package::wait(std::ostream& out, std::ostream& err)
 {
-    std::string output;
-    std::string error;
-
-    output.reserve(Spawn::default_buffer_size);
-    error.reserve(Spawn::default_buffer_size);
-
-    while (not m_pimpl->m_spawn.isfinish()) {
-        if (m_pimpl->m_spawn.get(&output, &error)) {
-            if (not output.empty()) {
-                out << output;
-                output.clear();
-            }
-
-            if (not error.empty()) {
-                err << error;
-                error.clear();
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        } else {
-            break;
-        }
-    }
-
-    m_pimpl->m_spawn.wait();
-
     //
-    // Force to get the latest spawn message. Indeed, spawn process can be
-    // finished but the output and error buffers may not clean.
+    // waitFor() reads the latest spawn messages written before the end of
+    // the process.
     //
 
-    if (m_pimpl->m_spawn.get(&output, &error)) {
-        if (not output.empty()) {
-            out << output;
-            output.clear();
-        }
+    m_pimpl->m_spawn.waitFor(
+      std::chrono::milliseconds::zero(),
+      [&out, &err](const std::string& output, const std::string& error) {
+          out << output;
+          err << error;
+      });
 
-        if (not error.empty()) {
-            err << error;
-            error.clear();
-        }
-    }
+    m_pimpl->m_spawn.wait();
 
     return m_pimpl->m_spawn.status(&m_pimpl->m_message, &m_pimpl->m_issuccess);
 }
@@ -677,20 +677,12 @@ public:
             if (not spawn.start(exe, pwd.string(), argv))
                 throw utils::InternalError(_("fail to start cmake command"));
 
-            std::string output, error;
-            while (not spawn.isfinish()) {
-                if (spawn.get(&output, &error)) {
-                    std::cout << output;
-                    std::cerr << error;
-
-                    output.clear();
-                    error.clear();
-
-                    std::this_thread::sleep_for(
-                      std::chrono::microseconds(200));
-                } else
-                    break;
-            }
+            spawn.waitFor(
+              std::chrono::milliseconds::zero(),
+              [](const std::string& output, const std::string& error) {
+                  std::cout << output;
+                  std::cerr << error;
+              });
 
             spawn.wait();
 
@@ -739,20 +731,12 @@ public:
             if (not spawn.start(exe, directorypath.string(), argv))
                 throw utils::InternalError(_("fail to start cmake command"));
 
-            std::string output, error;
-            while (not spawn.isfinish()) {
-                if (spawn.get(&output, &error)) {
-                    std::cout << output;
-                    std::cerr << error;
-
-                    output.clear();
-                    error.clear();
-
-                    std::this_thread::sleep_for(
-                      std::chrono::microseconds(200));
-                } else
-                    break;
-            }
+            spawn.waitFor(
+              std::chrono::milliseconds::zero(),
+              [](const std::string& output, const std::string& error) {
+                  std::cout << output;
+                  std::cerr << error;
+              });
 
             spawn.wait();
 
@@ -102,8 +102,9 @@ Context::findLibrary(const std::string& lib)
 #endif
 
     std::vector<std::string> splitVec;
-    boost::split(
-      splitVec, env_p, boost::is_any_of(":"), boost::token_compress_on);
+    if (env_p)
+        boost::split(
+          splitVec, env_p, boost::is_any_of(":"), boost::token_compress_on);
 
     splitVec.insert(splitVec.begin(), "/usr/lib");
     splitVec.insert(splitVec.begin(), "/usr/local/lib");
@@ -124,11 +125,16 @@ Context::findLibrary(const std::string& lib)
 Path
 Context::findProgram(const std::string& exe)
 {
+    // Like execvp, a name with a slash is not searched in the PATH.
+    if (exe.find('/') != std::string::npos)
+        return exe;
+
     char* env_p = std::getenv("PATH");
 
     std::vector<std::string> splitVec;
-    boost::split(
-      splitVec, env_p, boost::is_any_of(":"), boost::token_compress_on);
+    if (env_p)
+        boost::split(
+          splitVec, env_p, boost::is_any_of(":"), boost::token_compress_on);
 
     std::vector<std::string>::const_iterator itb = splitVec.begin();
     std::vector<std::string>::const_iterator ite = splitVec.end();
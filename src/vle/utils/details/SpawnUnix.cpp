@@ -33,7 +33,6 @@
 
 #include <algorithm>
 #include <iostream>
-#include <thread>
 #include <utility>
 
 #include <cassert>
@@ -42,9 +41,14 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <poll.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
 #ifdef __APPLE__
 #include <crt_externs.h>
 #include <signal.h>
@@ -147,6 +151,24 @@ input_timeout(int fd, std::chrono::milliseconds wait)
     return static_cast<int>(result);
 }
 
+/**
+ * @e open_pidfd returns a file descriptor readable when the process ends.
+ *
+ * @param pid The process identifier.
+ *
+ * @return the file descriptor or -1 if the system does not support pidfd.
+ */
+static int
+open_pidfd(pid_t pid)
+{
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
 class Spawn::Pimpl
 {
 public:
@@ -257,6 +279,131 @@ public:
         return true;
     }
 
+    /* Read the available data of the pipe @e fd and call the output
+     * function. Return false at the end of the pipe. */
+    bool read_pipe(int fd, bool is_error, const OutputFunction& output)
+    {
+        char buffer[BUFSIZ];
+        ssize_t size;
+
+        do {
+            size = ::read(fd, buffer, BUFSIZ);
+        } while (size == -1 and errno == EINTR);
+
+        if (size <= 0)
+            return false;
+
+        if (output) {
+            std::string data(buffer, static_cast<std::size_t>(size));
+            if (is_error)
+                output(std::string(), data);
+            else
+                output(data, std::string());
+        }
+
+        return true;
+    }
+
+    bool wait_for(std::chrono::milliseconds timeout,
+                  const OutputFunction& output)
+    {
+        assert(m_start);
+
+        using clock = std::chrono::steady_clock;
+        const auto deadline = timeout == std::chrono::milliseconds::zero()
+                                ? clock::time_point::max()
+                                : clock::now() + timeout;
+
+        const int pidfd = open_pidfd(m_pid);
+        bool pipeout = true, pipeerr = true;
+        std::chrono::milliseconds backoff{ 1 };
+
+        while (not m_finish) {
+            switch (waitpid(m_pid, &m_status, WNOHANG)) {
+            case 0:
+                break;
+            case -1:
+                m_context->log(VLE_LOG_ALERT,
+                               _("Spawn: check running child fail: %s\n"),
+                               strerror(errno));
+                m_finish = true;
+                continue;
+            default:
+                m_finish = true;
+                continue;
+            }
+
+            struct pollfd fds[3];
+            nfds_t nfds = 0;
+            if (pipeout)
+                fds[nfds++] = { m_pipeout[0], POLLIN, 0 };
+            if (pipeerr)
+                fds[nfds++] = { m_pipeerr[0], POLLIN, 0 };
+            if (pidfd >= 0)
+                fds[nfds++] = { pidfd, POLLIN, 0 };
+
+            /* Without pidfd, the end of the process is checked with an
+             * increasing delay: a descendant of the child may keep the
+             * pipes open after its end. */
+            std::chrono::milliseconds delay{ -1 };
+            if (pidfd < 0) {
+                delay = backoff;
+                backoff =
+                  std::min(backoff * 2, std::chrono::milliseconds{ 100 });
+            }
+
+            if (deadline != clock::time_point::max()) {
+                auto remaining =
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - clock::now());
+                if (remaining.count() <= 0)
+                    break;
+
+                if (delay.count() < 0 or remaining < delay)
+                    delay = remaining;
+            }
+
+            if (::poll(fds, nfds, static_cast<int>(delay.count())) <= 0)
+                continue;
+
+            for (nfds_t i = 0; i != nfds; ++i) {
+                if (fds[i].fd == pidfd or not fds[i].revents)
+                    continue;
+
+                bool is_error = fds[i].fd == m_pipeerr[0];
+                if (not read_pipe(fds[i].fd, is_error, output))
+                    (is_error ? pipeerr : pipeout) = false;
+            }
+        }
+
+        if (pidfd >= 0)
+            ::close(pidfd);
+
+        if (not m_finish)
+            return false;
+
+        /* Read the data written before the end of the process without
+         * waiting for the descendants that share the pipes. */
+        struct pollfd fds[2] = { { m_pipeout[0], POLLIN, 0 },
+                                 { m_pipeerr[0], POLLIN, 0 } };
+        while (pipeout or pipeerr) {
+            fds[0].fd = pipeout ? m_pipeout[0] : -1;
+            fds[1].fd = pipeerr ? m_pipeerr[0] : -1;
+
+            if (::poll(fds, 2, 0) <= 0)
+                break;
+
+            if (pipeout and fds[0].revents)
+                pipeout = read_pipe(m_pipeout[0], false, output);
+            else if (pipeerr and fds[1].revents)
+                pipeerr = read_pipe(m_pipeerr[0], true, output);
+            else
+                break;
+        }
+
+        return true;
+    }
+
     bool initchild(const Path& exe,
                    const Path& workingdir,
                    std::vector<std::string> args)
@@ -297,8 +444,6 @@ public:
         ::close(m_pipeerr[1]);
         m_pid = localpid;
 
-        std::this_thread::sleep_for(m_waitchildtimeout);
-
         return is_running();
     }
 
@@ -458,6 +603,12 @@ Spawn::wait()
     return m_pimpl->wait();
 }
 
+bool
+Spawn::waitFor(std::chrono::milliseconds timeout, const OutputFunction& output)
+{
+    return m_pimpl->wait_for(timeout, output);
+}
+
 void
 Spawn::kill()
 {
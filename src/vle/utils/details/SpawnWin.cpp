@@ -407,6 +407,47 @@ struct Spawn::Pimpl
         return true;
     }
 
+    /* Anonymous pipes can not be waited on with Win32: the pipes are
+     * read between the waits on the process handle. */
+    bool wait_for(std::chrono::milliseconds timeout,
+                  const OutputFunction& output)
+    {
+        assert(m_start);
+
+        using clock = std::chrono::steady_clock;
+        const auto deadline = timeout == std::chrono::milliseconds::zero()
+                                ? clock::time_point::max()
+                                : clock::now() + timeout;
+
+        std::string out, err;
+        for (;;) {
+            bool running = is_running();
+
+            if (get(&out, &err) and output and
+                (not out.empty() or not err.empty()))
+                output(out, err);
+            out.clear();
+            err.clear();
+
+            if (not running)
+                return true;
+
+            DWORD delay = 10;
+            if (deadline != clock::time_point::max()) {
+                auto remaining =
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - clock::now());
+                if (remaining.count() <= 0)
+                    return false;
+
+                delay =
+                  (std::min)(delay, static_cast<DWORD>(remaining.count()));
+            }
+
+            WaitForSingleObject(m_pi.hProcess, delay);
+        }
+    }
+
     void kill()
     {
         assert(m_start);
@@ -479,6 +520,12 @@ Spawn::wait()
     return m_pimpl->wait();
 }
 
+bool
+Spawn::waitFor(std::chrono::milliseconds timeout, const OutputFunction& output)
+{
+    return m_pimpl->wait_for(timeout, output);
+}
+
 void
 Spawn::kill()
 {
@@ -0,0 +1,324 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Exception.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/XML.hpp>
+
+#include "utils/i18n.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+/* Tag used to store an empty std::unique_ptr or std::shared_ptr. Other tags
+ * are the value::Value::type enumeration. */
+const uint8_t binary_empty_pointer = 0xff;
+
+template<typename T>
+inline uint32_t
+to_uint32(T size)
+{
+    if (size > std::numeric_limits<uint32_t>::max())
+        throw vle::utils::ArgError(_("BinaryWriter: container too large"));
+
+    return static_cast<uint32_t>(size);
+}
+}
+
+namespace vle {
+namespace value {
+
+void
+BinaryWriter::writeUint8(uint8_t value)
+{
+    m_buffer.push_back(static_cast<char>(value));
+}
+
+void
+BinaryWriter::writeUint32(uint32_t value)
+{
+    char buf[4];
+    for (int i = 0; i != 4; ++i)
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+
+    m_buffer.append(buf, 4);
+}
+
+void
+BinaryWriter::writeUint64(uint64_t value)
+{
+    char buf[8];
+    for (int i = 0; i != 8; ++i)
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+
+    m_buffer.append(buf, 8);
+}
+
+void
+BinaryWriter::writeDouble(double value)
+{
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "double is not 64 bits");
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeUint64(bits);
+}
+
+void
+BinaryWriter::writeString(const std::string& value)
+{
+    writeUint32(::to_uint32(value.size()));
+    m_buffer.append(value);
+}
+
+void
+BinaryWriter::writeValue(const Value* value)
+{
+    if (not value) {
+        writeUint8(::binary_empty_pointer);
+        return;
+    }
+
+    writeUint8(static_cast<uint8_t>(value->getType()));
+
+    switch (value->getType()) {
+    case Value::BOOLEAN:
+        writeUint8(value->toBoolean().value() ? 1 : 0);
+        break;
+    case Value::INTEGER:
+        writeInt32(value->toInteger().value());
+        break;
+    case Value::DOUBLE:
+        writeDouble(value->toDouble().value());
+        break;
+    case Value::STRING:
+        writeString(value->toString().value());
+        break;
+    case Value::SET: {
+        const auto& set = value->toSet().value();
+        writeUint32(::to_uint32(set.size()));
+        for (const auto& elem : set)
+            writeValue(elem.get());
+    } break;
+    case Value::MAP: {
+        const auto& map = value->toMap().value();
+        writeUint32(::to_uint32(map.size()));
+        for (const auto& elem : map) {
+            writeString(elem.first);
+            writeValue(elem.second.get());
+        }
+    } break;
+    case Value::TUPLE: {
+        const auto& tuple = value->toTuple().value();
+        writeUint32(::to_uint32(tuple.size()));
+        for (auto elem : tuple)
+            writeDouble(elem);
+    } break;
+    case Value::TABLE: {
+        const auto& table = value->toTable();
+        writeUint32(::to_uint32(table.width()));
+        writeUint32(::to_uint32(table.height()));
+        for (auto elem : table.value())
+            writeDouble(elem);
+    } break;
+    case Value::XMLTYPE:
+        writeString(value->toXml().value());
+        break;
+    case Value::NIL:
+        break;
+    case Value::MATRIX: {
+        const auto& matrix = value->toMatrix();
+        writeUint32(::to_uint32(matrix.columns()));
+        writeUint32(::to_uint32(matrix.rows()));
+        writeUint32(::to_uint32(matrix.columns_max()));
+        writeUint32(::to_uint32(matrix.rows_max()));
+        writeUint32(::to_uint32(matrix.resizeColumn()));
+        writeUint32(::to_uint32(matrix.resizeRow()));
+        for (std::size_t row = 0; row != matrix.rows(); ++row)
+            for (std::size_t col = 0; col != matrix.columns(); ++col)
+                writeValue(matrix.get(col, row).get());
+    } break;
+    case Value::USER:
+        throw utils::ArgError(_("BinaryWriter: can not write user value"));
+    }
+}
+
+const char*
+BinaryReader::require(std::size_t size)
+{
+    if (static_cast<std::size_t>(m_last - m_first) < size)
+        throw utils::ArgError(_("BinaryReader: unexpected end of buffer"));
+
+    const char* ret = m_first;
+    m_first += size;
+    return ret;
+}
+
+uint8_t
+BinaryReader::readUint8()
+{
+    return static_cast<uint8_t>(*require(1));
+}
+
+uint32_t
+BinaryReader::readUint32()
+{
+    const auto* buf = reinterpret_cast<const unsigned char*>(require(4));
+    uint32_t ret = 0;
+    for (int i = 0; i != 4; ++i)
+        ret |= static_cast<uint32_t>(buf[i]) << (8 * i);
+
+    return ret;
+}
+
+uint64_t
+BinaryReader::readUint64()
+{
+    const auto* buf = reinterpret_cast<const unsigned char*>(require(8));
+    uint64_t ret = 0;
+    for (int i = 0; i != 8; ++i)
+        ret |= static_cast<uint64_t>(buf[i]) << (8 * i);
+
+    return ret;
+}
+
+double
+BinaryReader::readDouble()
+{
+    uint64_t bits = readUint64();
+    double ret;
+    std::memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+std::string
+BinaryReader::readString()
+{
+    uint32_t size = readUint32();
+    const char* buf = require(size);
+    return std::string(buf, size);
+}
+
+std::unique_ptr<Value>
+BinaryReader::readValue()
+{
+    uint8_t tag = readUint8();
+
+    if (tag == ::binary_empty_pointer)
+        return {};
+
+    switch (tag) {
+    case Value::BOOLEAN:
+        return Boolean::create(readUint8() != 0);
+    case Value::INTEGER:
+        return Integer::create(readInt32());
+    case Value::DOUBLE:
+        return Double::create(readDouble());
+    case Value::STRING:
+        return String::create(readString());
+    case Value::SET: {
+        uint32_t size = readUint32();
+        auto ret = std::unique_ptr<Set>(new Set());
+        ret->value().reserve(std::min<std::size_t>(size, m_last - m_first));
+        for (uint32_t i = 0; i != size; ++i)
+            ret->value().emplace_back(readValue());
+        return std::move(ret);
+    }
+    case Value::MAP: {
+        uint32_t size = readUint32();
+        auto ret = std::unique_ptr<Map>(new Map());
+        for (uint32_t i = 0; i != size; ++i) {
+            std::string key = readString();
+            ret->value()[key] = readValue();
+        }
+        return std::move(ret);
+    }
+    case Value::TUPLE: {
+        uint32_t size = readUint32();
+        require(std::size_t{ 8 } * size);
+        m_first -= std::size_t{ 8 } * size;
+        auto ret = std::unique_ptr<Tuple>(new Tuple(size));
+        for (auto& elem : ret->value())
+            elem = readDouble();
+        return std::move(ret);
+    }
+    case Value::TABLE: {
+        uint32_t width = readUint32();
+        uint32_t height = readUint32();
+        std::size_t size = std::size_t{ width } * height;
+        require(8 * size);
+        m_first -= 8 * size;
+        auto ret = std::unique_ptr<Table>(new Table(width, height));
+        for (auto& elem : ret->value())
+            elem = readDouble();
+        return std::move(ret);
+    }
+    case Value::XMLTYPE:
+        return Xml::create(readString());
+    case Value::NIL:
+        return Null::create();
+    case Value::MATRIX: {
+        uint32_t columns = readUint32();
+        uint32_t rows = readUint32();
+        uint32_t columnmax = readUint32();
+        uint32_t rowmax = readUint32();
+        uint32_t resizecolumns = readUint32();
+        uint32_t resizerows = readUint32();
+        if (std::size_t{ columns } * rows >
+            static_cast<std::size_t>(m_last - m_first))
+            throw utils::ArgError(_("BinaryReader: bad matrix size"));
+
+        /* An empty matrix can be built without allocation and the six
+         * parameters constructor refuses it. */
+        auto ret = std::unique_ptr<Matrix>(
+          std::size_t{ columnmax } * rowmax == 0
+            ? new Matrix(columns, rows, resizecolumns, resizerows)
+            : new Matrix(
+                columns, rows, columnmax, rowmax, resizecolumns, resizerows));
+        for (uint32_t row = 0; row != rows; ++row)
+            for (uint32_t col = 0; col != columns; ++col)
+                ret->set(col, row, readValue());
+        return std::move(ret);
+    }
+    default:
+        throw utils::ArgError(_("BinaryReader: unknown value type %d"),
+                              static_cast<int>(tag));
+    }
+}
+}
+} // namespace vle value
@@ -369,10 +369,10 @@ BaseModel::delInputPort(const std::string& name)
     for (auto& elem : lst) {
         if (elem.first != m_parent) {
             ModelPortList& toclean(elem.first->getOutPort(elem.second));
-            toclean.erase(this);
+            toclean.remove(this, name);
         } else {
             ModelPortList& toclean(m_parent->getInternalInPort(elem.second));
-            toclean.erase(this);
+            toclean.remove(this, name);
         }
     }
     if (isCoupled()) {
@@ -380,7 +380,7 @@ BaseModel::delInputPort(const std::string& name)
         ModelPortList& intern(tmp->getInternalInPort(name));
         auto jt = intern.begin();
         while (jt != intern.end()) {
-            jt->first->getInPort(jt->second).erase(this);
+            jt->first->getInPort(jt->second).remove(this, name);
             ++jt;
         }
         intern.clear();
@@ -397,10 +397,10 @@ BaseModel::delOutputPort(const std::string& name)
     for (auto& elem : lst) {
         if (elem.first != m_parent) {
             ModelPortList& toclean(elem.first->getInPort(elem.second));
-            toclean.erase(this);
+            toclean.remove(this, name);
         } else {
             ModelPortList& toclean(m_parent->getInternalOutPort(elem.second));
-            toclean.erase(this);
+            toclean.remove(this, name);
         }
     }
     if (isCoupled()) {
@@ -408,7 +408,7 @@ BaseModel::delOutputPort(const std::string& name)
         ModelPortList& intern(tmp->getInternalOutPort(name));
         auto jt = intern.begin();
         while (jt != intern.end()) {
-            jt->first->getOutPort(jt->second).erase(this);
+            jt->first->getOutPort(jt->second).remove(this, name);
             ++jt;
         }
         intern.clear();
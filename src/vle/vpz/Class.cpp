@@ -32,6 +32,11 @@
 namespace vle {
 namespace vpz {
 
+struct Class::Graph
+{
+    std::unique_ptr<BaseModel> root;
+};
+
 Class::Class(std::string name)
   : Base()
   , m_name(std::move(name))
@@ -44,8 +49,8 @@ Class::Class(const Class& cls)
   , m_node(nullptr)
 {
     if (cls.m_graph) {
-        m_graph = std::unique_ptr<BaseModel>(cls.m_graph->clone());
-        m_node = m_graph.get();
+        m_graph = cls.m_graph;
+        m_node = cls.m_node;
     } else if (cls.m_node)
         m_node = cls.m_node->clone();
 }
@@ -55,9 +60,9 @@ Class::~Class() = default;
 void
 Class::write(std::ostream& out) const
 {
-    if (m_graph) {
+    if (m_graph and m_graph->root) {
         out << "<class name=\"" << m_name.c_str() << "\" >\n";
-        m_graph->write(out);
+        m_graph->root->write(out);
         out << "</class>\n";
     }
 }
@@ -65,21 +70,44 @@ Class::write(std::ostream& out) const
 void
 Class::setGraph(std::unique_ptr<BaseModel> graph)
 {
-    assert(m_graph.get() == m_node and
+    assert((m_graph ? m_graph->root.get() : nullptr) == m_node and
            "Can not assign vpz.project.model with a node");
 
-    m_graph = std::move(graph);
-    m_node = m_graph.get();
+    m_graph = std::make_shared<Graph>();
+    m_graph->root = std::move(graph);
+    m_node = m_graph->root.get();
 }
 
 std::unique_ptr<BaseModel>
 Class::graph()
 {
-    assert(m_graph.get() == m_node and
+    assert((m_graph ? m_graph->root.get() : nullptr) == m_node and
            "Can not assign vpz.project.model with a node");
 
+    std::unique_ptr<BaseModel> ret;
+    if (m_graph) {
+        if (m_graph.use_count() == 1)
+            ret = std::move(m_graph->root);
+        else if (m_graph->root)
+            ret.reset(m_graph->root->clone());
+    }
+
+    m_graph.reset();
     m_node = nullptr;
-    return std::move(m_graph);
+    return ret;
+}
+
+void
+Class::detach()
+{
+    if (m_graph and m_graph.use_count() > 1) {
+        auto copy = std::make_shared<Graph>();
+        if (m_graph->root)
+            copy->root.reset(m_graph->root->clone());
+
+        m_graph = std::move(copy);
+        m_node = m_graph->root.get();
+    }
 }
 
 void
@@ -93,6 +121,8 @@ Class::setNode(BaseModel* mdl)
 BaseModel*
 Class::node()
 {
+    detach();
+
     return m_node;
 }
 
@@ -105,54 +135,64 @@ Class::node() const
 void
 Class::updateDynamics(const std::string& oldname, const std::string& newname)
 {
-    assert(not m_node && "Can not get node with a vpz.project.class");
+    assert(m_graph and m_graph->root && "vle::vpz::Class not used in graph");
 
-    m_graph->updateDynamics(oldname, newname);
+    detach();
+    m_graph->root->updateDynamics(oldname, newname);
 }
 
 void
 Class::purgeDynamics(const std::set<std::string>& dynamicslist)
 {
-    assert(not m_node && "Can not get node with a vpz.project.class");
+    assert(m_graph and m_graph->root && "vle::vpz::Class not used in graph");
 
-    m_graph->purgeDynamics(dynamicslist);
+    detach();
+    m_graph->root->purgeDynamics(dynamicslist);
 }
 
 void
 Class::updateObservable(const std::string& oldname, const std::string& newname)
 {
-    assert(not m_node && "Can not get node with a vpz.project.class");
-    m_graph->updateObservable(oldname, newname);
+    assert(m_graph and m_graph->root && "vle::vpz::Class not used in graph");
+
+    detach();
+    m_graph->root->updateObservable(oldname, newname);
 }
 
 void
 Class::purgeObservable(const std::set<std::string>& observablelist)
 {
-    assert(not m_node && "Can not get node with a vpz.project.class");
-    m_graph->purgeObservable(observablelist);
+    assert(m_graph and m_graph->root && "vle::vpz::Class not used in graph");
+
+    detach();
+    m_graph->root->purgeObservable(observablelist);
 }
 
 void
 Class::updateConditions(const std::string& oldname, const std::string& newname)
 {
-    assert(not m_node && "Can not get node with a vpz.project.class");
-    m_graph->updateConditions(oldname, newname);
+    assert(m_graph and m_graph->root && "vle::vpz::Class not used in graph");
+
+    detach();
+    m_graph->root->updateConditions(oldname, newname);
 }
 
 void
 Class::purgeConditions(const std::set<std::string>& conditionlist)
 {
-    assert(not m_node && "Can not get node with a vpz.project.class");
-    m_graph->purgeConditions(conditionlist);
+    assert(m_graph and m_graph->root && "vle::vpz::Class not used in graph");
+
+    detach();
+    m_graph->root->purgeConditions(conditionlist);
 }
 
 void
 Class::getAtomicModelList(std::vector<AtomicModel*>& list) const
 {
-    assert(not m_node && "Can not get node with a vpz.project.class");
+    assert(m_graph and m_graph->root && "vle::vpz::Class not used in graph");
 
     list.clear();
-    m_graph->getAtomicModelList(m_graph.get(), list);
+    m_graph->root->getAtomicModelList(m_graph->root.get(), list);
 }
 }
 } // namespace vle vpz
@@ -39,6 +39,7 @@
 #include <vle/value/Tuple.hpp>
 #include <vle/value/XML.hpp>
 #include <vle/vpz/Condition.hpp>
+#include <vle/vpz/Vpz.hpp>
 
 #include "utils/i18n.hpp"
 
@@ -54,27 +55,24 @@ namespace vpz {
 
 Condition::Condition(const std::string& name)
   : Base()
+  , m_values(std::make_shared<Values>())
   , m_name(std::move(name))
 {}
 
 Condition::Condition(const Condition& cnd)
   : Base(cnd)
+  , m_values(cnd.m_values)
   , m_name(cnd.m_name)
   , m_last_port(cnd.m_last_port)
   , m_ispermanent(cnd.m_ispermanent)
-{
-    for (auto& elem : cnd.m_list) {
-        auto& init = m_list[elem.first];
-        init = std::move(value::clone(elem.second));
-    }
-}
+{}
 
 Condition&
 Condition::operator=(const Condition& cnd)
 {
     Condition tmp(cnd);
 
-    std::swap(m_list, tmp.m_list);
+    std::swap(m_values, tmp.m_values);
     std::swap(m_name, tmp.m_name);
     std::swap(m_last_port, tmp.m_last_port);
     std::swap(m_ispermanent, tmp.m_ispermanent);
@@ -85,14 +83,19 @@ Condition::operator=(const Condition& cnd)
 void
 Condition::write(std::ostream& out) const
 {
+    std::lock_guard<std::mutex> lock(m_values->mutex);
+
     out << "<condition name=\"" << m_name.c_str() << "\" >\n";
 
-    for (const auto& elem : m_list) {
+    for (const auto& elem : m_values->list) {
         out << " <port "
             << "name=\"" << elem.first.c_str() << "\" "
             << ">\n";
+        auto lazy = m_values->lazy.find(elem.first);
         auto& v = elem.second;
-        if (v.get()) {
+        if (lazy != m_values->lazy.end()) {
+            out << *lazy->second << '\n';
+        } else if (v.get()) {
             v->writeXml(out);
             out << '\n';
         }
@@ -104,10 +107,10 @@ Condition::write(std::ostream& out) const
 std::vector<std::string>
 Condition::portnames() const
 {
-    std::vector<std::string> lst(m_list.size());
+    std::vector<std::string> lst(m_values->list.size());
 
-    std::transform(m_list.begin(),
-                   m_list.end(),
+    std::transform(m_values->list.begin(),
+                   m_values->list.end(),
                    lst.begin(),
                    [](const value_type& v) { return v.first; });
 
@@ -117,65 +120,175 @@ Condition::portnames() const
 bool
 Condition::exist(const std::string& portname) const
 {
-    return m_list.find(portname) != m_list.end();
+    return m_values->list.find(portname) != m_values->list.end();
 }
 
 void
 Condition::add(const std::string& portname)
 {
-    m_list[portname] = std::shared_ptr<value::Value>(nullptr);
+    auto& v = values();
+
+    v.list[portname] = std::shared_ptr<value::Value>(nullptr);
+    v.lazy.erase(portname);
+    v.has_lazy = not v.lazy.empty();
     m_last_port.assign(portname);
 }
 
 void
 Condition::del(const std::string& portname)
 {
-    m_list.erase(portname);
+    auto& v = values();
+
+    v.list.erase(portname);
+    v.lazy.erase(portname);
+    v.has_lazy = not v.lazy.empty();
 }
 
 void
 Condition::setValueToPort(const std::string& portname,
                           std::shared_ptr<value::Value> value)
 {
-    auto& v = m_list[portname];
-    v = value;
+    auto& v = values();
+
+    v.list[portname] = std::move(value);
+    v.lazy.erase(portname);
+    v.has_lazy = not v.lazy.empty();
     m_last_port.assign(portname);
 }
 
 void
 Condition::clearValueOfPort(const std::string& portname)
 {
-    auto it = m_list.find(portname);
+    auto& v = values();
+    auto it = v.list.find(portname);
 
-    if (it == m_list.end())
+    if (it == v.list.end())
         throw utils::ArgError(
           _("Condition %s have no port %s"), m_name.c_str(), portname.c_str());
     it->second.reset();
+    v.lazy.erase(portname);
+    v.has_lazy = not v.lazy.empty();
 }
 
 const std::shared_ptr<value::Value>&
 Condition::valueOfPort(const std::string& portname) const
 {
-    auto it = m_list.find(portname);
+    auto it = m_values->list.find(portname);
 
-    if (it == m_list.end()) {
+    if (it == m_values->list.end()) {
         throw utils::ArgError(
           _("Condition %s have no port %s"), m_name.c_str(), portname.c_str());
     }
+
+    parseLazyValue(portname);
+
     return it->second;
 }
 
 std::shared_ptr<value::Value>&
-Condition::lastAddedPort()
+Condition::valueOfPort(const std::string& portname)
+{
+    if (m_values->list.find(portname) == m_values->list.end()) {
+        throw utils::ArgError(
+          _("Condition %s have no port %s"), m_name.c_str(), portname.c_str());
+    }
+
+    parseLazyValue(portname);
+
+    return values().list[portname];
+}
+
+void
+Condition::setLazyValueToPort(const std::string& portname,
+                              std::shared_ptr<const std::string> xml)
+{
+    auto& v = values();
+
+    v.list[portname].reset();
+    v.lazy[portname] = std::move(xml);
+    v.has_lazy = true;
+    m_last_port.assign(portname);
+}
+
+Condition::size_type
+Condition::lazyPortsSize() const
 {
-    auto it = m_list.find(m_last_port);
+    std::lock_guard<std::mutex> lock(m_values->mutex);
 
-    if (it == m_list.end()) {
+    return m_values->lazy.size();
+}
+
+void
+Condition::parseLazyValue(const std::string& portname) const
+{
+    if (not m_values->has_lazy)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_values->mutex);
+
+    auto it = m_values->lazy.find(portname);
+    if (it == m_values->lazy.end())
+        return;
+
+    auto value = Vpz::parseValue(*it->second);
+    m_values->list[portname] = std::move(value);
+    m_values->lazy.erase(it);
+    m_values->has_lazy = not m_values->lazy.empty();
+}
+
+void
+Condition::parseLazyValues() const
+{
+    if (not m_values->has_lazy)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_values->mutex);
+
+    while (not m_values->lazy.empty()) {
+        auto it = m_values->lazy.begin();
+        auto value = Vpz::parseValue(*it->second);
+        m_values->list[it->first] = std::move(value);
+        m_values->lazy.erase(it);
+    }
+
+    m_values->has_lazy = false;
+}
+
+Condition::Values&
+Condition::values()
+{
+    if (m_values.use_count() == 1)
+        return *m_values;
+
+    /* Values are shared with a copy: clone the parsed values and share the
+     * XML of the unparsed ones. */
+    auto copy = std::make_shared<Values>();
+    {
+        std::lock_guard<std::mutex> lock(m_values->mutex);
+
+        copy->lazy = m_values->lazy;
+        copy->has_lazy = not copy->lazy.empty();
+        copy->list.reserve(m_values->list.size());
+        for (const auto& elem : m_values->list)
+            copy->list.emplace(elem.first, value::clone(elem.second));
+    }
+
+    m_values = std::move(copy);
+    return *m_values;
+}
+
+std::shared_ptr<value::Value>&
+Condition::lastAddedPort()
+{
+    if (m_values->list.find(m_last_port) == m_values->list.end()) {
         throw utils::ArgError(_("Condition %s have no port %s"),
                               m_name.c_str(),
                               m_last_port.c_str());
     }
-    return it->second;
+
+    parseLazyValue(m_last_port);
+
+    return values().list[m_last_port];
 }
 
 }
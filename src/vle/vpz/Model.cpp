@@ -32,6 +32,11 @@
 namespace vle {
 namespace vpz {
 
+struct Model::Graph
+{
+    std::unique_ptr<BaseModel> root;
+};
+
 Model::Model()
   : Base()
 {}
@@ -41,8 +46,8 @@ Model::Model(const Model& mdl)
   , m_node(nullptr)
 {
     if (mdl.m_graph) {
-        m_graph = std::unique_ptr<BaseModel>(mdl.m_graph->clone());
-        m_node = m_graph.get();
+        m_graph = mdl.m_graph;
+        m_node = mdl.m_node;
     } else if (mdl.m_node)
         m_node = mdl.m_node->clone();
 }
@@ -54,7 +59,7 @@ Model::write(std::ostream& out) const
 {
     if (m_graph) {
         out << "<structures>\n";
-        m_graph->write(out);
+        m_graph->root->write(out);
         out << "</structures>\n";
     }
 }
@@ -69,21 +74,44 @@ Model::clear()
 void
 Model::setGraph(std::unique_ptr<BaseModel> graph)
 {
-    assert(m_graph.get() == m_node and
+    assert((m_graph ? m_graph->root.get() : nullptr) == m_node and
            "Can not assign vpz.project.model with a node");
 
-    m_graph = std::move(graph);
-    m_node = m_graph.get();
+    m_graph = std::make_shared<Graph>();
+    m_graph->root = std::move(graph);
+    m_node = m_graph->root.get();
 }
 
 std::unique_ptr<BaseModel>
 Model::graph()
 {
-    assert(m_graph.get() == m_node and
+    assert((m_graph ? m_graph->root.get() : nullptr) == m_node and
            "Can not assign vpz.project.model with a node");
 
+    std::unique_ptr<BaseModel> ret;
+    if (m_graph) {
+        if (m_graph.use_count() == 1)
+            ret = std::move(m_graph->root);
+        else if (m_graph->root)
+            ret.reset(m_graph->root->clone());
+    }
+
+    m_graph.reset();
     m_node = nullptr;
-    return std::move(m_graph);
+    return ret;
+}
+
+void
+Model::detach()
+{
+    if (m_graph and m_graph.use_count() > 1) {
+        auto copy = std::make_shared<Graph>();
+        if (m_graph->root)
+            copy->root.reset(m_graph->root->clone());
+
+        m_graph = std::move(copy);
+        m_node = m_graph->root.get();
+    }
 }
 
 void
@@ -97,6 +125,8 @@ Model::setNode(BaseModel* mdl)
 BaseModel*
 Model::node()
 {
+    detach();
+
     return m_node;
 }
 
@@ -109,58 +139,64 @@ Model::node() const
 void
 Model::updateDynamics(const std::string& oldname, const std::string& newname)
 {
-    assert(not m_node and m_graph and "vle::vpz::Model not used in graph");
+    assert(m_graph and m_graph->root and "vle::vpz::Model not used in graph");
 
-    m_graph->updateDynamics(oldname, newname);
+    detach();
+    m_graph->root->updateDynamics(oldname, newname);
 }
 
 void
 Model::purgeDynamics(const std::set<std::string>& dynamicslist)
 {
-    assert(not m_node and m_graph and "vle::vpz::Model not used in graph");
+    assert(m_graph and m_graph->root and "vle::vpz::Model not used in graph");
 
-    m_graph->purgeDynamics(dynamicslist);
+    detach();
+    m_graph->root->purgeDynamics(dynamicslist);
 }
 
 void
 Model::updateObservable(const std::string& oldname, const std::string& newname)
 {
-    assert(not m_node and m_graph and "vle::vpz::Model not used in graph");
+    assert(m_graph and m_graph->root and "vle::vpz::Model not used in graph");
 
-    m_graph->updateObservable(oldname, newname);
+    detach();
+    m_graph->root->updateObservable(oldname, newname);
 }
 
 void
 Model::purgeObservable(const std::set<std::string>& observablelist)
 {
-    assert(not m_node and m_graph and "vle::vpz::Model not used in graph");
+    assert(m_graph and m_graph->root and "vle::vpz::Model not used in graph");
 
-    m_graph->purgeObservable(observablelist);
+    detach();
+    m_graph->root->purgeObservable(observablelist);
 }
 
 void
 Model::updateConditions(const std::string& oldname, const std::string& newname)
 {
-    assert(not m_node and m_graph and "vle::vpz::Model not used in graph");
+    assert(m_graph and m_graph->root and "vle::vpz::Model not used in graph");
 
-    m_graph->updateConditions(oldname, newname);
+    detach();
+    m_graph->root->updateConditions(oldname, newname);
 }
 
 void
 Model::purgeConditions(const std::set<std::string>& conditionlist)
 {
-    assert(not m_node and m_graph and "vle::vpz::Model not used in graph");
+    assert(m_graph and m_graph->root and "vle::vpz::Model not used in graph");
 
-    m_graph->purgeConditions(conditionlist);
+    detach();
+    m_graph->root->purgeConditions(conditionlist);
 }
 
 void
 Model::getAtomicModelList(std::vector<AtomicModel*>& list) const
 {
-    assert(not m_node and m_graph and "vle::vpz::Model not used in graph");
+    assert(m_graph and m_graph->root and "vle::vpz::Model not used in graph");
 
     list.clear();
-    m_graph->getAtomicModelList(m_graph.get(), list);
+    m_graph->root->getAtomicModelList(m_graph->root.get(), list);
 }
 
 BaseModel*
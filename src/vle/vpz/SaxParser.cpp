@@ -43,17 +43,21 @@
 
 #include "utils/i18n.hpp"
 #include "vpz/SaxParser.hpp"
+#include "vpz/VpzBinary.hpp"
+#include "vpz/VpzCompression.hpp"
 
 #include <fstream>
 #include <sstream>
 #include <utility>
 
 #include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/cast.hpp>
 #include <boost/spirit/include/qi.hpp>
 
+#include <cctype>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
@@ -170,6 +174,7 @@ SaxParser::SaxParser(Vpz& vpz)
   : m_ctxt(nullptr)
   , m_vpzstack(vpz)
   , m_vpz(vpz)
+  , m_document(nullptr)
   , m_isValue(false)
   , m_isVPZ(false)
 {}
@@ -181,10 +186,20 @@ struct parser_data
 
     bool is_in_cdata_section = false;
 
+    /* When the whole document is available, the content of the condition
+     * ports is skipped and stored as XML. skip_depth counts the opened
+     * elements into the port, lazy_begin is the offset of the first byte
+     * after the <port> tag. */
+    bool lazy = false;
+    int skip_depth = 0;
+    XML_Index lazy_begin = 0;
+    std::string lazy_port;
+
     parser_data(std::shared_ptr<XML_ParserStruct> parser_, SaxParser& sax_)
       : parser(parser_)
       , sax(sax_)
       , is_in_cdata_section(false)
+      , lazy(sax_.document() != nullptr)
     {
         sax.clear();
     }
@@ -212,6 +227,11 @@ XML_StartElementHandler(void* userData,
 {
     auto* sax = static_cast<parser_data*>(userData);
 
+    if (sax->skip_depth > 0) {
+        ++sax->skip_depth;
+        return;
+    }
+
     sax->sax.clearLastCharactersStored();
 
     auto it = starts().find(name);
@@ -220,9 +240,53 @@ XML_StartElementHandler(void* userData,
             (sax->sax.*(it->second))(atts);
         } catch (const std::exception& e) {
             sax->stop_parser(e.what());
+            return;
         }
     } else {
         sax->stop_parser(utils::format(_("Unknown tag '%s'"), name));
+        return;
+    }
+
+    if (sax->lazy and std::strcmp(name, "port") == 0 and
+        sax->sax.isConditionPort()) {
+        if (auto parser = sax->parser.lock()) {
+            sax->skip_depth = 1;
+            sax->lazy_begin = XML_GetCurrentByteIndex(parser.get()) +
+                              XML_GetCurrentByteCount(parser.get());
+            sax->lazy_port.clear();
+
+            for (int i = 0; atts[i] != nullptr; i += 2)
+                if (std::strcmp(atts[i], "name") == 0)
+                    sax->lazy_port = atts[i + 1];
+        }
+    }
+}
+
+static void
+XML_EndLazyPort(parser_data* sax)
+{
+    auto parser = sax->parser.lock();
+    if (not parser)
+        return;
+
+    XML_Index end = XML_GetCurrentByteIndex(parser.get());
+    const char* first = sax->sax.document() + sax->lazy_begin;
+    const char* last = sax->sax.document() + end;
+
+    while (first < last and std::isspace(static_cast<unsigned char>(*first)))
+        ++first;
+
+    while (first < last and
+           std::isspace(static_cast<unsigned char>(*(last - 1))))
+        --last;
+
+    if (first < last) {
+        try {
+            sax->sax.onLazyConditionPort(
+              sax->lazy_port, std::make_shared<const std::string>(first, last));
+        } catch (const std::exception& e) {
+            sax->stop_parser(e.what());
+        }
     }
 }
 
@@ -231,6 +295,13 @@ XML_EndElementHandler(void* userData, const XML_Char* name)
 {
     auto* sax = static_cast<parser_data*>(userData);
 
+    if (sax->skip_depth > 0) {
+        if (--sax->skip_depth == 0)
+            XML_EndLazyPort(sax);
+
+        return;
+    }
+
     auto it = ends().find(name);
     if (it != ends().end()) {
         try {
@@ -248,6 +319,9 @@ XML_CharacterDataHandler(void* userData, const XML_Char* s, int len)
 {
     auto* sax = static_cast<parser_data*>(userData);
 
+    if (sax->skip_depth > 0)
+        return;
+
     if (sax->is_in_cdata_section) {
         sax->sax.addToCdata(std::string(s, len));
     } else {
@@ -271,6 +345,21 @@ XML_EndCdataSectionHandler(void* userData)
     sax->is_in_cdata_section = false;
 }
 
+/* The XML of the condition values is parsed again without the XML
+ * declaration, only UTF-8 (and ASCII) documents can use lazy values. */
+static void
+XML_XmlDeclHandler(void* userData,
+                   const XML_Char* /*version*/,
+                   const XML_Char* encoding,
+                   int /*standalone*/)
+{
+    auto* sax = static_cast<parser_data*>(userData);
+
+    if (encoding and not boost::algorithm::iequals(encoding, "UTF-8") and
+        not boost::algorithm::iequals(encoding, "US-ASCII"))
+        sax->lazy = false;
+}
+
 static std::shared_ptr<XML_ParserStruct>
 create_parser()
 {
@@ -291,6 +380,7 @@ SaxParser::parse(std::istream& is, std::size_t buffer_size)
     XML_SetUserData(parser.get(), reinterpret_cast<void*>(&data));
     XML_SetCdataSectionHandler(
       parser.get(), XML_StartCdataSectionHandler, XML_EndCdataSectionHandler);
+    XML_SetXmlDeclHandler(parser.get(), XML_XmlDeclHandler);
 
     enum class sax_parser_status
     {
@@ -343,23 +433,91 @@ SaxParser::parse(std::istream& is, std::size_t buffer_size)
     }
 }
 
+/* A read-only std::streambuf on a memory buffer. */
+struct memory_streambuf : public std::streambuf
+{
+    memory_streambuf(const char* buffer, std::size_t size)
+    {
+        auto* ptr = const_cast<char*>(buffer);
+        setg(ptr, ptr, ptr + size);
+    }
+};
+
 void
 SaxParser::parseFile(const std::string& filename)
 {
-    std::ifstream ifs(filename);
-    if (not ifs.is_open())
+    std::unique_ptr<MappedFile> file;
+
+    try {
+        file = std::make_unique<MappedFile>(filename);
+    } catch (const std::exception& /*e*/) {
         throw utils::SaxParserError(_("Error opening file `%s'"),
                                     filename.c_str());
+    }
 
-    parse(ifs, BUFSIZ);
+    parseDocument(file->begin(), file->end());
 }
 
 void
 SaxParser::parseMemory(const std::string& buffer)
 {
-    std::istringstream iss(buffer);
+    parseDocument(buffer.data(), buffer.data() + buffer.size());
+}
+
+void
+SaxParser::parseDocument(const char* first, const char* last)
+{
+    auto compression = vpz_compression_detect(first, last);
+
+    if (compression != vpz_compression::none) {
+        /* The document is decompressed by chunks while parsing, lazy values
+         * are not available without the whole document in memory. */
+        std::unique_ptr<decompress_streambuf> buf;
+        try {
+            buf = std::make_unique<decompress_streambuf>(
+              compression, first, last);
+        } catch (const std::exception& e) {
+            throw utils::SaxParserError(_("%s"), e.what());
+        }
+
+        std::istream is(buf.get());
+        is.exceptions(std::ios::badbit);
+
+        try {
+            parse(is, BUFSIZ);
+        } catch (const utils::SaxParserError& /*e*/) {
+            throw;
+        } catch (const std::exception& e) {
+            throw utils::SaxParserError(_("%s"), e.what());
+        }
+        return;
+    }
+
+    memory_streambuf buf(first, static_cast<std::size_t>(last - first));
+    std::istream is(&buf);
+
+    m_document = first;
+    try {
+        parse(is, BUFSIZ);
+    } catch (...) {
+        m_document = nullptr;
+        throw;
+    }
+    m_document = nullptr;
+}
+
+bool
+SaxParser::isConditionPort() const
+{
+    return m_isVPZ and m_vpzstack.top()->isCondition();
+}
 
-    parse(iss, BUFSIZ);
+void
+SaxParser::onLazyConditionPort(const std::string& port,
+                               std::shared_ptr<const std::string> xml)
+{
+    auto* cnd = static_cast<vpz::Condition*>(m_vpzstack.top());
+    cnd->setLazyValueToPort(port, std::move(xml));
 }
 
 void
@@ -61,14 +61,21 @@ public:
     virtual ~SaxParser() = default;
 
     /**
-     * @brief Open the VPZ file and parse it with @c parse function.
+     * @brief Open the VPZ file and parse it with @c parse function. The
+     * file is mapped in memory and the values of the conditions are not
+     * built but stored as XML into the vpz::Condition (see
+     * vpz::Condition::setLazyValueToPort). Files compressed with gzip or
+     * zstd are decompressed by chunks while parsing, their condition
+     * values are built immediately.
      * @param filename The name of the file to parse.
      * @throw utils::SaxError if the file is not readable.
      */
     void parseFile(const std::string& filename);
 
     /**
-     * @brief Open the VPZ file and parse it with @c parse function.
+     * @brief Open the VPZ file and parse it with @c parse function. Like
+     * @c parseFile, the values of the conditions are stored as XML and
+     * compressed buffers are decompressed by chunks.
      * @param buffer the buffer to process.
      * @throw utils::SaxError if the buffer is not readable.
      */
@@ -189,6 +196,28 @@ public:
      */
     void stopParser(const std::string& error);
 
+    /**
+     * @brief Get the buffer of the whole XML document, if available, to
+     * extract the XML of the condition values.
+     * @return A pointer to the document or nullptr.
+     */
+    const char* document() const
+    {
+        return m_document;
+    }
+
+    /**
+     * @brief Return true if the parser is in a port of a condition.
+     */
+    bool isConditionPort() const;
+
+    /**
+     * @brief Assign to the latest port of the current condition its XML
+     * representation.
+     */
+    void onLazyConditionPort(const std::string& port,
+                             std::shared_ptr<const std::string> xml);
+
     void onBoolean(const char** att);
     void onInteger(const char** att);
     void onDouble(const char** att);
@@ -272,6 +301,10 @@ public:
     std::string error() const;
 
 private:
+    /* Parse the document between first and last, decompress it if it
+     * starts with a gzip or zstd magic number. */
+    void parseDocument(const char* first, const char* last);
+
     void* m_ctxt;
     std::string m_error;
     SaxStackVpz m_vpzstack;
@@ -279,6 +312,7 @@ private:
     std::string m_lastCharacters;
     std::string m_cdata;
     Vpz& m_vpz;
+    const char* m_document;
 
     bool m_isValue;
     bool m_isVPZ;
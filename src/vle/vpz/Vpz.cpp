@@ -25,13 +25,19 @@
  */
 
 #include <vle/utils/Exception.hpp>
+#include <vle/utils/Filesystem.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/vle.hpp>
 #include <vle/vpz/Vpz.hpp>
 
 #include "utils/i18n.hpp"
 #include "vpz/SaxParser.hpp"
+#include "vpz/VpzBinary.hpp"
+#include "vpz/VpzCompression.hpp"
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <limits>
@@ -61,21 +67,126 @@ Vpz::write(std::ostream& out) const
     m_project.write(out);
 }
 
+void
+Vpz::setDefaultSimulationEngine()
+{
+    auto& cnd = project().experiment().conditions().get(
+      Experiment::defaultSimulationEngineCondName());
+
+    if (not cnd.valueOfPort("begin").get()) {
+        cnd.setValueToPort("begin", value::Double::create(0));
+        cnd.setValueToPort("duration", value::Double::create(100));
+    }
+}
+
 void
 Vpz::parseFile(const std::string& filename)
 {
     clear();
     m_filename.assign(filename);
 
+    bool compiled;
+    bool compressed;
+    {
+        MappedFile file(filename);
+        compiled = vpz_binary_is_compiled(file.begin(), file.end());
+        compressed = vpz_compression_detect(file.begin(), file.end()) !=
+                     vpz_compression::none;
+        if (compiled)
+            vpz_binary_read(*this, file.begin(), file.end());
+    }
+
+    if (not compiled) {
+        vpz::SaxParser saxparser(*this);
+        saxparser.parseFile(filename);
+    }
+
+    m_isGzip = compressed;
+    setDefaultSimulationEngine();
+}
+
+void
+Vpz::parseFileCached(const std::string& filename)
+{
+    clear();
+    m_filename.assign(filename);
+
+    uint64_t hash;
+    {
+        MappedFile file(filename);
+        if (vpz_binary_is_compiled(file.begin(), file.end())) {
+            vpz_binary_read(*this, file.begin(), file.end());
+            setDefaultSimulationEngine();
+            return;
+        }
+
+        hash = vpz_content_hash(file.begin(), file.end());
+    }
+
+    const std::string cache = compiledFilename(filename);
+    if (utils::Path::is_file(cache)) {
+        try {
+            MappedFile file(cache);
+            if (vpz_binary_is_fresh(file.begin(), file.end(), hash)) {
+                vpz_binary_read(*this, file.begin(), file.end());
+                setDefaultSimulationEngine();
+                return;
+            }
+        } catch (const std::exception& /*e*/) {
+            clear();
+            m_filename.assign(filename);
+        }
+    }
+
     vpz::SaxParser saxparser(*this);
     saxparser.parseFile(filename);
 
-    auto& cnd = project().experiment().conditions().get(
-      Experiment::defaultSimulationEngineCondName());
+    try {
+        writeCompiledFile(cache, hash);
+    } catch (const std::exception& /*e*/) {
+    }
 
-    if (not cnd.valueOfPort("begin").get()) {
-        cnd.setValueToPort("begin", value::Double::create(0));
-        cnd.setValueToPort("duration", value::Double::create(100));
+    setDefaultSimulationEngine();
+}
+
+void
+Vpz::writeCompiled(const std::string& filename) const
+{
+    writeCompiledFile(filename, 0);
+}
+
+void
+Vpz::writeCompiledFile(const std::string& filename, uint64_t hash) const
+{
+    std::string buffer;
+    vpz_binary_write(*this, hash, buffer);
+
+    utils::Path tmp = utils::Path::unique_path(filename + "-%%%%-%%%%");
+    {
+        std::ofstream out(tmp.string(), std::ios::binary);
+        if (not out.is_open())
+            throw utils::FileError(
+              _("Vpz: cannot open file '%s' for writing"),
+              tmp.string().c_str());
+
+        out.write(buffer.data(), buffer.size());
+        out.close();
+
+        if (out.fail()) {
+            tmp.remove();
+            throw utils::FileError(_("Vpz: fail to write file '%s'"),
+                                   tmp.string().c_str());
+        }
+    }
+
+    /* std::rename replaces the destination atomically on POSIX systems,
+     * Win32 refuses to replace an existing file. */
+    if (std::rename(tmp.string().c_str(), filename.c_str()) != 0 and
+        (std::remove(filename.c_str()) != 0 or
+         std::rename(tmp.string().c_str(), filename.c_str()) != 0)) {
+        tmp.remove();
+        throw utils::FileError(_("Vpz: fail to write file '%s'"),
+                               filename.c_str());
     }
 }
 
@@ -88,13 +199,7 @@ Vpz::parseMemory(const std::string& buffer)
     vpz::SaxParser saxparser(*this);
     saxparser.parseMemory(buffer);
 
-    auto& cnd = project().experiment().conditions().get(
-      Experiment::defaultSimulationEngineCondName());
-
-    if (not cnd.valueOfPort("begin").get()) {
-        cnd.setValueToPort("begin", value::Double::create(0));
-        cnd.setValueToPort("duration", value::Double::create(100));
-    }
+    setDefaultSimulationEngine();
 }
 
 std::shared_ptr<value::Value>
@@ -115,16 +220,52 @@ Vpz::parseValue(const std::string& buffer)
 void
 Vpz::write()
 {
-    std::ofstream out(m_filename.c_str());
+    auto compression = vpz_compression_from_filename(m_filename);
+    if (compression == vpz_compression::none) {
+        std::ofstream out(m_filename.c_str());
+
+        if (out.fail() or out.bad()) {
+            throw utils::FileError(
+              _("Vpz: cannot open file '%s' for writing"),
+              m_filename.c_str());
+        }
+
+        out << std::showpoint << std::fixed
+            << std::setprecision(std::numeric_limits<double>::digits10)
+            << *this;
+        m_isGzip = false;
+        return;
+    }
+
+    if (not vpz_compression_is_available(compression))
+        throw utils::FileError(
+          _("Vpz: cannot write file '%s', compression is not available"),
+          m_filename.c_str());
 
+    std::ofstream out(m_filename.c_str(), std::ios::binary);
     if (out.fail() or out.bad()) {
         throw utils::FileError(_("Vpz: cannot open file '%s' for writing"),
                                m_filename.c_str());
-        ;
     }
 
-    out << std::showpoint << std::fixed
-        << std::setprecision(std::numeric_limits<double>::digits10) << *this;
+    compress_streambuf buf(compression, out.rdbuf());
+    std::ostream os(&buf);
+
+    os << std::showpoint << std::fixed
+       << std::setprecision(std::numeric_limits<double>::digits10) << *this;
+
+    if (os.fail())
+        throw utils::FileError(_("Vpz: fail to write file '%s'"),
+                               m_filename.c_str());
+
+    buf.finish();
+    out.close();
+
+    if (out.fail())
+        throw utils::FileError(_("Vpz: fail to write file '%s'"),
+                               m_filename.c_str());
+
+    m_isGzip = true;
 }
 
 void
@@ -153,9 +294,36 @@ Vpz::clear()
     m_isGzip = false;
 }
 
+std::string
+Vpz::compiledFilename(const std::string& filename)
+{
+    if (filename.size() >= 4 and
+        filename.compare(filename.size() - 4, 4, ".vpz") == 0)
+        return filename + 'c';
+
+    return filename + ".vpzc";
+}
+
+bool
+Vpz::isCompiledCacheEnabled()
+{
+    const char* env = std::getenv("VLE_VPZ_CACHE");
+
+    return env and *env and std::strcmp(env, "0") != 0;
+}
+
 void
 Vpz::fixExtension(std::string& filename)
 {
+    if (vpz_compression_from_filename(filename) != vpz_compression::none) {
+        const std::string::size_type dot = filename.find_last_of('.');
+        std::string extension(filename, dot);
+        filename.erase(dot);
+        fixExtension(filename);
+        filename += extension;
+        return;
+    }
+
     const std::string::size_type dot = filename.find_last_of('.');
     if (dot == std::string::npos) {
         filename += ".vpz";
@@ -0,0 +1,552 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Exception.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "utils/i18n.hpp"
+#include "vpz/VpzBinary.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/*
+ * The compiled file starts with a fixed size header:
+ *  - 8 bytes: magic number,
+ *  - 4 bytes: format version,
+ *  - 8 bytes: FNV-1a hash of the XML source (0 if unknown).
+ * The project follows, encoded with the value::BinaryWriter primitives.
+ */
+const char vpz_binary_magic[8] = { 'V', 'L', 'E', 'V', 'P', 'Z', 'C', '\0' };
+const uint32_t vpz_binary_version = 1;
+const std::size_t vpz_binary_header_size = 8 + 4 + 8;
+
+enum vpz_binary_model_type : uint8_t
+{
+    vpz_binary_atomic = 0,
+    vpz_binary_coupled = 1
+};
+
+enum vpz_binary_connection_type : uint8_t
+{
+    vpz_binary_input = 0,
+    vpz_binary_output = 1,
+    vpz_binary_internal = 2
+};
+
+void
+write_ports(vle::value::BinaryWriter& out, const vle::vpz::ConnectionList& lst)
+{
+    out.writeUint32(static_cast<uint32_t>(lst.size()));
+    for (const auto& elem : lst)
+        out.writeString(elem.first);
+}
+
+void
+write_model(vle::value::BinaryWriter& out, const vle::vpz::BaseModel* mdl)
+{
+    out.writeUint8(mdl->isAtomic() ? vpz_binary_atomic : vpz_binary_coupled);
+    out.writeString(mdl->getName());
+    out.writeInt32(mdl->x());
+    out.writeInt32(mdl->y());
+    out.writeInt32(mdl->width());
+    out.writeInt32(mdl->height());
+    write_ports(out, mdl->getInputPortList());
+    write_ports(out, mdl->getOutputPortList());
+
+    if (mdl->isAtomic()) {
+        const auto* atom = static_cast<const vle::vpz::AtomicModel*>(mdl);
+        out.writeUint32(static_cast<uint32_t>(atom->conditions().size()));
+        for (const auto& elem : atom->conditions())
+            out.writeString(elem);
+        out.writeString(atom->dynamics());
+        out.writeString(atom->observables());
+        out.writeUint8(atom->needDebug() ? 1 : 0);
+        return;
+    }
+
+    const auto* cpl = static_cast<const vle::vpz::CoupledModel*>(mdl);
+    out.writeUint32(static_cast<uint32_t>(cpl->getModelList().size()));
+    for (const auto& elem : cpl->getModelList())
+        write_model(out, elem.second);
+
+    /* Same traversal than CoupledModel::writeConnections. */
+    std::string connections;
+    vle::value::BinaryWriter cnt(connections);
+    uint32_t nb = 0;
+
+    for (const auto& port : cpl->getInternalOutputPortList()) {
+        for (const auto& dst : port.second) {
+            cnt.writeUint8(vpz_binary_output);
+            cnt.writeString(dst.first->getName());
+            cnt.writeString(dst.second);
+            cnt.writeString(port.first);
+            ++nb;
+        }
+    }
+
+    for (const auto& port : cpl->getInternalInputPortList()) {
+        for (const auto& dst : port.second) {
+            cnt.writeUint8(vpz_binary_input);
+            cnt.writeString(port.first);
+            cnt.writeString(dst.first->getName());
+            cnt.writeString(dst.second);
+            ++nb;
+        }
+    }
+
+    for (const auto& child : cpl->getModelList()) {
+        for (const auto& port : child.second->getOutputPortList()) {
+            for (const auto& dst : port.second) {
+                if (dst.first != cpl) {
+                    cnt.writeUint8(vpz_binary_internal);
+                    cnt.writeString(child.first);
+                    cnt.writeString(port.first);
+                    cnt.writeString(dst.first->getName());
+                    cnt.writeString(dst.second);
+                    ++nb;
+                }
+            }
+        }
+    }
+
+    out.writeUint32(nb);
+    out.buffer().append(connections);
+}
+
+void
+read_model_body(vle::value::BinaryReader& in,
+                vle::vpz::BaseModel* mdl,
+                uint8_t type);
+
+vle::vpz::BaseModel*
+read_model(vle::value::BinaryReader& in, vle::vpz::CoupledModel* parent)
+{
+    uint8_t type = in.readUint8();
+    std::string name = in.readString();
+    vle::vpz::BaseModel* mdl = nullptr;
+
+    if (type == vpz_binary_atomic)
+        mdl = new vle::vpz::AtomicModel(name, parent);
+    else if (type == vpz_binary_coupled)
+        mdl = new vle::vpz::CoupledModel(name, parent);
+    else
+        throw vle::utils::ArgError(_("Compiled vpz: unknown model type"));
+
+    if (not parent) {
+        std::unique_ptr<vle::vpz::BaseModel> guard(mdl);
+        read_model_body(in, mdl, type);
+        return guard.release();
+    }
+
+    read_model_body(in, mdl, type);
+    return mdl;
+}
+
+void
+read_model_body(vle::value::BinaryReader& in,
+                vle::vpz::BaseModel* mdl,
+                uint8_t type)
+{
+    int x = in.readInt32();
+    int y = in.readInt32();
+    int width = in.readInt32();
+    int height = in.readInt32();
+
+    mdl->setX(x);
+    mdl->setY(y);
+    mdl->setWidth(width);
+    mdl->setHeight(height);
+
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i)
+        mdl->addInputPort(in.readString());
+
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i)
+        mdl->addOutputPort(in.readString());
+
+    if (type == vpz_binary_atomic) {
+        auto* atom = static_cast<vle::vpz::AtomicModel*>(mdl);
+        std::vector<std::string> conditions(in.readUint32());
+        for (auto& elem : conditions)
+            elem = in.readString();
+
+        atom->setConditions(conditions);
+        atom->setDynamics(in.readString());
+        atom->setObservables(in.readString());
+        if (in.readUint8())
+            atom->setDebug();
+        return;
+    }
+
+    auto* cpl = static_cast<vle::vpz::CoupledModel*>(mdl);
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i)
+        read_model(in, cpl);
+
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+        uint8_t cnttype = in.readUint8();
+        std::string a = in.readString();
+        std::string b = in.readString();
+        std::string c = in.readString();
+
+        switch (cnttype) {
+        case vpz_binary_output:
+            cpl->addOutputConnection(a, b, c);
+            break;
+        case vpz_binary_input:
+            cpl->addInputConnection(a, b, c);
+            break;
+        case vpz_binary_internal:
+            cpl->addInternalConnection(a, b, c, in.readString());
+            break;
+        default:
+            throw vle::utils::ArgError(
+              _("Compiled vpz: unknown connection type"));
+        }
+    }
+}
+
+void
+write_models(vle::value::BinaryWriter& out, const vle::vpz::Project& prj)
+{
+    const auto* graph = prj.model().node();
+    out.writeUint8(graph ? 1 : 0);
+    if (graph)
+        write_model(out, graph);
+
+    const auto& dynamics = prj.dynamics().dynamiclist();
+    out.writeUint32(static_cast<uint32_t>(dynamics.size()));
+    for (const auto& elem : dynamics) {
+        out.writeString(elem.second.name());
+        out.writeString(elem.second.package());
+        out.writeString(elem.second.library());
+        out.writeString(elem.second.language());
+    }
+
+    const auto& classes = prj.classes().list();
+    out.writeUint32(static_cast<uint32_t>(classes.size()));
+    for (const auto& elem : classes) {
+        out.writeString(elem.first);
+        const auto* node = elem.second.node();
+        out.writeUint8(node ? 1 : 0);
+        if (node)
+            write_model(out, node);
+    }
+
+    const auto& exp = prj.experiment();
+    out.writeString(exp.name());
+    out.writeString(exp.combination());
+}
+
+void
+write_conditions(vle::value::BinaryWriter& out,
+                 const vle::vpz::Conditions& cnds)
+{
+    const auto& conditions = cnds.conditionlist();
+    out.writeUint32(static_cast<uint32_t>(conditions.size()));
+    for (const auto& cnd : conditions) {
+        out.writeString(cnd.first);
+        const auto& values = cnd.second.conditionvalues();
+        out.writeUint32(static_cast<uint32_t>(values.size()));
+        for (const auto& port : values) {
+            out.writeString(port.first);
+            out.writeValue(port.second.get());
+        }
+    }
+}
+
+void
+write_views(vle::value::BinaryWriter& out,
+            const vle::vpz::Views& vws,
+            bool locations = true)
+{
+    const auto& outputs = vws.outputs().outputlist();
+    out.writeUint32(static_cast<uint32_t>(outputs.size()));
+    for (const auto& elem : outputs) {
+        out.writeString(elem.second.name());
+        if (locations)
+            out.writeString(elem.second.location());
+        out.writeString(elem.second.plugin());
+        out.writeString(elem.second.package());
+        out.writeValue(elem.second.data().get());
+    }
+
+    const auto& views = vws.viewlist();
+    out.writeUint32(static_cast<uint32_t>(views.size()));
+    for (const auto& elem : views) {
+        out.writeString(elem.second.name());
+        out.writeUint32(static_cast<uint32_t>(elem.second.type()));
+        out.writeString(elem.second.output());
+        out.writeDouble(elem.second.timestep());
+        out.writeUint8(elem.second.is_enable() ? 1 : 0);
+    }
+
+    const auto& observables = vws.observables().observablelist();
+    out.writeUint32(static_cast<uint32_t>(observables.size()));
+    for (const auto& obs : observables) {
+        out.writeString(obs.first);
+        const auto& ports = obs.second.observableportlist();
+        out.writeUint32(static_cast<uint32_t>(ports.size()));
+        for (const auto& port : ports) {
+            out.writeString(port.first);
+            const auto& views = port.second.viewnamelist();
+            out.writeUint32(static_cast<uint32_t>(views.size()));
+            for (const auto& view : views)
+                out.writeString(view);
+        }
+    }
+}
+
+void
+write_project(vle::value::BinaryWriter& out, const vle::vpz::Project& prj)
+{
+    out.writeString(prj.author());
+    out.writeString(prj.date());
+    out.writeString(prj.version());
+    out.writeUint64(static_cast<uint64_t>(prj.instance()));
+
+    write_models(out, prj);
+    write_conditions(out, prj.experiment().conditions());
+    write_views(out, prj.experiment().views());
+}
+
+void
+read_project(vle::value::BinaryReader& in, vle::vpz::Project& prj)
+{
+    std::string author = in.readString();
+    if (not author.empty())
+        prj.setAuthor(author);
+
+    std::string date = in.readString();
+    if (not date.empty())
+        prj.setDate(date);
+
+    prj.setVersion(in.readString());
+    prj.setInstance(static_cast<long>(in.readUint64()));
+
+    if (in.readUint8())
+        prj.model().setGraph(
+          std::unique_ptr<vle::vpz::BaseModel>(read_model(in, nullptr)));
+
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+        vle::vpz::Dynamic dyn(in.readString());
+        dyn.setPackage(in.readString());
+        dyn.setLibrary(in.readString());
+        dyn.setLanguage(in.readString());
+        prj.dynamics().add(dyn);
+    }
+
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+        auto& cls = prj.classes().add(in.readString());
+        if (in.readUint8())
+            cls.setGraph(
+              std::unique_ptr<vle::vpz::BaseModel>(read_model(in, nullptr)));
+    }
+
+    auto& exp = prj.experiment();
+    exp.setName(in.readString());
+    std::string combination = in.readString();
+    if (not combination.empty())
+        exp.setCombination(combination);
+
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+        auto& cnd = exp.conditions().add(vle::vpz::Condition(in.readString()));
+        auto& values = cnd.conditionvalues();
+        for (uint32_t j = 0, f = in.readUint32(); j != f; ++j) {
+            std::string port = in.readString();
+            values[port] = std::shared_ptr<vle::value::Value>(in.readValue());
+        }
+    }
+
+    auto& views = exp.views();
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+        std::string name = in.readString();
+        std::string location = in.readString();
+        std::string plugin = in.readString();
+        std::string package = in.readString();
+        auto& output = views.addStreamOutput(name, location, plugin, package);
+        output.setData(std::shared_ptr<vle::value::Value>(in.readValue()));
+    }
+
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+        std::string name = in.readString();
+        auto type = static_cast<vle::vpz::View::Type>(in.readUint32());
+        std::string output = in.readString();
+        double timestep = in.readDouble();
+        bool enable = in.readUint8() != 0;
+        views.add(vle::vpz::View(name, type, output, timestep, enable));
+    }
+
+    for (uint32_t i = 0, e = in.readUint32(); i != e; ++i) {
+        auto& obs = views.addObservable(in.readString());
+        for (uint32_t j = 0, f = in.readUint32(); j != f; ++j) {
+            auto& port = obs.add(in.readString());
+            for (uint32_t k = 0, g = in.readUint32(); k != g; ++k)
+                port.add(in.readString());
+        }
+    }
+}
+}
+
+namespace vle {
+namespace vpz {
+
+#ifndef _WIN32
+MappedFile::MappedFile(const std::string& filename)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw utils::FileError(_("Fail to open file '%s'"), filename.c_str());
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        ::close(fd);
+        throw utils::FileError(_("Fail to open file '%s'"), filename.c_str());
+    }
+
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size > 0) {
+        void* ptr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            ::close(fd);
+            throw utils::FileError(_("Fail to map file '%s'"),
+                                   filename.c_str());
+        }
+
+        m_data = static_cast<const char*>(ptr);
+    } else {
+        m_data = m_buffer.data();
+    }
+
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_size > 0)
+        ::munmap(const_cast<char*>(m_data), m_size);
+}
+#else
+MappedFile::MappedFile(const std::string& filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    if (not ifs.is_open())
+        throw utils::FileError(_("Fail to open file '%s'"), filename.c_str());
+
+    std::ostringstream ss;
+    ss << ifs.rdbuf();
+    m_buffer = ss.str();
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+}
+
+MappedFile::~MappedFile() = default;
+#endif
+
+uint64_t
+vpz_content_hash(const char* first, const char* last)
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+
+    for (; first != last; ++first) {
+        hash ^= static_cast<unsigned char>(*first);
+        hash *= UINT64_C(1099511628211);
+    }
+
+    return hash;
+}
+
+bool
+vpz_binary_is_compiled(const char* first, const char* last)
+{
+    return static_cast<std::size_t>(last - first) >= vpz_binary_header_size and
+           std::memcmp(first, vpz_binary_magic, sizeof(vpz_binary_magic)) == 0;
+}
+
+bool
+vpz_binary_is_fresh(const char* first, const char* last, uint64_t hash)
+{
+    if (not vpz_binary_is_compiled(first, last))
+        return false;
+
+    value::BinaryReader in(first + sizeof(vpz_binary_magic), last);
+    return in.readUint32() == vpz_binary_version and in.readUint64() == hash;
+}
+
+void
+vpz_binary_write(const Vpz& vpz, uint64_t hash, std::string& out)
+{
+    out.append(vpz_binary_magic, sizeof(vpz_binary_magic));
+
+    value::BinaryWriter writer(out);
+    writer.writeUint32(vpz_binary_version);
+    writer.writeUint64(hash);
+
+    write_project(writer, vpz.project());
+}
+
+void
+vpz_binary_write_structure(const Vpz& vpz, std::string& out, bool locations)
+{
+    value::BinaryWriter writer(out);
+    write_models(writer, vpz.project());
+    write_views(writer, vpz.project().experiment().views(), locations);
+}
+
+void
+vpz_binary_write_conditions(const Conditions& conditions, std::string& out)
+{
+    value::BinaryWriter writer(out);
+    write_conditions(writer, conditions);
+}
+
+void
+vpz_binary_read(Vpz& vpz, const char* first, const char* last)
+{
+    if (not vpz_binary_is_compiled(first, last))
+        throw utils::ArgError(_("Compiled vpz: bad magic number"));
+
+    value::BinaryReader in(first + sizeof(vpz_binary_magic), last);
+    if (in.readUint32() != vpz_binary_version)
+        throw utils::ArgError(_("Compiled vpz: unsupported version"));
+
+    in.readUint64();
+    read_project(in, vpz.project());
+}
+}
+} // namespace vle vpz
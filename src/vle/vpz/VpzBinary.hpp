@@ -0,0 +1,138 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_VPZ_VPZBINARY_HPP
+#define VLE_VPZ_VPZBINARY_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace vle {
+namespace vpz {
+
+class Conditions;
+class Vpz;
+
+/**
+ * @brief A read-only view of a whole file. On Unix the file is mapped with
+ * @c mmap(2), elsewhere it is read into memory.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Open and map the file.
+     * @param filename The file to map.
+     * @throw utils::FileError if the file can not be opened.
+     */
+    MappedFile(const std::string& filename);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    const char* begin() const
+    {
+        return m_data;
+    }
+
+    const char* end() const
+    {
+        return m_data + m_size;
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+    std::string m_buffer;
+};
+
+/**
+ * @brief Compute the 64 bits FNV-1a hash of a buffer. It is used to check
+ * that a compiled file is up to date with its XML source.
+ */
+uint64_t
+vpz_content_hash(const char* first, const char* last);
+
+/**
+ * @brief Check if the buffer starts with the compiled VPZ magic number.
+ */
+bool
+vpz_binary_is_compiled(const char* first, const char* last);
+
+/**
+ * @brief Check if the buffer is a compiled VPZ of the current format
+ * version built from a source with the specified hash.
+ */
+bool
+vpz_binary_is_fresh(const char* first, const char* last, uint64_t hash);
+
+/**
+ * @brief Append to @c out the compiled representation of the project.
+ * @param hash The content hash of the XML source or 0.
+ * @throw utils::ArgError if a value can not be written.
+ */
+void
+vpz_binary_write(const Vpz& vpz, uint64_t hash, std::string& out);
+
+/**
+ * @brief Append to @c out the representation of the project without its
+ * metadata (author, date, version, instance) and without its conditions.
+ * With @c vpz_binary_write_conditions, it is the canonical form used to
+ * identify a simulation. Without @c locations, the locations of the
+ * outputs are not written: they can change between two restarts of the
+ * same models.
+ * @throw utils::ArgError if a value can not be written.
+ */
+void
+vpz_binary_write_structure(const Vpz& vpz,
+                           std::string& out,
+                           bool locations = true);
+
+/**
+ * @brief Append to @c out the representation of the conditions, the same
+ * as the one of @c vpz_binary_write.
+ * @throw utils::ArgError if a value can not be written.
+ */
+void
+vpz_binary_write_conditions(const Conditions& conditions, std::string& out);
+
+/**
+ * @brief Fill the project from a compiled buffer.
+ * @throw utils::ArgError if the buffer is truncated or corrupted.
+ */
+void
+vpz_binary_read(Vpz& vpz, const char* first, const char* last);
+}
+} // namespace vle vpz
+
+#endif
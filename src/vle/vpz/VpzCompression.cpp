@@ -0,0 +1,510 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Exception.hpp>
+
+#include "utils/i18n.hpp"
+#include "vpz/VpzCompression.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef VLE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef VLE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace vle {
+namespace vpz {
+
+/* Decode the compressed input into a caller buffer, return the number of
+ * bytes written, 0 at the end of the stream. */
+struct decompress_streambuf::decoder
+{
+    virtual ~decoder() = default;
+
+    virtual std::size_t read(char* out, std::size_t size) = 0;
+};
+
+/* Encode a buffer into the sink, @c end writes the end of the stream. */
+struct compress_streambuf::encoder
+{
+    virtual ~encoder() = default;
+
+    virtual void write(const char* in,
+                       std::size_t size,
+                       bool end,
+                       std::streambuf* sink) = 0;
+};
+
+namespace {
+
+const std::size_t vpz_compression_buffer_size = 64 * 1024;
+
+inline bool
+ends_with(const std::string& str, const char* suffix)
+{
+    const std::size_t size = std::strlen(suffix);
+
+    return str.size() >= size and
+           str.compare(str.size() - size, size, suffix) == 0;
+}
+
+inline void
+write_sink(std::streambuf* sink, const char* buffer, std::size_t size)
+{
+    if (static_cast<std::size_t>(
+          sink->sputn(buffer, static_cast<std::streamsize>(size))) != size)
+        throw utils::FileError(_("Vpz: fail to write compressed data"));
+}
+
+#ifdef VLE_HAVE_ZLIB
+
+/* zlib counts in unsigned int, process the buffers by chunks. */
+inline uInt
+zlib_chunk(std::size_t size)
+{
+    return static_cast<uInt>(
+      std::min<std::size_t>(size, std::numeric_limits<uInt>::max()));
+}
+
+struct gzip_decoder : public decompress_streambuf::decoder
+{
+    z_stream stream;
+    const char* first;
+    const char* last;
+    bool finished = false;
+
+    gzip_decoder(const char* first_, const char* last_)
+      : first(first_)
+      , last(last_)
+    {
+        std::memset(&stream, 0, sizeof(stream));
+
+        /* 32 enables the automatic detection of gzip and zlib headers. */
+        if (inflateInit2(&stream, 32 + MAX_WBITS) != Z_OK)
+            throw utils::FileError(_("Vpz: fail to initialize zlib"));
+    }
+
+    ~gzip_decoder() override
+    {
+        inflateEnd(&stream);
+    }
+
+    std::size_t read(char* out, std::size_t size) override
+    {
+        stream.next_out = reinterpret_cast<Bytef*>(out);
+        stream.avail_out = zlib_chunk(size);
+
+        while (not finished and stream.avail_out > 0) {
+            if (stream.avail_in == 0) {
+                stream.next_in =
+                  reinterpret_cast<Bytef*>(const_cast<char*>(first));
+                stream.avail_in = zlib_chunk(last - first);
+                first += stream.avail_in;
+            }
+
+            int ret = inflate(&stream, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                /* gzip files can be a concatenation of members. */
+                if (stream.avail_in == 0 and first == last)
+                    finished = true;
+                else if (inflateReset(&stream) != Z_OK)
+                    throw utils::FileError(_("Vpz: corrupted gzip data"));
+            } else if (ret == Z_BUF_ERROR) {
+                if (stream.avail_in == 0 and first == last)
+                    throw utils::FileError(_("Vpz: truncated gzip data"));
+            } else if (ret != Z_OK) {
+                throw utils::FileError(_("Vpz: corrupted gzip data: %s"),
+                                       stream.msg ? stream.msg : "");
+            }
+        }
+
+        return size - stream.avail_out;
+    }
+};
+
+struct gzip_encoder : public compress_streambuf::encoder
+{
+    z_stream stream;
+    std::vector<char> buffer;
+
+    gzip_encoder()
+      : buffer(vpz_compression_buffer_size)
+    {
+        std::memset(&stream, 0, sizeof(stream));
+
+        /* 16 writes a gzip header instead of a zlib header. */
+        if (deflateInit2(&stream,
+                         Z_DEFAULT_COMPRESSION,
+                         Z_DEFLATED,
+                         16 + MAX_WBITS,
+                         8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+            throw utils::FileError(_("Vpz: fail to initialize zlib"));
+    }
+
+    ~gzip_encoder() override
+    {
+        deflateEnd(&stream);
+    }
+
+    void write(const char* in,
+               std::size_t size,
+               bool end,
+               std::streambuf* sink) override
+    {
+        const char* last = in + size;
+
+        for (;;) {
+            if (stream.avail_in == 0 and in != last) {
+                stream.next_in =
+                  reinterpret_cast<Bytef*>(const_cast<char*>(in));
+                stream.avail_in = zlib_chunk(last - in);
+                in += stream.avail_in;
+            }
+
+            const int flush = (end and in == last) ? Z_FINISH : Z_NO_FLUSH;
+            stream.next_out = reinterpret_cast<Bytef*>(buffer.data());
+            stream.avail_out = zlib_chunk(buffer.size());
+
+            int ret = deflate(&stream, flush);
+            if (ret == Z_STREAM_ERROR)
+                throw utils::FileError(_("Vpz: gzip compression failure"));
+
+            write_sink(sink, buffer.data(), buffer.size() - stream.avail_out);
+
+            if (flush == Z_FINISH) {
+                if (ret == Z_STREAM_END)
+                    return;
+            } else if (stream.avail_in == 0 and in == last and
+                       stream.avail_out != 0) {
+                return;
+            }
+        }
+    }
+};
+
+#endif
+
+#ifdef VLE_HAVE_ZSTD
+
+struct zstd_decoder : public decompress_streambuf::decoder
+{
+    ZSTD_DStream* stream;
+    ZSTD_inBuffer input;
+    std::size_t last_ret = 0;
+
+    zstd_decoder(const char* first, const char* last)
+      : stream(ZSTD_createDStream())
+    {
+        if (not stream or ZSTD_isError(ZSTD_initDStream(stream))) {
+            ZSTD_freeDStream(stream);
+            throw utils::FileError(_("Vpz: fail to initialize zstd"));
+        }
+
+        input.src = first;
+        input.size = static_cast<std::size_t>(last - first);
+        input.pos = 0;
+    }
+
+    ~zstd_decoder() override
+    {
+        ZSTD_freeDStream(stream);
+    }
+
+    std::size_t read(char* out, std::size_t size) override
+    {
+        ZSTD_outBuffer output = { out, size, 0 };
+
+        /* ZSTD_decompressStream returns 0 at the end of a frame, several
+         * frames are decoded one after the other. */
+        while (output.pos < output.size and input.pos < input.size) {
+            last_ret = ZSTD_decompressStream(stream, &output, &input);
+            if (ZSTD_isError(last_ret))
+                throw utils::FileError(_("Vpz: corrupted zstd data: %s"),
+                                       ZSTD_getErrorName(last_ret));
+        }
+
+        /* The decoder may keep data in its internal buffers. */
+        while (output.pos < output.size and last_ret != 0) {
+            const std::size_t previous = output.pos;
+            last_ret = ZSTD_decompressStream(stream, &output, &input);
+            if (ZSTD_isError(last_ret))
+                throw utils::FileError(_("Vpz: corrupted zstd data: %s"),
+                                       ZSTD_getErrorName(last_ret));
+
+            if (output.pos == previous) {
+                if (last_ret != 0)
+                    throw utils::FileError(_("Vpz: truncated zstd data"));
+                break;
+            }
+        }
+
+        return output.pos;
+    }
+};
+
+struct zstd_encoder : public compress_streambuf::encoder
+{
+    ZSTD_CStream* stream;
+    std::vector<char> buffer;
+
+    zstd_encoder()
+      : stream(ZSTD_createCStream())
+      , buffer(ZSTD_CStreamOutSize())
+    {
+        if (not stream or ZSTD_isError(ZSTD_initCStream(stream, 3))) {
+            ZSTD_freeCStream(stream);
+            throw utils::FileError(_("Vpz: fail to initialize zstd"));
+        }
+    }
+
+    ~zstd_encoder() override
+    {
+        ZSTD_freeCStream(stream);
+    }
+
+    void write(const char* in,
+               std::size_t size,
+               bool end,
+               std::streambuf* sink) override
+    {
+        ZSTD_inBuffer input = { in, size, 0 };
+
+        while (input.pos < input.size) {
+            ZSTD_outBuffer output = { buffer.data(), buffer.size(), 0 };
+            std::size_t ret = ZSTD_compressStream(stream, &output, &input);
+            if (ZSTD_isError(ret))
+                throw utils::FileError(_("Vpz: zstd compression failure: %s"),
+                                       ZSTD_getErrorName(ret));
+
+            write_sink(sink, buffer.data(), output.pos);
+        }
+
+        if (end) {
+            std::size_t remaining;
+            do {
+                ZSTD_outBuffer output = { buffer.data(), buffer.size(), 0 };
+                remaining = ZSTD_endStream(stream, &output);
+                if (ZSTD_isError(remaining))
+                    throw utils::FileError(
+                      _("Vpz: zstd compression failure: %s"),
+                      ZSTD_getErrorName(remaining));
+
+                write_sink(sink, buffer.data(), output.pos);
+            } while (remaining != 0);
+        }
+    }
+};
+
+#endif
+
+[[noreturn]] void
+throw_unavailable(vpz_compression compression)
+{
+    throw utils::FileError(
+      _("Vpz: %s compression is not available in this build"),
+      compression == vpz_compression::gzip ? "gzip" : "zstd");
+}
+
+} // anonymous namespace
+
+vpz_compression
+vpz_compression_detect(const char* first, const char* last)
+{
+    const auto size = last - first;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(first);
+
+    if (size >= 2 and bytes[0] == 0x1f and bytes[1] == 0x8b)
+        return vpz_compression::gzip;
+
+    if (size >= 4 and bytes[0] == 0x28 and bytes[1] == 0xb5 and
+        bytes[2] == 0x2f and bytes[3] == 0xfd)
+        return vpz_compression::zstd;
+
+    return vpz_compression::none;
+}
+
+vpz_compression
+vpz_compression_from_filename(const std::string& filename)
+{
+    if (ends_with(filename, ".gz"))
+        return vpz_compression::gzip;
+
+    if (ends_with(filename, ".zst"))
+        return vpz_compression::zstd;
+
+    return vpz_compression::none;
+}
+
+bool
+vpz_compression_is_available(vpz_compression compression)
+{
+    switch (compression) {
+    case vpz_compression::none:
+        return true;
+    case vpz_compression::gzip:
+#ifdef VLE_HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case vpz_compression::zstd:
+#ifdef VLE_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+decompress_streambuf::decompress_streambuf(vpz_compression compression,
+                                           const char* first,
+                                           const char* last)
+  : m_buffer(vpz_compression_buffer_size)
+{
+    switch (compression) {
+    case vpz_compression::gzip:
+#ifdef VLE_HAVE_ZLIB
+        m_decoder.reset(new gzip_decoder(first, last));
+        break;
+#else
+        throw_unavailable(compression);
+#endif
+    case vpz_compression::zstd:
+#ifdef VLE_HAVE_ZSTD
+        m_decoder.reset(new zstd_decoder(first, last));
+        break;
+#else
+        throw_unavailable(compression);
+#endif
+    case vpz_compression::none:
+        throw utils::FileError(_("Vpz: buffer is not compressed"));
+    }
+
+    setg(m_buffer.data(), m_buffer.data(), m_buffer.data());
+}
+
+decompress_streambuf::~decompress_streambuf() = default;
+
+decompress_streambuf::int_type
+decompress_streambuf::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    std::size_t size = m_decoder->read(m_buffer.data(), m_buffer.size());
+    setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + size);
+
+    if (size == 0)
+        return traits_type::eof();
+
+    return traits_type::to_int_type(*gptr());
+}
+
+compress_streambuf::compress_streambuf(vpz_compression compression,
+                                       std::streambuf* sink)
+  : m_sink(sink)
+  , m_buffer(vpz_compression_buffer_size)
+{
+    switch (compression) {
+    case vpz_compression::gzip:
+#ifdef VLE_HAVE_ZLIB
+        m_encoder.reset(new gzip_encoder());
+        break;
+#else
+        throw_unavailable(compression);
+#endif
+    case vpz_compression::zstd:
+#ifdef VLE_HAVE_ZSTD
+        m_encoder.reset(new zstd_encoder());
+        break;
+#else
+        throw_unavailable(compression);
+#endif
+    case vpz_compression::none:
+        throw utils::FileError(_("Vpz: no compression selected"));
+    }
+
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+compress_streambuf::~compress_streambuf() = default;
+
+void
+compress_streambuf::compress(bool end)
+{
+    m_encoder->write(
+      pbase(), static_cast<std::size_t>(pptr() - pbase()), end, m_sink);
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+void
+compress_streambuf::finish()
+{
+    compress(true);
+
+    if (m_sink->pubsync() != 0)
+        throw utils::FileError(_("Vpz: fail to write compressed data"));
+}
+
+compress_streambuf::int_type
+compress_streambuf::overflow(int_type ch)
+{
+    try {
+        compress(false);
+    } catch (const std::exception& /*e*/) {
+        return traits_type::eof();
+    }
+
+    if (not traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(ch);
+}
+
+int
+compress_streambuf::sync()
+{
+    try {
+        compress(false);
+    } catch (const std::exception& /*e*/) {
+        return -1;
+    }
+
+    return 0;
+}
+}
+} // namespace vle vpz
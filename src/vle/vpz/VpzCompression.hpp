@@ -0,0 +1,134 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_VPZ_VPZCOMPRESSION_HPP
+#define VLE_VPZ_VPZCOMPRESSION_HPP
+
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace vpz {
+
+enum class vpz_compression
+{
+    none,
+    gzip,
+    zstd
+};
+
+/**
+ * @brief Detect the compression of a buffer from its magic number.
+ */
+vpz_compression
+vpz_compression_detect(const char* first, const char* last);
+
+/**
+ * @brief Get the compression to use to write a file from its extension:
+ * @c .gz or @c .zst.
+ */
+vpz_compression
+vpz_compression_from_filename(const std::string& filename);
+
+/**
+ * @brief Check if the library is built with the support of a compression.
+ */
+bool
+vpz_compression_is_available(vpz_compression compression);
+
+/**
+ * @brief A read-only std::streambuf which decompresses on the fly a
+ * compressed memory buffer (for instance a MappedFile). Only a small
+ * window of the decompressed data lives in memory.
+ */
+class decompress_streambuf : public std::streambuf
+{
+public:
+    /**
+     * @throw utils::FileError if the compression is not available.
+     */
+    decompress_streambuf(vpz_compression compression,
+                         const char* first,
+                         const char* last);
+
+    ~decompress_streambuf() override;
+
+    struct decoder;
+
+protected:
+    /**
+     * @throw utils::FileError if the compressed data are corrupted or
+     * truncated.
+     */
+    int_type underflow() override;
+
+private:
+    std::unique_ptr<decoder> m_decoder;
+    std::vector<char> m_buffer;
+};
+
+/**
+ * @brief A write-only std::streambuf which compresses on the fly the
+ * characters and writes the result into an other std::streambuf. @c finish
+ * must be called to write the end of the compressed stream.
+ */
+class compress_streambuf : public std::streambuf
+{
+public:
+    /**
+     * @throw utils::FileError if the compression is not available.
+     */
+    compress_streambuf(vpz_compression compression, std::streambuf* sink);
+
+    ~compress_streambuf() override;
+
+    /**
+     * @brief Compress the pending characters and write the end of the
+     * compressed stream.
+     * @throw utils::FileError if the compression or the write fails.
+     */
+    void finish();
+
+    struct encoder;
+
+protected:
+    int_type overflow(int_type ch) override;
+
+    int sync() override;
+
+private:
+    void compress(bool end);
+
+    std::unique_ptr<encoder> m_encoder;
+    std::streambuf* m_sink;
+    std::vector<char> m_buffer;
+};
+}
+} // namespace vle vpz
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/unit-test.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "devstone.hpp"
+
+#include <cstddef>
+#include <string>
+
+using vle::bench::devstone_type;
+
+struct devstone_counts
+{
+    std::size_t atomics = 0;
+    std::size_t eic = 0;
+    std::size_t ic = 0;
+    std::size_t eoc = 0;
+};
+
+static void
+count(const vle::vpz::CoupledModel& coupled, devstone_counts& counts)
+{
+    for (const auto& port : coupled.getInternalInputPortList())
+        counts.eic += port.second.size();
+
+    for (const auto& port : coupled.getInternalOutputPortList())
+        counts.eoc += port.second.size();
+
+    for (const auto& child : coupled.getModelList()) {
+        for (const auto& port : child.second->getOutputPortList())
+            for (const auto& dst : port.second)
+                if (dst.first != &coupled)
+                    ++counts.ic;
+
+        if (child.second->isAtomic())
+            ++counts.atomics;
+        else
+            count(*static_cast<vle::vpz::CoupledModel*>(child.second),
+                  counts);
+    }
+}
+
+/* The numbers of models and couplings of the DEVStone benchmark (see
+ * DevstoneBuilder::build). */
+static devstone_counts
+expected(devstone_type type, std::size_t d, std::size_t w)
+{
+    devstone_counts counts;
+
+    counts.atomics = (w - 1) * (d - 1) + 1;
+    counts.eic = w * (d - 1) + 1;
+    counts.eoc = d;
+
+    switch (type) {
+    case devstone_type::li:
+        break;
+    case devstone_type::hi:
+        counts.ic = (w - 2) * (d - 1);
+        break;
+    case devstone_type::ho:
+        counts.eic = (w + 1) * (d - 1) + 1;
+        counts.ic = (w - 2) * (d - 1);
+        counts.eoc = w * (d - 1) + 1;
+        break;
+    case devstone_type::homod:
+        counts.atomics = ((w - 1) + (w - 1) * w / 2) * (d - 1) + 1;
+        counts.eic = (2 * (w - 1) + 1) * (d - 1) + 1;
+        counts.ic = ((w - 1) * (w - 1) + (w - 1) * w / 2) * (d - 1);
+        break;
+    }
+
+    return counts;
+}
+
+void
+test_devstone_counts()
+{
+    const devstone_type types[] = { devstone_type::li,
+                                    devstone_type::hi,
+                                    devstone_type::ho,
+                                    devstone_type::homod };
+    const int sizes[][2] = {
+        { 1, 5 }, { 2, 2 }, { 3, 3 }, { 4, 4 }, { 5, 3 }
+    };
+
+    for (auto type : types) {
+        for (const auto& size : sizes) {
+            vle::bench::devstone_parameters params;
+            params.type = type;
+            params.depth = size[0];
+            params.width = size[1];
+
+            vle::bench::DevstoneBuilder builder(params);
+            auto file = builder.build();
+            auto* top = static_cast<vle::vpz::CoupledModel*>(
+              file->project().model().node());
+            auto* root =
+              top->getModelList().at("l" + std::to_string(params.depth));
+
+            devstone_counts counts;
+            count(*static_cast<vle::vpz::CoupledModel*>(root), counts);
+
+            auto wanted = expected(type,
+                                   static_cast<std::size_t>(params.depth),
+                                   static_cast<std::size_t>(params.width));
+            EnsuresEqual(counts.atomics, wanted.atomics);
+            EnsuresEqual(counts.eic, wanted.eic);
+            EnsuresEqual(counts.ic, wanted.ic);
+            EnsuresEqual(counts.eoc, wanted.eoc);
+
+            // The builder counts the couplings of the generator too.
+            const std::size_t generator =
+              type == devstone_type::ho or type == devstone_type::homod ? 2
+                                                                         : 1;
+            EnsuresEqual(builder.atomics(), counts.atomics);
+            EnsuresEqual(builder.couplings(),
+                         counts.eic + counts.ic + counts.eoc + generator);
+        }
+    }
+
+    // The usual sizes of the HOmod model.
+    const std::size_t homod[][3] = {
+        { 3, 3, 11 }, { 4, 4, 28 }, { 5, 3, 21 }
+    };
+    for (const auto& size : homod) {
+        vle::bench::devstone_parameters params;
+        params.type = devstone_type::homod;
+        params.depth = static_cast<int>(size[0]);
+        params.width = static_cast<int>(size[1]);
+
+        vle::bench::DevstoneBuilder builder(params);
+        builder.build();
+        EnsuresEqual(builder.atomics(), size[2]);
+    }
+}
+
+void
+test_devstone_bad_size()
+{
+    vle::bench::devstone_parameters params;
+    params.depth = 0;
+
+    vle::bench::DevstoneBuilder builder(params);
+    EnsuresThrow(builder.build(), vle::utils::ArgError);
+}
+
+int
+main()
+{
+    test_devstone_counts();
+    test_devstone_bad_size();
+
+    return unit_test::report_errors();
+}
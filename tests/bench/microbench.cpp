@@ -0,0 +1,890 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Microbenchmarks of the kernel and of the value and vpz libraries. Each
+ * benchmark runs at fixed sizes and reports the minimum, over several
+ * samples, of the mean time of an operation. The report is written in JSON
+ * with one benchmark per line so that it can be stored and used as the
+ * baseline of a later run (see --baseline).
+ */
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/utils/Filesystem.hpp>
+#include <vle/value/Binary.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/vle.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "devs/DynamicsInit.hpp"
+#include "devs/Scheduler.hpp"
+#include "devs/Simulator.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <getopt.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace vle;
+
+/* A fixture prepares the data of an operation outside the measure
+ * (@c setup) and runs the measured operation (@c run). Both are called
+ * once per iteration. */
+struct fixture
+{
+    virtual ~fixture() = default;
+    virtual void setup()
+    {}
+    virtual void run() = 0;
+};
+
+struct benchmark
+{
+    std::string name;
+    std::vector<std::size_t> sizes;
+    std::function<std::unique_ptr<fixture>(std::size_t)> make;
+};
+
+struct result
+{
+    std::string name;
+    std::size_t size;
+    std::size_t iterations;
+    double ns_per_op;
+};
+
+/*
+ * Scheduler
+ */
+
+/* Models without behaviour: the scheduler only reads the executive flag of
+ * the dynamics and the handle of the simulators. */
+class idle_dynamics : public devs::Dynamics
+{
+public:
+    idle_dynamics(const devs::DynamicsInit& init,
+                  const devs::InitEventList& events)
+      : devs::Dynamics(init, events)
+    {}
+
+    devs::Time init(devs::Time /* time */) override
+    {
+        return 1.0;
+    }
+};
+
+class simulators
+{
+public:
+    simulators(utils::ContextPtr ctx, std::size_t size)
+    {
+        m_models.reserve(size);
+        m_simulators.reserve(size);
+
+        for (std::size_t i = 0; i != size; ++i) {
+            m_models.emplace_back(std::make_unique<vpz::AtomicModel>(
+              "m" + std::to_string(i), nullptr));
+            m_simulators.emplace_back(
+              std::make_unique<devs::Simulator>(m_models.back().get()));
+            m_simulators.back()->addDynamics(std::make_unique<idle_dynamics>(
+              devs::DynamicsInit{ ctx, *m_models.back(), {} },
+              devs::InitEventList()));
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_simulators.size();
+    }
+
+    devs::Simulator* operator[](std::size_t i) const noexcept
+    {
+        return m_simulators[i].get();
+    }
+
+    void reset(devs::Scheduler& scheduler)
+    {
+        scheduler.clear();
+        for (auto& elem : m_simulators)
+            elem->reset();
+
+        scheduler.init(0.0);
+    }
+
+private:
+    std::vector<std::unique_ptr<vpz::AtomicModel>> m_models;
+    std::vector<std::unique_ptr<devs::Simulator>> m_simulators;
+};
+
+/* Random dates in [1, 1 + size / bag) so that a bag gets about @c bag
+ * simulators. */
+std::vector<devs::Time>
+random_dates(std::size_t size, std::size_t bag)
+{
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<std::size_t> dist(
+      0, std::max<std::size_t>(size / bag, 1) - 1);
+
+    std::vector<devs::Time> ret(size);
+    for (auto& elem : ret)
+        elem = 1.0 + static_cast<devs::Time>(dist(gen));
+
+    return ret;
+}
+
+/* Schedule the internal events of all the simulators. */
+struct scheduler_add_internal : fixture
+{
+    simulators sims;
+    std::vector<devs::Time> dates;
+    devs::Scheduler scheduler;
+
+    scheduler_add_internal(utils::ContextPtr ctx, std::size_t size)
+      : sims(ctx, size)
+      , dates(random_dates(size, 1))
+    {}
+
+    void setup() override
+    {
+        sims.reset(scheduler);
+    }
+
+    void run() override
+    {
+        for (std::size_t i = 0, e = sims.size(); i != e; ++i)
+            scheduler.addInternal(sims[i], dates[i]);
+    }
+};
+
+/* Pop all the bags of a scheduler of about ten simulators per bag. */
+struct scheduler_make_next_bag : fixture
+{
+    simulators sims;
+    std::vector<devs::Time> dates;
+    devs::Scheduler scheduler;
+
+    scheduler_make_next_bag(utils::ContextPtr ctx, std::size_t size)
+      : sims(ctx, size)
+      , dates(random_dates(size, 10))
+    {}
+
+    void setup() override
+    {
+        sims.reset(scheduler);
+        for (std::size_t i = 0, e = sims.size(); i != e; ++i)
+            scheduler.addInternal(sims[i], dates[i]);
+    }
+
+    void run() override
+    {
+        while (not devs::isInfinity(scheduler.getNextTime()))
+            scheduler.makeNextBag();
+    }
+};
+
+/* Route an external event to all the simulators, as an output port
+ * connected to all the models. Each simulator has a future internal event
+ * which is removed from the scheduler. */
+struct scheduler_add_external : fixture
+{
+    simulators sims;
+    std::shared_ptr<value::Value> event;
+    std::string port;
+    devs::Scheduler scheduler;
+
+    scheduler_add_external(utils::ContextPtr ctx, std::size_t size)
+      : sims(ctx, size)
+      , event(std::make_shared<value::Double>(1.0))
+      , port("in")
+    {}
+
+    void setup() override
+    {
+        sims.reset(scheduler);
+        for (std::size_t i = 0, e = sims.size(); i != e; ++i)
+            scheduler.addInternal(sims[i], sims[i]->init(0.0));
+    }
+
+    void run() override
+    {
+        for (std::size_t i = 0, e = sims.size(); i != e; ++i)
+            scheduler.addExternal(sims[i], event, port);
+    }
+};
+
+/*
+ * Values
+ */
+
+std::vector<std::string>
+make_keys(std::size_t size)
+{
+    std::vector<std::string> ret;
+    ret.reserve(size);
+
+    for (std::size_t i = 0; i != size; ++i)
+        ret.emplace_back("key" + std::to_string(i));
+
+    return ret;
+}
+
+/* Build a value of @c size doubles: a map, a set or a matrix of 100
+ * columns. */
+std::unique_ptr<value::Value>
+make_value(const std::string& type,
+           std::size_t size,
+           const std::vector<std::string>& keys)
+{
+    if (type == "map") {
+        auto ret = std::make_unique<value::Map>();
+        for (std::size_t i = 0; i != size; ++i)
+            ret->addDouble(keys[i], static_cast<double>(i));
+        return std::move(ret);
+    }
+
+    if (type == "set") {
+        auto ret = std::make_unique<value::Set>();
+        for (std::size_t i = 0; i != size; ++i)
+            ret->addDouble(static_cast<double>(i));
+        return std::move(ret);
+    }
+
+    const std::size_t columns = 100;
+    const std::size_t rows = size / columns;
+    auto ret = std::make_unique<value::Matrix>(columns, rows, 0, 0);
+    for (std::size_t r = 0; r != rows; ++r)
+        for (std::size_t c = 0; c != columns; ++c)
+            ret->set(c,
+                     r,
+                     std::make_unique<value::Double>(
+                       static_cast<double>(r * columns + c)));
+    return std::move(ret);
+}
+
+struct value_build : fixture
+{
+    std::string type;
+    std::size_t size;
+    std::vector<std::string> keys;
+    std::unique_ptr<value::Value> value;
+
+    value_build(std::string type_, std::size_t size_)
+      : type(std::move(type_))
+      , size(size_)
+      , keys(type == "map" ? make_keys(size) : std::vector<std::string>())
+    {}
+
+    void setup() override
+    {
+        value.reset();
+    }
+
+    void run() override
+    {
+        value = make_value(type, size, keys);
+    }
+};
+
+struct value_clone : fixture
+{
+    std::unique_ptr<value::Value> value;
+    std::unique_ptr<value::Value> copy;
+
+    value_clone(const std::string& type, std::size_t size)
+      : value(make_value(type, size, make_keys(size)))
+    {}
+
+    void setup() override
+    {
+        copy.reset();
+    }
+
+    void run() override
+    {
+        copy = value->clone();
+    }
+};
+
+struct value_write : fixture
+{
+    std::unique_ptr<value::Value> value;
+    std::string buffer;
+
+    value_write(const std::string& type, std::size_t size)
+      : value(make_value(type, size, make_keys(size)))
+    {}
+
+    void setup() override
+    {
+        buffer.clear();
+    }
+
+    void run() override
+    {
+        value::BinaryWriter(buffer).writeValue(value.get());
+    }
+};
+
+struct value_read : fixture
+{
+    std::string buffer;
+    std::unique_ptr<value::Value> value;
+
+    value_read(const std::string& type, std::size_t size)
+    {
+        auto source = make_value(type, size, make_keys(size));
+        value::BinaryWriter(buffer).writeValue(source.get());
+    }
+
+    void setup() override
+    {
+        value.reset();
+    }
+
+    void run() override
+    {
+        value::BinaryReader in(buffer.data(), buffer.data() + buffer.size());
+        value = in.readValue();
+    }
+};
+
+/*
+ * Vpz
+ */
+
+/* A project of @c size atomic models connected in a chain, each with its
+ * own condition of two ports. */
+std::unique_ptr<vpz::Vpz>
+make_vpz(std::size_t size)
+{
+    auto file = std::make_unique<vpz::Vpz>();
+    auto& project = file->project();
+    project.setAuthor("vle-microbench");
+    project.setVersion("1.0");
+    project.experiment().setName("microbench");
+    project.experiment().setBegin(0.0);
+    project.experiment().setDuration(100.0);
+
+    project.dynamics()
+      .dynamiclist()
+      .emplace("dyn", vpz::Dynamic("dyn"))
+      .first->second.setLibrary("dyn");
+
+    auto top = std::make_unique<vpz::CoupledModel>("top", nullptr);
+    vpz::AtomicModel* previous = nullptr;
+
+    for (std::size_t i = 0; i != size; ++i) {
+        const auto name = "m" + std::to_string(i);
+
+        auto& cnd = project.experiment().conditions().add(
+          vpz::Condition("c" + std::to_string(i)));
+        cnd.add("a");
+        cnd.setValueToPort("a",
+                           std::make_shared<value::Double>(
+                             static_cast<double>(i)));
+        cnd.add("b");
+        cnd.setValueToPort("b", std::make_shared<value::Double>(1.0));
+
+        auto* mdl = top->addAtomicModel(name);
+        mdl->setDynamics("dyn");
+        mdl->setConditions({ cnd.name() });
+        mdl->addInputPort("in");
+        mdl->addOutputPort("out");
+
+        if (previous)
+            top->addInternalConnection(previous, "out", mdl, "in");
+
+        previous = mdl;
+    }
+
+    project.model().setGraph(std::move(top));
+
+    return file;
+}
+
+struct vpz_parse : fixture
+{
+    std::string filename;
+    std::unique_ptr<vpz::Vpz> file;
+
+    explicit vpz_parse(std::size_t size)
+      : filename(utils::Path::unique_path(
+                   (utils::Path::temp_directory_path() /
+                    "vle-microbench-%%%%-%%%%.vpz")
+                     .string())
+                   .string())
+    {
+        make_vpz(size)->write(filename);
+    }
+
+    ~vpz_parse() override
+    {
+        utils::Path(filename).remove();
+    }
+
+    void setup() override
+    {
+        file = std::make_unique<vpz::Vpz>();
+    }
+
+    void run() override
+    {
+        file->parseFile(filename);
+    }
+};
+
+struct vpz_copy : fixture
+{
+    std::unique_ptr<vpz::Vpz> file;
+    std::unique_ptr<vpz::Vpz> copy;
+
+    explicit vpz_copy(std::size_t size)
+      : file(make_vpz(size))
+    {}
+
+    void setup() override
+    {
+        copy.reset();
+    }
+
+    void run() override
+    {
+        copy = std::make_unique<vpz::Vpz>(*file);
+    }
+};
+
+std::vector<benchmark>
+make_benchmarks(utils::ContextPtr ctx)
+{
+    const std::vector<std::size_t> scheduler_sizes{ 1000, 10000, 100000 };
+    const std::vector<std::size_t> value_sizes{ 1000, 10000, 100000 };
+    const std::vector<std::size_t> vpz_sizes{ 100, 1000, 10000 };
+
+    std::vector<benchmark> ret{
+        { "scheduler.add_internal",
+          scheduler_sizes,
+          [ctx](std::size_t size) -> std::unique_ptr<fixture> {
+              return std::make_unique<scheduler_add_internal>(ctx, size);
+          } },
+        { "scheduler.make_next_bag",
+          scheduler_sizes,
+          [ctx](std::size_t size) -> std::unique_ptr<fixture> {
+              return std::make_unique<scheduler_make_next_bag>(ctx, size);
+          } },
+        { "scheduler.add_external",
+          scheduler_sizes,
+          [ctx](std::size_t size) -> std::unique_ptr<fixture> {
+              return std::make_unique<scheduler_add_external>(ctx, size);
+          } }
+    };
+
+    for (const std::string type : { "map", "set", "matrix" }) {
+        ret.push_back({ "value." + type + ".build",
+                        value_sizes,
+                        [type](std::size_t size) -> std::unique_ptr<fixture> {
+                            return std::make_unique<value_build>(type, size);
+                        } });
+        ret.push_back({ "value." + type + ".clone",
+                        value_sizes,
+                        [type](std::size_t size) -> std::unique_ptr<fixture> {
+                            return std::make_unique<value_clone>(type, size);
+                        } });
+        ret.push_back({ "value." + type + ".write",
+                        value_sizes,
+                        [type](std::size_t size) -> std::unique_ptr<fixture> {
+                            return std::make_unique<value_write>(type, size);
+                        } });
+        ret.push_back({ "value." + type + ".read",
+                        value_sizes,
+                        [type](std::size_t size) -> std::unique_ptr<fixture> {
+                            return std::make_unique<value_read>(type, size);
+                        } });
+    }
+
+    ret.push_back({ "vpz.parse",
+                    vpz_sizes,
+                    [](std::size_t size) -> std::unique_ptr<fixture> {
+                        return std::make_unique<vpz_parse>(size);
+                    } });
+    ret.push_back({ "vpz.copy",
+                    vpz_sizes,
+                    [](std::size_t size) -> std::unique_ptr<fixture> {
+                        return std::make_unique<vpz_copy>(size);
+                    } });
+
+    return ret;
+}
+
+/*
+ * Harness
+ */
+
+/* Run @c samples samples of at least @c min_time seconds (and at least one
+ * iteration) and return the best mean time of an iteration. */
+result
+measure(const benchmark& bench,
+        std::size_t size,
+        long samples,
+        double min_time)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto fix = bench.make(size);
+    result ret{ bench.name, size, 0, 0.0 };
+
+    fix->setup(); // Warm up.
+    fix->run();
+
+    for (long sample = 0; sample != samples; ++sample) {
+        std::size_t iterations = 0;
+        double elapsed = 0.0;
+
+        do {
+            fix->setup();
+            const auto start = clock::now();
+            fix->run();
+            const auto end = clock::now();
+
+            elapsed += std::chrono::duration<double>(end - start).count();
+            ++iterations;
+        } while (elapsed < min_time);
+
+        const auto ns = elapsed * 1e9 / static_cast<double>(iterations);
+        if (sample == 0 or ns < ret.ns_per_op) {
+            ret.ns_per_op = ns;
+            ret.iterations = iterations;
+        }
+    }
+
+    return ret;
+}
+
+std::string
+key(const std::string& name, std::size_t size)
+{
+    return name + '/' + std::to_string(size);
+}
+
+/* Read the value of a @c "field": of a line of the report. */
+bool
+read_field(const std::string& line, const char* field, std::string* value)
+{
+    const auto pattern = std::string("\"") + field + "\": ";
+    auto first = line.find(pattern);
+    if (first == std::string::npos)
+        return false;
+
+    first += pattern.size();
+    if (first < line.size() and line[first] == '"') {
+        const auto last = line.find('"', first + 1);
+        if (last == std::string::npos)
+            return false;
+
+        *value = line.substr(first + 1, last - first - 1);
+        return true;
+    }
+
+    const auto last = line.find_first_of(",}", first);
+    *value = line.substr(first, last - first);
+    return true;
+}
+
+/* Read the benchmarks of a report previously written by @c write_report:
+ * one benchmark per line. */
+bool
+read_baseline(const std::string& filename,
+              std::map<std::string, double>* baseline)
+{
+    std::ifstream ifs(filename);
+    if (not ifs.is_open())
+        return false;
+
+    std::string line, name, size, ns;
+    while (std::getline(ifs, line)) {
+        if (read_field(line, "name", &name) and
+            read_field(line, "size", &size) and
+            read_field(line, "ns_per_op", &ns))
+            (*baseline)[name + '/' + size] = std::strtod(ns.c_str(), nullptr);
+    }
+
+    return true;
+}
+
+void
+write_report(FILE* out, const std::vector<result>& results)
+{
+    fprintf(out,
+            "{\n"
+            "  \"version\": \"%s\",\n"
+            "  \"benchmarks\": [\n",
+            vle::string_version().c_str());
+
+    for (std::size_t i = 0, e = results.size(); i != e; ++i)
+        fprintf(out,
+                "    { \"name\": \"%s\", \"size\": %zu, "
+                "\"iterations\": %zu, \"ns_per_op\": %.6g, "
+                "\"ns_per_item\": %.6g }%s\n",
+                results[i].name.c_str(),
+                results[i].size,
+                results[i].iterations,
+                results[i].ns_per_op,
+                results[i].ns_per_op / static_cast<double>(results[i].size),
+                i + 1 == e ? "" : ",");
+
+    fprintf(out, "  ]\n}\n");
+}
+
+void
+show_help()
+{
+    printf("vle-microbench [options...]\n\n"
+           "Microbenchmarks of the scheduler, the values and the vpz.\n\n"
+           "help,h           Produce help message\n"
+           "list,l           List the benchmarks and their sizes\n"
+           "filter,f         Run only the benchmarks whose name contains "
+           "the string\n"
+           "quick            Run one iteration of each benchmark (smoke "
+           "test)\n"
+           "samples,s        Number of samples of a benchmark, the best is "
+           "reported\n"
+           "                 [default: 5]\n"
+           "min-time         Minimal duration in seconds of a sample "
+           "[default: 0.1]\n"
+           "output,o         Write the JSON report into a file instead of "
+           "the standard\n"
+           "                 output\n"
+           "baseline,b       Compare with a report of a previous run, fail "
+           "if a\n"
+           "                 benchmark is slower than the threshold\n"
+           "threshold        Tolerated slowdown in percent [default: 10]\n");
+}
+
+bool
+to_long(const char* str, long min, long* value) noexcept
+{
+    char* end = nullptr;
+    errno = 0;
+    long ret = std::strtol(str, &end, 10);
+
+    if (errno or end == str or *end != '\0' or ret < min)
+        return false;
+
+    *value = ret;
+    return true;
+}
+
+bool
+to_double(const char* str, double min, double* value) noexcept
+{
+    char* end = nullptr;
+    errno = 0;
+    double ret = std::strtod(str, &end);
+
+    if (errno or end == str or *end != '\0' or ret < min)
+        return false;
+
+    *value = ret;
+    return true;
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char** argv)
+{
+    std::string filter;
+    std::string output_file;
+    std::string baseline_file;
+    long samples = 5;
+    double min_time = 0.1;
+    double threshold = 10.0;
+    int quick = 0;
+    int list = 0;
+    int opt_index;
+
+    const char* const short_opts = "hlf:s:o:b:";
+    const struct option long_opts[] = {
+        { "help", 0, nullptr, 'h' },
+        { "list", 0, nullptr, 'l' },
+        { "filter", 1, nullptr, 'f' },
+        { "quick", 0, &quick, 1 },
+        { "samples", 1, nullptr, 's' },
+        { "min-time", 1, nullptr, 0 },
+        { "output", 1, nullptr, 'o' },
+        { "baseline", 1, nullptr, 'b' },
+        { "threshold", 1, nullptr, 0 },
+        { nullptr, 0, nullptr, 0 }
+    };
+
+    for (;;) {
+        const auto opt =
+          getopt_long(argc, argv, short_opts, long_opts, &opt_index);
+        if (opt == -1)
+            break;
+
+        bool valid = true;
+        switch (opt) {
+        case 0: {
+            const std::string name = long_opts[opt_index].name;
+            if (name == "min-time")
+                valid = to_double(::optarg, 0.0, &min_time);
+            else if (name == "threshold")
+                valid = to_double(::optarg, 0.0, &threshold);
+        } break;
+        case 'h':
+            show_help();
+            return EXIT_SUCCESS;
+        case 'l':
+            list = 1;
+            break;
+        case 'f':
+            filter = ::optarg;
+            break;
+        case 's':
+            valid = to_long(::optarg, 1, &samples);
+            break;
+        case 'o':
+            output_file = ::optarg;
+            break;
+        case 'b':
+            baseline_file = ::optarg;
+            break;
+        case '?':
+        default:
+            fprintf(stderr, "Unknown command line option\n");
+            return EXIT_FAILURE;
+        }
+
+        if (not valid) {
+            fprintf(stderr, "Bad value for the option: %s\n", ::optarg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (quick) {
+        samples = 1;
+        min_time = 0.0;
+    }
+
+    std::map<std::string, double> baseline;
+    if (not baseline_file.empty() and
+        not read_baseline(baseline_file, &baseline)) {
+        fprintf(stderr, "Fail to read baseline %s\n", baseline_file.c_str());
+        return EXIT_FAILURE;
+    }
+
+    auto ctx = vle::utils::make_context();
+    ctx->set_log_priority(3);
+
+    std::vector<result> results;
+    int regressions = 0;
+
+    try {
+        for (const auto& bench : make_benchmarks(ctx)) {
+            if (bench.name.find(filter) == std::string::npos)
+                continue;
+
+            for (auto size : bench.sizes) {
+                if (list) {
+                    printf("%s\n", key(bench.name, size).c_str());
+                    continue;
+                }
+
+                results.emplace_back(
+                  measure(bench, size, samples, min_time));
+                const auto& res = results.back();
+
+                fprintf(stderr,
+                        "%-28s %8zu %14.1f ns",
+                        res.name.c_str(),
+                        res.size,
+                        res.ns_per_op);
+
+                auto it = baseline.find(key(res.name, res.size));
+                if (it != baseline.end() and it->second > 0.0) {
+                    const auto ratio = res.ns_per_op / it->second;
+                    const bool slower = ratio > 1.0 + threshold / 100.0;
+                    fprintf(stderr,
+                            " %8.3fx%s",
+                            ratio,
+                            slower ? " REGRESSION" : "");
+                    regressions += slower;
+                }
+
+                fprintf(stderr, "\n");
+            }
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Benchmark failure: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (list)
+        return EXIT_SUCCESS;
+
+    FILE* out = stdout;
+    if (not output_file.empty()) {
+        out = fopen(output_file.c_str(), "w");
+        if (not out) {
+            fprintf(stderr, "Fail to open %s\n", output_file.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    write_report(out, results);
+
+    if (out != stdout)
+        fclose(out);
+
+    if (regressions) {
+        fprintf(stderr,
+                "%d benchmark(s) slower than the baseline (+%g%%)\n",
+                regressions,
+                threshold);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
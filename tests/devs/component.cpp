@@ -28,10 +28,13 @@
 #include <vle/devs/Executive.hpp>
 #include <vle/devs/MultiComponent.hpp>
 #include <vle/manager/Simulation.hpp>
+#include <vle/manager/SimulationCache.hpp>
 #include <vle/oov/Plugin.hpp>
 #include <vle/utils/Filesystem.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/unit-test.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
 #include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
 #include <vle/vpz/Classes.hpp>
@@ -43,10 +46,19 @@
 #include "oov.hpp"
 
 #include <chrono>
+#include <fstream>
+#include <iterator>
 #include <numeric>
+#include <sstream>
 
 namespace package {
 
+/* The init value of the width given to the last Agent built. */
+static std::shared_ptr<const vle::value::Value> last_width;
+
+/* The location of the last output plug-in built. */
+static std::string last_location;
+
 class Agent : public vle::devs::Dynamics
 {
     struct position
@@ -90,6 +102,7 @@ public:
       , m_height(static_cast<unsigned>(events.getInt("height")))
     {
         Ensures(m_width > 5 and m_height > 5);
+        last_width = events.get("width");
 
         plan.emplace_back();
         auto& vec = plan.back().cells;
@@ -543,10 +556,530 @@ test_component()
     }
 }
 
+static auto
+run_oscillator(vle::utils::ContextPtr ctx, const std::string& oscillator)
+  -> std::unique_ptr<vle::value::Map>
+{
+    auto file =
+      std::make_unique<vle::vpz::Vpz>(DEVS_TEST_DIR "/component.vpz");
+    file->project().experiment().conditions().get("lifegame").setValueToPort(
+      "oscillator", vle::value::String::create(oscillator));
+
+    return run_simulation(ctx, std::move(file));
+}
+
+static bool
+same_view(const vle::value::Map& lhs, const vle::value::Map& rhs)
+{
+    const auto& m1 = lhs.getMatrix("view1");
+    const auto& m2 = rhs.getMatrix("view1");
+
+    if (m1.rows() != m2.rows() or m1.columns() != m2.columns())
+        return false;
+
+    for (std::size_t r = 0; r != m1.rows(); ++r)
+        if (vle::value::toString(m1(1, r)) != vle::value::toString(m2(1, r)))
+            return false;
+
+    return true;
+}
+
+static vle::utils::ContextPtr
+make_component_context()
+{
+    auto ctx = vle::utils::make_context();
+
+    ctx->add_oov_factory("oov_plugin", [](const std::string& location) {
+        package::last_location = location;
+        return new vletest::OutputPlugin(location);
+    });
+    ctx->add_dynamics_factory(
+      "dynamics_component_a",
+      [](const vle::devs::DynamicsInit& init,
+         const vle::devs::InitEventList& events) {
+          return new package::Model(init, events);
+      });
+    ctx->add_dynamics_factory(
+      "dynamics_agent",
+      [](const vle::devs::DynamicsInit& init,
+         const vle::devs::InitEventList& events) {
+          return new package::Agent(init, events);
+      });
+
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    return ctx;
+}
+
+/* Run component.vpz with the simulator and check that it succeeds. The
+ * conditions of the vpz are copied into @c conditions to restart the
+ * simulation, the results are moved into @c out. */
+static void
+run_component(vle::manager::Simulation& simulator,
+              vle::vpz::Conditions* conditions,
+              std::unique_ptr<vle::value::Map>* out = nullptr)
+{
+    auto file =
+      std::make_unique<vle::vpz::Vpz>(DEVS_TEST_DIR "/component.vpz");
+    if (conditions)
+        *conditions = file->project().experiment().conditions();
+
+    vle::manager::Error error;
+    auto ret = simulator.run(std::move(file), &error);
+    EnsuresEqual(error.code, 0);
+
+    if (out)
+        *out = std::move(ret);
+}
+
+void
+test_warm_start()
+{
+    using namespace std::chrono_literals;
+
+    auto ctx = make_component_context();
+
+    auto toad = run_oscillator(ctx, "toad");
+    auto blinker = run_oscillator(ctx, "blinker");
+    Ensures(toad and blinker);
+    Ensures(not same_view(*toad, *blinker));
+
+    vle::manager::Simulation simulator(
+      ctx, vle::manager::SIMULATION_WARM_START, 0ms);
+    vle::manager::Error error;
+
+    Ensures(not simulator.isRestartable());
+    vle::vpz::Conditions conditions;
+    std::unique_ptr<vle::value::Map> out;
+    run_component(simulator, &conditions, &out);
+    Ensures(out and same_view(*out, *toad));
+    Ensures(simulator.isRestartable());
+
+    // The results of a restart do not depend on the previous simulations.
+    const char* oscillators[] = { "blinker", "toad", "blinker" };
+    for (const char* oscillator : oscillators) {
+        conditions.get("lifegame").setValueToPort(
+          "oscillator", vle::value::String::create(oscillator));
+        out = simulator.restart(conditions, &error);
+        EnsuresEqual(error.code, 0);
+        Ensures(out);
+        Ensures(same_view(*out,
+                          std::string(oscillator) == "toad" ? *toad
+                                                            : *blinker));
+    }
+
+    // The begin and the duration of the simulation are conditions too.
+    conditions.get("simulation_engine")
+      .setValueToPort("duration", vle::value::Double::create(2.0));
+    out = simulator.restart(conditions, &error);
+    EnsuresEqual(error.code, 0);
+    Ensures(out);
+    EnsuresEqual(out->getMatrix("view1").rows(), static_cast<std::size_t>(3));
+}
+
+void
+test_warm_run()
+{
+    using namespace std::chrono_literals;
+
+    auto ctx = make_component_context();
+    auto toad = run_oscillator(ctx, "toad");
+    auto blinker = run_oscillator(ctx, "blinker");
+    Ensures(toad and blinker);
+
+    // The runs of a shared vpz with the same structure restart the models
+    // with the conditions and the locations of the outputs of the vpz (a
+    // workspace per run).
+    vle::manager::Simulation simulator(
+      ctx, vle::manager::SIMULATION_WARM_START, 0ms);
+    vle::manager::Error error;
+    vle::vpz::Vpz vpz(DEVS_TEST_DIR "/component.vpz");
+    auto& conditions = vpz.project().experiment().conditions();
+    auto& output = vpz.project().experiment().views().outputs().get("o");
+
+    const char* oscillators[] = { "toad", "blinker", "toad" };
+    for (const char* oscillator : oscillators) {
+        const std::string location = std::string("workspace_") + oscillator;
+        output.setStreamLocation(location);
+        conditions.get("lifegame").setValueToPort(
+          "oscillator", vle::value::String::create(oscillator));
+        auto out = simulator.run(vpz, &error);
+        EnsuresEqual(error.code, 0);
+        Ensures(out);
+        Ensures(same_view(*out,
+                          std::string(oscillator) == "toad" ? *toad
+                                                            : *blinker));
+        Ensures(simulator.isRestartable());
+        EnsuresEqual(package::last_location, location);
+    }
+
+    // A change of the structure loads the models again.
+    auto& view = vpz.project().experiment().views().get("view1");
+    view.disable();
+    auto out = simulator.run(vpz, &error);
+    EnsuresEqual(error.code, 0);
+    Ensures(not out or not out->exist("view1"));
+
+    view.enable();
+    out = simulator.run(vpz, &error);
+    EnsuresEqual(error.code, 0);
+    Ensures(out and same_view(*out, *toad));
+}
+
+void
+test_init_values()
+{
+    using namespace std::chrono_literals;
+
+    auto ctx = make_component_context();
+    vle::vpz::Vpz vpz(DEVS_TEST_DIR "/component.vpz");
+    const auto& width =
+      vpz.project().experiment().conditions().get("lifegame").valueOfPort(
+        "width");
+
+    // The values of the conditions are shared between the copies of the
+    // vpz, the models get their own clone.
+    vle::manager::Simulation simulator(
+      ctx, vle::manager::SIMULATION_WARM_START, 0ms);
+    vle::manager::Error error;
+
+    auto out = simulator.run(vpz, &error);
+    EnsuresEqual(error.code, 0);
+    Ensures(package::last_width);
+    Ensures(package::last_width.get() != width.get());
+    Ensures(package::last_width->toInteger().value() ==
+            width->toInteger().value());
+
+    // A restart gets a new clone.
+    auto previous = package::last_width;
+    out = simulator.restart(vpz.project().experiment().conditions(), &error);
+    EnsuresEqual(error.code, 0);
+    Ensures(package::last_width.get() != previous.get());
+    Ensures(package::last_width.get() != width.get());
+    package::last_width.reset();
+}
+
+void
+test_cache()
+{
+    using namespace std::chrono_literals;
+
+    auto ctx = make_component_context();
+    auto toad = run_oscillator(ctx, "toad");
+    auto blinker = run_oscillator(ctx, "blinker");
+
+    auto cache = std::make_shared<vle::manager::SimulationCache>(2);
+    vle::manager::Simulation simulator(
+      ctx, vle::manager::SIMULATION_WARM_START, 0ms);
+    simulator.setCache(cache);
+    vle::manager::Error error;
+
+    vle::vpz::Conditions conditions;
+    std::unique_ptr<vle::value::Map> out;
+    run_component(simulator, &conditions, &out);
+    Ensures(out and same_view(*out, *toad));
+    EnsuresEqual(cache->misses(), 1u);
+    EnsuresEqual(cache->size(), 1u);
+
+    conditions.get("lifegame").setValueToPort(
+      "oscillator", vle::value::String::create("blinker"));
+    out = simulator.restart(conditions, &error);
+    Ensures(out and same_view(*out, *blinker));
+    EnsuresEqual(cache->misses(), 2u);
+
+    // A restart and a run of the same experiment share their key.
+    conditions.get("lifegame").setValueToPort(
+      "oscillator", vle::value::String::create("toad"));
+    out = simulator.restart(conditions, &error);
+    Ensures(out and same_view(*out, *toad));
+    EnsuresEqual(cache->hits(), 1u);
+
+    {
+        vle::manager::Simulation other(
+          ctx, vle::manager::SIMULATION_NONE, 0ms);
+        other.setCache(cache);
+        out = other.run(
+          std::make_unique<vle::vpz::Vpz>(DEVS_TEST_DIR "/component.vpz"),
+          &error);
+        Ensures(out and same_view(*out, *toad));
+        EnsuresEqual(cache->hits(), 2u);
+    }
+
+    // The least recently used result (blinker) is evicted.
+    {
+        vle::manager::Simulation other(
+          ctx, vle::manager::SIMULATION_NONE, 0ms);
+        other.setCache(cache);
+
+        auto file =
+          std::make_unique<vle::vpz::Vpz>(DEVS_TEST_DIR "/component.vpz");
+        file->project()
+          .experiment()
+          .conditions()
+          .get("simulation_engine")
+          .setValueToPort("duration", vle::value::Double::create(2.0));
+        out = other.run(std::move(file), &error);
+        Ensures(out);
+        EnsuresEqual(cache->size(), 2u);
+
+        auto misses = cache->misses();
+        file =
+          std::make_unique<vle::vpz::Vpz>(DEVS_TEST_DIR "/component.vpz");
+        file->project().experiment().conditions().get("lifegame")
+          .setValueToPort("oscillator", vle::value::String::create("blinker"));
+        out = other.run(std::move(file), &error);
+        Ensures(out and same_view(*out, *blinker));
+        EnsuresEqual(cache->misses(), misses + 1);
+    }
+
+    // A disabled cache does not return results.
+    cache->enable(false);
+    auto hits = cache->hits();
+    out = simulator.run(
+      std::make_unique<vle::vpz::Vpz>(DEVS_TEST_DIR "/component.vpz"),
+      &error);
+    Ensures(out and same_view(*out, *toad));
+    EnsuresEqual(cache->hits(), hits);
+}
+
+static std::string
+read_file(const vle::utils::Path& path)
+{
+    std::ifstream ifs(path.string());
+    return std::string(std::istreambuf_iterator<char>(ifs),
+                       std::istreambuf_iterator<char>());
+}
+
+void
+test_cache_directory()
+{
+    using vle::utils::DirectoryIterator;
+    using vle::utils::Path;
+
+    Path dir = Path::temp_directory_path() /
+               Path::unique_path("vle-cache-%%%%-%%%%-%%%%-%%%%");
+
+    vle::value::Map first, second;
+    first.addInt("value", 1);
+    second.addInt("value", 2);
+
+    {
+        vle::manager::SimulationCache cache(1, 0, dir.string());
+        cache.put("first key", first);
+        cache.put("second key", second);
+    }
+
+    // The results are read back from the directory by another cache.
+    std::unique_ptr<vle::value::Map> result;
+    {
+        vle::manager::SimulationCache cache(1, 0, dir.string());
+        Ensures(cache.get("first key", &result));
+        Ensures(result and result->getInt("value") == 1);
+        Ensures(not cache.get("third key", &result));
+        EnsuresEqual(cache.hits(), 1u);
+        EnsuresEqual(cache.misses(), 1u);
+    }
+
+    // Each file stores its full key: a file read under the name of
+    // another key is a miss, not the result of the other simulation.
+    std::vector<Path> files;
+    for (DirectoryIterator it(dir), end; it != end; ++it)
+        files.emplace_back(it->path());
+    EnsuresEqual(files.size(), 2u);
+
+    auto first_file = files[0], second_file = files[1];
+    if (read_file(first_file).find("first key") == std::string::npos)
+        std::swap(first_file, second_file);
+    Ensures(read_file(first_file).find("first key") != std::string::npos);
+
+    second_file.remove();
+    Path::copy_file(first_file, second_file);
+    {
+        vle::manager::SimulationCache cache(1, 0, dir.string());
+        Ensures(not cache.get("second key", &result));
+        Ensures(cache.get("first key", &result));
+    }
+
+    for (const auto& file : files)
+        file.remove();
+    dir.remove();
+}
+
+void
+test_statistics()
+{
+    using namespace std::chrono_literals;
+
+    auto ctx = make_component_context();
+    vle::manager::Error error;
+
+    {
+        vle::manager::Simulation simulator(
+          ctx, vle::manager::SIMULATION_NONE, 0ms);
+        run_component(simulator, nullptr);
+        EnsuresEqual(simulator.statistics().bags, 0);
+    }
+
+    vle::manager::Simulation simulator(
+      ctx,
+      vle::manager::SIMULATION_STATISTICS |
+        vle::manager::SIMULATION_WARM_START,
+      0ms);
+
+    vle::vpz::Conditions conditions;
+    run_component(simulator, &conditions);
+
+    const auto first = simulator.statistics();
+    Ensures(first.bags > 0);
+    Ensures(first.outputs > 0);
+    Ensures(first.transitions() > 0);
+    Ensures(first.observations > 0);
+    Ensures(first.external_events >= first.output_events);
+    Ensures(first.transition_time >= 0.0);
+
+    // The statistics of a restart are those of the new simulation only.
+    simulator.restart(conditions, &error);
+    EnsuresEqual(error.code, 0);
+    EnsuresEqual(simulator.statistics().bags, first.bags);
+    EnsuresEqual(simulator.statistics().transitions(), first.transitions());
+    EnsuresEqual(simulator.statistics().external_events,
+                 first.external_events);
+}
+
+void
+test_profile()
+{
+    using namespace std::chrono_literals;
+    using vle::devs::ModelProfile;
+
+    auto ctx = make_component_context();
+    vle::manager::Error error;
+
+    vle::manager::Simulation simulator(
+      ctx,
+      vle::manager::SIMULATION_PROFILE | vle::manager::SIMULATION_STATISTICS |
+        vle::manager::SIMULATION_WARM_START,
+      0ms);
+
+    vle::vpz::Conditions conditions;
+    run_component(simulator, &conditions);
+
+    const auto& stats = simulator.statistics();
+    const auto first = simulator.profile();
+    Ensures(not first.models.empty());
+    Ensures(not first.libraries().empty());
+
+    // The profile of the models counts the same calls and events as the
+    // statistics of the kernel.
+    std::uint64_t bags = 0, outputs = 0, transitions = 0;
+    std::uint64_t output_events = 0, input_events = 0;
+    for (auto nb : first.bags)
+        bags += nb;
+
+    for (const auto& elem : first.models) {
+        const auto& phases = elem.second.phases;
+        Ensures(not elem.second.library.empty());
+
+        outputs += phases[ModelProfile::OUTPUT].calls;
+        transitions += phases[ModelProfile::INTERNAL].calls +
+                       phases[ModelProfile::EXTERNAL].calls +
+                       phases[ModelProfile::CONFLUENT].calls;
+
+        for (const auto& port : elem.second.output_events)
+            output_events += port.second;
+        for (const auto& port : elem.second.input_events)
+            input_events += port.second;
+    }
+
+    EnsuresEqual(bags, stats.bags);
+    EnsuresEqual(outputs, stats.outputs);
+    EnsuresEqual(transitions, stats.transitions());
+    EnsuresEqual(output_events, stats.output_events);
+    EnsuresEqual(input_events, stats.external_events);
+
+    std::ostringstream oss;
+    first.writeJson(oss);
+    Ensures(oss.str().find("\"models\"") != std::string::npos);
+
+    // The profile of a restart is the profile of the new simulation only.
+    simulator.restart(conditions, &error);
+    EnsuresEqual(error.code, 0);
+    EnsuresEqual(simulator.profile().models.size(), first.models.size());
+    EnsuresEqual(simulator.profile().bags.size(), first.bags.size());
+
+    for (const auto& elem : simulator.profile().models) {
+        const auto& old = first.models.at(elem.first);
+        EnsuresEqual(elem.second.library, old.library);
+        EnsuresEqual(elem.second.phases[ModelProfile::OUTPUT].calls,
+                     old.phases[ModelProfile::OUTPUT].calls);
+    }
+
+    // Without the option, the models are not profiled.
+    vle::manager::Simulation quiet(ctx, vle::manager::SIMULATION_NONE, 0ms);
+    run_component(quiet, nullptr);
+    Ensures(quiet.profile().empty());
+}
+
+void
+test_trace()
+{
+    using namespace std::chrono_literals;
+
+    auto ctx = make_component_context();
+    ctx->set_setting("vle.simulation.thread", 2l);
+    ctx->set_setting("vle.simulation.block-size", 1l);
+    vle::manager::Error error;
+
+    vle::utils::UnlinkPath path(
+      vle::utils::Path::temp_directory_path() /
+      vle::utils::Path::unique_path("vle-%%%%-%%%%-%%%%-%%%%.json"));
+
+    vle::manager::Simulation simulator(
+      ctx, vle::manager::SIMULATION_WARM_START, 0ms);
+    simulator.setTrace(path.string());
+
+    vle::vpz::Conditions conditions;
+    run_component(simulator, &conditions);
+
+    // The trace is closed at the end of the simulation: a complete JSON
+    // document with the bags, their phases and the spans of the threads.
+    auto trace = read_file(path.path());
+    EnsuresEqual(trace.compare(0, 18, "{\"displayTimeUnit\""), 0);
+    Ensures(trace.find("\"name\":\"bag\"") != std::string::npos);
+    Ensures(trace.find("\"name\":\"output\"") != std::string::npos);
+    Ensures(trace.find("\"name\":\"transitions\"") != std::string::npos);
+    Ensures(trace.find("\"name\":\"worker 2\"") != std::string::npos);
+    Ensures(trace.size() > 4 and
+            trace.compare(trace.size() - 3, 3, "]}\n") == 0);
+
+    // A restart overwrites the trace.
+    path.path().remove();
+    simulator.restart(conditions, &error);
+    EnsuresEqual(error.code, 0);
+    trace = read_file(path.path());
+    Ensures(trace.find("\"name\":\"bag\"") != std::string::npos);
+
+    // An empty file name disables the trace.
+    path.path().remove();
+    simulator.setTrace(std::string());
+    simulator.restart(conditions, &error);
+    EnsuresEqual(error.code, 0);
+    Ensures(not path.path().exists());
+}
+
 int
 main()
 {
     test_component();
+    test_warm_start();
+    test_warm_run();
+    test_init_values();
+    test_cache();
+    test_cache_directory();
+    test_statistics();
+    test_profile();
+    test_trace();
 
     return unit_test::report_errors();
 }
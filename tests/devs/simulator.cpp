@@ -0,0 +1,236 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * https://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/devs/Executive.hpp>
+#include <vle/manager/Simulation.hpp>
+#include <vle/utils/unit-test.hpp>
+#include <vle/value/String.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include "devs/Simulator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace package {
+
+/* The events received by the receivers: "model.port:value@time". */
+static std::vector<std::string> received;
+
+/* Sends its name on each of its output ports at 0.5, 1.5, 2.5... */
+class Sender : public vle::devs::Dynamics
+{
+public:
+    Sender(const vle::devs::DynamicsInit& init,
+           const vle::devs::InitEventList& events)
+      : vle::devs::Dynamics(init, events)
+    {}
+
+    vle::devs::Time init(vle::devs::Time /*time*/) override
+    {
+        return 0.5;
+    }
+
+    void output(vle::devs::Time /*time*/,
+                vle::devs::ExternalEventList& output) const override
+    {
+        for (const auto& elem : getModel().getOutputPortList()) {
+            output.emplace_back(elem.first);
+            output.back().addString(elem.first);
+        }
+    }
+
+    vle::devs::Time timeAdvance() const override
+    {
+        return 1.0;
+    }
+};
+
+class Receiver : public vle::devs::Dynamics
+{
+public:
+    Receiver(const vle::devs::DynamicsInit& init,
+             const vle::devs::InitEventList& events)
+      : vle::devs::Dynamics(init, events)
+    {}
+
+    void externalTransition(const vle::devs::ExternalEventList& events,
+                            vle::devs::Time time) override
+    {
+        for (const auto& elem : events)
+            received.emplace_back(
+              getModelName() + '.' + elem.getPortName() + ':' +
+              elem.getString().value() + '@' +
+              std::to_string(static_cast<int>(time)));
+    }
+};
+
+/* Changes the output ports and the connections of the sender at 1, 2,
+ * 3... and checks its target tables after each change. */
+class Topology : public vle::devs::Executive
+{
+    int m_step;
+
+    std::vector<std::string> targets(const std::string& port)
+    {
+        auto* mdl = coupledmodel().findModel("src");
+        auto x = mdl->toAtomic()->get_simulator()->targets(port);
+
+        std::vector<std::string> ret;
+        for (auto it = x.first; it != x.second; ++it)
+            ret.emplace_back(it->first->getName() + '.' + it->second);
+
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+public:
+    Topology(const vle::devs::ExecutiveInit& init,
+             const vle::devs::InitEventList& events)
+      : vle::devs::Executive(init, events)
+      , m_step(0)
+    {}
+
+    vle::devs::Time init(vle::devs::Time /*time*/) override
+    {
+        return 1.0;
+    }
+
+    vle::devs::Time timeAdvance() const override
+    {
+        return m_step < 6 ? 1.0 : vle::devs::infinity;
+    }
+
+    void internalTransition(vle::devs::Time /*time*/) override
+    {
+        using strings = std::vector<std::string>;
+
+        switch (++m_step) {
+        case 1: // a port sorted before the existing one.
+            Ensures(targets("m") == strings{ "a.in" });
+            addOutputPort("src", "a_port");
+            addConnection("src", "a_port", "b", "in");
+            Ensures(targets("a_port") == strings{ "b.in" });
+            Ensures(targets("m") == strings{ "a.in" });
+            break;
+        case 2: // a port sorted after the existing ones.
+            addOutputPort("src", "z");
+            addConnection("src", "z", "c", "in");
+            addConnection("src", "z", "a", "in2");
+            Ensures(targets("a_port") == strings{ "b.in" });
+            Ensures(targets("m") == strings{ "a.in" });
+            Ensures(targets("z") == (strings{ "a.in2", "c.in" }));
+            break;
+        case 3: // grows the port in the middle.
+            addConnection("src", "m", "c", "in");
+            Ensures(targets("a_port") == strings{ "b.in" });
+            Ensures(targets("m") == (strings{ "a.in", "c.in" }));
+            Ensures(targets("z") == (strings{ "a.in2", "c.in" }));
+            break;
+        case 4: // empties the first port.
+            removeConnection("src", "a_port", "b", "in");
+            Ensures(targets("a_port").empty());
+            Ensures(targets("m") == (strings{ "a.in", "c.in" }));
+            Ensures(targets("z") == (strings{ "a.in2", "c.in" }));
+            break;
+        case 5: // removes the port in the middle.
+            removeOutputPort("src", "m");
+            Ensures(targets("a_port").empty());
+            Ensures(targets("z") == (strings{ "a.in2", "c.in" }));
+            break;
+        case 6: // removes the first port and shrinks the last one.
+            removeOutputPort("src", "a_port");
+            removeConnection("src", "z", "c", "in");
+            Ensures(targets("z") == strings{ "a.in2" });
+            break;
+        }
+    }
+};
+
+} // namespace package
+
+void
+test_executive_targets()
+{
+    using namespace std::chrono_literals;
+
+    auto ctx = vle::utils::make_context();
+    ctx->add_dynamics_factory(
+      "dynamics_sender",
+      [](const vle::devs::DynamicsInit& init,
+         const vle::devs::InitEventList& events) {
+          return new package::Sender(init, events);
+      });
+    ctx->add_dynamics_factory(
+      "dynamics_receiver",
+      [](const vle::devs::DynamicsInit& init,
+         const vle::devs::InitEventList& events) {
+          return new package::Receiver(init, events);
+      });
+    ctx->add_executive_factory(
+      "exe_topology",
+      [](const vle::devs::ExecutiveInit& init,
+         const vle::devs::InitEventList& events) {
+          return new package::Topology(init, events);
+      });
+
+    vle::manager::Simulation simulator(
+      ctx, vle::manager::SIMULATION_NONE, 0ms);
+    vle::manager::Error error;
+
+    package::received.clear();
+    auto file = std::make_unique<vle::vpz::Vpz>(DEVS_TEST_DIR "/targets.vpz");
+    simulator.run(std::move(file), &error);
+    EnsuresEqual(error.code, 0);
+
+    // The events of the sender reach the models connected when they are
+    // sent, and only them.
+    std::vector<std::string> expected = {
+        "a.in:m@0",
+        "a.in:m@1", "b.in:a_port@1",
+        "a.in:m@2", "b.in:a_port@2", "a.in2:z@2", "c.in:z@2",
+        "a.in:m@3", "b.in:a_port@3", "c.in:m@3", "a.in2:z@3", "c.in:z@3",
+        "a.in:m@4", "c.in:m@4", "a.in2:z@4", "c.in:z@4",
+        "a.in2:z@5", "c.in:z@5",
+        "a.in2:z@6"
+    };
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(package::received.begin(), package::received.end());
+    Ensures(package::received == expected);
+}
+
+int
+main()
+{
+    test_executive_targets();
+
+    return unit_test::report_errors();
+}
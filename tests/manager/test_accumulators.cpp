@@ -18,12 +18,25 @@
 
 #include <vle/utils/unit-test.hpp>
 
+#include <cmath>
 #include <stdexcept>
 #include <limits>
 #include <fstream>
 #include <iostream>
 
+#include <vle/manager/Manager.hpp>
+#include <vle/utils/Rand.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
+
 #include "details/accu_mono.hpp"
+#include "details/wrapper_init.hpp"
+#include "details/manager_concepts.hpp"
+#include "details/replicate_stopping.hpp"
 
 //Accumulators
 void test_accumulators()
@@ -67,9 +80,352 @@ void test_accumulators()
     }
 }
 
+//Merge of accumulators filled with parts of the same values
+void test_merge()
+{
+    namespace vm = vle::manager;
+    const double values[] = { 1, 5, 4, 3.6, 8, 3, 2 };
+    {
+        vm::AccuMono all(vm::STANDARD), left(vm::STANDARD),
+            right(vm::STANDARD), empty(vm::STANDARD);
+        for (int i = 0; i < 7; ++i) {
+            all.insert(values[i]);
+            (i < 3 ? left : right).insert(values[i]);
+        }
+        left.merge(right);
+        left.merge(empty);
+        EnsuresEqual(left.count(), all.count());
+        EnsuresEqual(left.sum(), all.sum());
+        EnsuresEqual(left.squareSum(), all.squareSum());
+        EnsuresEqual(left.min(), all.min());
+        EnsuresEqual(left.max(), all.max());
+        EnsuresApproximatelyEqual(left.mean(), 3.8, 10e-4);
+        EnsuresApproximatelyEqual(left.variance(), 5.146667, 10e-4);
+    }
+    {
+        vm::AccuMono left(vm::MEAN), right(vm::MEAN);
+        for (int i = 0; i < 7; ++i) {
+            (i % 2 ? left : right).insert(values[i]);
+        }
+        left.merge(right);
+        EnsuresEqual(left.count(), 7u);
+        EnsuresApproximatelyEqual(left.mean(), 3.8, 10e-4);
+    }
+    {
+        vm::AccuMono left(vm::QUANTILE), right(vm::QUANTILE);
+        for (int i = 0; i < 7; ++i) {
+            (i % 2 ? left : right).insert(values[i]);
+        }
+        EnsuresApproximatelyEqual(left.quantile(0.5), 3.6, 10e-4);
+        left.merge(right);
+        EnsuresApproximatelyEqual(left.quantile(0.75), 4.5, 10e-4);
+    }
+    {
+        vm::AccuMono standard(vm::STANDARD), mean(vm::MEAN);
+        EnsuresThrow(standard.merge(mean), vle::utils::ArgError);
+    }
+    {
+        vle::value::Matrix m1(2, 3, 2, 2), m2(2, 3, 2, 2);
+        m1.add(0, 0, vle::value::String::create("time"));
+        m1.add(1, 0, vle::value::String::create("x"));
+        m2.add(0, 0, vle::value::String::create("time"));
+        m2.add(1, 0, vle::value::String::create("x"));
+        for (int i = 1; i < 3; ++i) {
+            m1.add(0, i, vle::value::Double::create(i));
+            m1.add(1, i, vle::value::Double::create(values[i]));
+            m2.add(0, i, vle::value::Double::create(i));
+            m2.add(1, i, vle::value::Double::create(values[i + 2]));
+        }
+
+        vm::AccuMulti left(vm::S_mean), right(vm::S_mean), empty(vm::S_mean);
+        left.insertColumn(m1, 1);
+        right.insertColumn(m2, 1);
+        empty.merge(left);
+        empty.merge(right);
+        EnsuresEqual(empty.count(), 2u);
+        EnsuresApproximatelyEqual(empty.mean(0), 4.3, 10e-4);
+        EnsuresApproximatelyEqual(empty.mean(1), 6, 10e-4);
+    }
+}
+
+//Bounded memory quantiles
+void test_quantile_sketch()
+{
+    namespace vm = vle::manager;
+    {
+        //exact while the sketch is not compacted
+        vm::AccuMono exact(vm::QUANTILE), sketch(vm::QUANTILE);
+        sketch.setQuantileError(0.01);
+        Ensures(sketch.hasQuantileSketch());
+        Ensures(not exact.hasQuantileSketch());
+        const double values[] = { 1, 5, 4, 3.6, 8, 3, 2 };
+        for (double v : values) {
+            exact.insert(v);
+            sketch.insert(v);
+        }
+        EnsuresEqual(sketch.count(), 7u);
+        EnsuresApproximatelyEqual(sketch.mean(), 3.8, 10e-4);
+        EnsuresApproximatelyEqual(sketch.squareSum(), 131.96, 10e-4);
+        for (double p = 0; p <= 1.0; p += 0.125) {
+            EnsuresApproximatelyEqual(sketch.quantile(p), exact.quantile(p),
+                                      1e-12);
+        }
+    }
+    {
+        //a permutation of 0..n-1: the quantile p is about p * (n - 1)
+        const unsigned int n = 100000;
+        const double error = 0.01;
+        vm::QuantileSketch all(error);
+        std::vector<vm::QuantileSketch> parts(4, vm::QuantileSketch(error));
+        for (unsigned int i = 0; i < n; ++i) {
+            double v = (i * 7919u) % n;
+            all.insert(v);
+            parts[i % 4].insert(v);
+        }
+        for (unsigned int i = 1; i < 4; ++i) {
+            parts[0].merge(parts[i]);
+        }
+        EnsuresEqual(all.count(), (uint64_t)n);
+        EnsuresEqual(parts[0].count(), (uint64_t)n);
+        Ensures(all.size() < 2000);
+        Ensures(parts[0].size() < 2000);
+        EnsuresApproximatelyEqual(all.quantile(0), 0, 1e-12);
+        EnsuresApproximatelyEqual(all.quantile(1), n - 1.0, 1e-12);
+        for (double p = 0.05; p < 1.0; p += 0.05) {
+            Ensures(std::abs(all.quantile(p) - p * (n - 1)) <= error * n);
+            Ensures(std::abs(parts[0].quantile(p) - p * (n - 1)) <=
+                    error * n);
+        }
+    }
+    {
+        //the bound of the rank error holds on large inputs, in any order
+        const unsigned int n = 1 << 20;
+        const double error = 0.01;
+        for (int order = 0; order < 3; ++order) {
+            vm::QuantileSketch sketch(error);
+            for (unsigned int i = 0; i < n; ++i) {
+                double v = order == 0 ? i
+                         : order == 1 ? n - 1 - i
+                                      : (i * 7919u) % n;
+                sketch.insert(v);
+            }
+            Ensures(sketch.rankError() <= error);
+            Ensures(sketch.size() < 10000);
+            for (double p = 0.01; p < 1.0; p += 0.01) {
+                Ensures(std::abs(sketch.quantile(p) - p * (n - 1)) <=
+                        sketch.rankError() * n + 1);
+            }
+        }
+    }
+    {
+        //merge of an exact and a sketch accumulators
+        vm::AccuMono exact(vm::S_quantile), sketch(vm::S_quantile);
+        sketch.setQuantileError(0.1);
+        for (int i = 0; i < 100; ++i) {
+            (i % 2 ? exact : sketch).insert(i);
+        }
+        exact.merge(sketch);
+        Ensures(exact.hasQuantileSketch());
+        EnsuresEqual(exact.count(), 100u);
+        EnsuresApproximatelyEqual(exact.mean(), 49.5, 1e-12);
+        Ensures(std::abs(exact.quantile(0.5) - 49.5) <= 10);
+    }
+    EnsuresThrow(vm::QuantileSketch(0), vle::utils::ArgError);
+    EnsuresThrow(vm::QuantileSketch(1), vle::utils::ArgError);
+}
+
+//build the result of a simulation: a view with a time and a x column
+static std::unique_ptr<vle::value::Map>
+simulation_result(double x)
+{
+    std::unique_ptr<vle::value::Matrix> mat(
+        new vle::value::Matrix(2, 4, 2, 4));
+    mat->add(0, 0, vle::value::String::create("time"));
+    mat->add(1, 0, vle::value::String::create("Top:A.x"));
+    for (int i = 1; i < 4; ++i) {
+        mat->add(0, i, vle::value::Double::create(i));
+        mat->add(1, i, vle::value::Double::create(x * i));
+    }
+    std::unique_ptr<vle::value::Map> res(new vle::value::Map());
+    res->add("view", std::move(mat));
+    return res;
+}
+
+//ManOutput aggregated in several parts, as the threads of a plan, then
+//merged, gives the same result as the sequential aggregation
+void test_merge_outputs()
+{
+    namespace vm = vle::manager;
+    namespace vv = vle::value;
+    const unsigned int N = 3, M = 4;
+
+    const char* integrations[] = { "last", "all" };
+    const char* inputs[] = { "mean", "all" };
+    const char* replicates[] = { "mean", "variance", "quantile" };
+
+    for (auto integration : integrations) {
+        for (auto input : inputs) {
+            for (auto replicate : replicates) {
+                vv::Map config;
+                config.addString("path", "view/Top:A.x");
+                config.addString("integration", integration);
+                config.addString("aggregation_input", input);
+                config.addString("aggregation_replicate", replicate);
+                if (std::string(replicate) == "quantile") {
+                    config.addDouble("quantile_error", 0.05);
+                }
+
+                vm::ManOutput sequential("o", config);
+                vm::ManOutput merged("o", config);
+                std::unique_ptr<vv::Value> expected;
+                std::vector<std::unique_ptr<vm::ManOutput>> parts;
+                for (int p = 0; p < 3; ++p) {
+                    parts.emplace_back(merged.clone());
+                }
+
+                for (unsigned int i = 0; i < N * M; ++i) {
+                    unsigned int in = i / M, repl = i % M;
+                    double x = in * 10 + repl * repl;
+                    auto res = simulation_result(x);
+                    auto v = sequential.insertReplicate(*res, in, N, M);
+                    if (v) {
+                        expected = std::move(v);
+                    }
+                    res = simulation_result(x);
+                    parts[(i * 7) % 3]->accumulate(*res, in, N, M);
+                }
+                Ensures(expected.get() != nullptr);
+                Ensures(merged.finish().get() == nullptr);
+
+                for (auto& part : parts) {
+                    merged.merge(*part);
+                }
+                auto value = merged.finish();
+                Ensures(value.get() != nullptr);
+                if (expected->isDouble()) {
+                    EnsuresApproximatelyEqual(expected->toDouble().value(),
+                                              value->toDouble().value(),
+                                              1e-9);
+                    continue;
+                }
+                const vv::Table& t1 = expected->toTable();
+                const vv::Table& t2 = value->toTable();
+                EnsuresEqual(t1.width(), t2.width());
+                EnsuresEqual(t1.height(), t2.height());
+                for (std::size_t c = 0; c < t1.width(); ++c) {
+                    for (std::size_t r = 0; r < t1.height(); ++r) {
+                        EnsuresApproximatelyEqual(t1(c, r), t2(c, r), 1e-9);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//ManOutput extracts the raw output of one simulation, as given to a
+//PlanSink
+void test_extract()
+{
+    namespace vm = vle::manager;
+    namespace vv = vle::value;
+
+    vv::Map config;
+    config.addString("path", "view/Top:A.x");
+    config.addString("integration", "last");
+    vm::ManOutput last("o", config);
+    auto res = simulation_result(2.0);
+    auto value = last.extract(*res);
+    Ensures(value.get() != nullptr);
+    Ensures(value->isDouble());
+    EnsuresApproximatelyEqual(value->toDouble().value(), 6.0, 1e-9);
+
+    config.addString("integration", "all");
+    vm::ManOutput all("o", config);
+    res = simulation_result(2.0);
+    value = all.extract(*res);
+    Ensures(value.get() != nullptr);
+    Ensures(value->isTuple());
+    const vv::Tuple& t = value->toTuple();
+    EnsuresEqual(t.size(), 3u);
+    for (unsigned int i = 0; i < 3; ++i) {
+        EnsuresApproximatelyEqual(t[i], 2.0 * (i + 1), 1e-9);
+    }
+}
+
+//the replicates of an input stop when the confidence interval of the mean
+//is small enough, and the outputs aggregate the replicates run
+void test_replicate_stopping()
+{
+    namespace vm = vle::manager;
+    namespace vv = vle::value;
+
+    EnsuresApproximatelyEqual(
+      vm::replicate_stopping::student_quantile(0.95, 1), 12.7062, 1e-4);
+    EnsuresApproximatelyEqual(
+      vm::replicate_stopping::student_quantile(0.95, 2), 4.3027, 1e-4);
+    EnsuresApproximatelyEqual(
+      vm::replicate_stopping::student_quantile(0.95, 10), 2.2281, 1e-4);
+    EnsuresApproximatelyEqual(
+      vm::replicate_stopping::student_quantile(0.99, 30), 2.7500, 1e-4);
+
+    {
+        vm::replicate_stopping stopping(2, 100);
+        Ensures(not stopping.enabled());
+        stopping.add(0, 0.5, 0.95, 3);
+        Ensures(stopping.enabled());
+
+        unsigned int count = 0;
+        Ensures(not stopping.insert(0, { 1.0 }, count));
+        Ensures(not stopping.insert(0, { 1.2 }, count));
+        Ensures(stopping.insert(0, { 1.0 }, count));
+        EnsuresEqual(count, 3u);
+        Ensures(not stopping.insert(0, { 1.0 }, count));
+
+        for (int i = 0; i < 10; ++i) {
+            Ensures(not stopping.insert(1, { (i % 2) * 10.0 }, count));
+        }
+    }
+
+    vv::Map config;
+    config.addString("path", "view/Top:A.x");
+    config.addString("integration", "all");
+    config.addDouble("stop_tolerance", 0.1);
+    EnsuresThrow(vm::ManOutput("o", config), vle::utils::ArgError);
+
+    config.addString("integration", "last");
+    config.addString("aggregation_input", "all");
+    vm::ManOutput output("o", config);
+    auto part = output.clone();
+    EnsuresApproximatelyEqual(part->stopTolerance, 0.1, 1e-9);
+
+    //input 0 stopped after 2 replicates, input 1 with all its replicates
+    const double x[2][4] = { { 1, 3, 0, 0 }, { 2, 4, 6, 8 } };
+    for (unsigned int in = 0; in < 2; ++in) {
+        for (unsigned int repl = 0; repl < (in ? 4u : 2u); ++repl) {
+            auto res = simulation_result(x[in][repl]);
+            Ensures(part->observe(*res) == 3 * x[in][repl]);
+            part->accumulate(*res, in, 2, 4);
+        }
+    }
+    output.merge(*part);
+    Ensures(output.finish().get() == nullptr);
+
+    output.closeReplicates();
+    auto value = output.finish();
+    Ensures(value.get() != nullptr);
+    const vv::Table& t = value->toTable();
+    EnsuresApproximatelyEqual(t(0, 0), 6.0, 1e-9);
+    EnsuresApproximatelyEqual(t(1, 0), 15.0, 1e-9);
+}
+
 int main()
 {
     test_accumulators();
+    test_merge();
+    test_merge_outputs();
+    test_quantile_sketch();
+    test_extract();
+    test_replicate_stopping();
 
     return unit_test::report_errors();
 }
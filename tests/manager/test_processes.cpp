@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2009-2015 INRA
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/unit-test.hpp>
+
+#include <vle/manager/Manager.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+#include <cstdlib>
+
+namespace vm = vle::manager;
+namespace vv = vle::value;
+
+// The VLE_HOME built by CMake holds the vle.adaptative-qss and the
+// vle.output plug-ins, in the parent and in the worker processes.
+static vle::utils::ContextPtr
+make_processes_context()
+{
+    ::setenv("VLE_HOME", MANAGER_TEST_HOME, 1);
+
+    auto ctx = vle::utils::make_context();
+    ctx->set_log_priority(3);
+    ctx->set_setting("vle.command.vle.worker",
+                     std::string(MANAGER_TEST_VLE " -V '%1%' --worker"));
+    return ctx;
+}
+
+static std::unique_ptr<vv::Map>
+run_plan(vle::utils::ContextPtr ctx,
+         const std::string& option,
+         vm::Error& error)
+{
+    vv::Map init;
+    init.addString("parallel_option", option);
+    init.addInt("nb_slots", 2);
+    // The threads run the simulations in the test process, the processes
+    // option spawns the workers anyway.
+    init.addBoolean("simulation_spawn", false);
+
+    auto levels = vv::Tuple::create();
+    for (int i = 0; i < 5; ++i)
+        levels->toTuple().add(i);
+    init.add("input_cond.source_init_level", std::move(levels));
+
+    auto trends = vv::Tuple::create();
+    trends->toTuple().add(0.5);
+    trends->toTuple().add(2.0);
+    init.add("replicate_cond.source_trend", std::move(trends));
+    init.addString("output_y", "view/top:gen.value");
+
+    vm::Manager manager(ctx, init);
+    return manager.runPlan(
+      std::make_unique<vle::vpz::Vpz>(MANAGER_TEST_DIR "/processes.vpz"),
+      init,
+      error);
+}
+
+void
+test_processes_as_threads()
+{
+    auto ctx = make_processes_context();
+
+    vm::Error error;
+    auto threads = run_plan(ctx, "threads", error);
+    EnsuresEqual(error.code, 0);
+    auto processes = run_plan(ctx, "processes", error);
+    EnsuresEqual(error.code, 0);
+
+    Ensures(threads->exist("y"));
+    Ensures(processes->exist("y"));
+    const auto& table = threads->get("y")->toTable();
+    EnsuresEqual(table.width(), 5u);
+
+    // The mean of the two replicates: level + (0.5 + 2) / 2 * duration.
+    for (std::size_t i = 0; i < table.width(); ++i)
+        EnsuresApproximatelyEqual(table.get(i, 0), i + 12.5, 1e-9);
+
+    EnsuresEqual(threads->writeToString(), processes->writeToString());
+}
+
+int
+main()
+{
+    test_processes_as_threads();
+
+    return unit_test::report_errors();
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2009-2015 INRA
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/unit-test.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "details/replicate_stopping.hpp"
+#include "details/work_queue.hpp"
+
+namespace vm = vle::manager;
+
+// The makespan of the plan with the old scheduling: thread i runs
+// simulations i, i + threads, ...
+static double
+makespan_striding(const std::vector<double>& costs, unsigned int threads)
+{
+    std::vector<double> finish(threads, 0.0);
+    for (std::size_t i = 0; i < costs.size(); ++i)
+        finish[i % threads] += costs[i];
+
+    return *std::max_element(finish.begin(), finish.end());
+}
+
+// The makespan of the plan with the work queue: the simulations are
+// emulated with a virtual clock, the first free thread pops the next
+// simulation of the queue.
+static double
+makespan_queue(const std::vector<double>& costs,
+               unsigned int threads,
+               bool use_hint)
+{
+    vm::work_queue queue(costs.size(), 1,
+                         use_hint ? costs : std::vector<double>());
+    std::vector<double> finish(threads, 0.0);
+    unsigned int input, replicate;
+    while (queue.pop(input, replicate))
+        *std::min_element(finish.begin(), finish.end()) += costs[input];
+
+    return *std::max_element(finish.begin(), finish.end());
+}
+
+// The number of simulations run by the threads with a stopping rule. The
+// threads are emulated with a virtual clock: each simulation lasts one
+// unit of time and gives a constant value, the rule is satisfied by the
+// minimal number of replicates. The results are inserted in the order of
+// the end of the simulations, then the thread pops the next one.
+static unsigned int
+simulations_with_stopping(unsigned int inputs,
+                          unsigned int replicates,
+                          unsigned int threads,
+                          bool interleave)
+{
+    vm::work_queue queue(inputs, replicates);
+    vm::replicate_stopping stopping(inputs, replicates);
+    stopping.add(0, 0.1, 0.95, 2);
+    if (interleave)
+        queue.interleave(stopping.min_replicates());
+
+    // the end and the input of the simulation of each busy thread.
+    std::vector<std::pair<double, unsigned int>> running;
+    unsigned int run = 0, input, replicate, count;
+    while (running.size() < threads and queue.pop(input, replicate)) {
+        running.emplace_back(1.0, input);
+        ++run;
+    }
+
+    while (not running.empty()) {
+        auto it = std::min_element(running.begin(), running.end());
+        const auto end = it->first;
+        const auto done = it->second;
+        running.erase(it);
+
+        if (stopping.insert(done, { 1.0 }, count))
+            queue.stop(done);
+
+        if (queue.pop(input, replicate)) {
+            running.emplace_back(end + 1.0, input);
+            ++run;
+        }
+    }
+
+    return run;
+}
+
+void
+test_order()
+{
+    {
+        vm::work_queue queue(3, 2);
+        EnsuresEqual(queue.size(), 6u);
+
+        unsigned int input, replicate;
+        for (unsigned int i = 0; i < 6; ++i) {
+            Ensures(queue.pop(input, replicate));
+            EnsuresEqual(input, i / 2);
+            EnsuresEqual(replicate, i % 2);
+        }
+        Ensures(not queue.pop(input, replicate));
+    }
+    {
+        vm::work_queue queue(4, 2, { 1.0, 5.0, 3.0, 5.0 });
+        const unsigned int expected[] = { 1, 1, 3, 3, 2, 2, 0, 0 };
+
+        unsigned int input, replicate;
+        for (unsigned int i = 0; i < 8; ++i) {
+            Ensures(queue.pop(input, replicate));
+            EnsuresEqual(input, expected[i]);
+            EnsuresEqual(replicate, i % 2);
+        }
+        Ensures(not queue.pop(input, replicate));
+    }
+    {
+        // A cost hint of the wrong size is ignored.
+        vm::work_queue queue(3, 1, { 1.0, 5.0 });
+        unsigned int input, replicate;
+        Ensures(queue.pop(input, replicate));
+        EnsuresEqual(input, 0u);
+        queue.clear();
+        Ensures(not queue.pop(input, replicate));
+    }
+    {
+        // The replicates of a stopped input are dropped.
+        vm::work_queue queue(3, 3);
+        unsigned int input, replicate;
+        Ensures(queue.pop(input, replicate));
+        EnsuresEqual(input, 0u);
+        queue.stop(0);
+        queue.stop(2);
+        for (unsigned int i = 0; i < 3; ++i) {
+            Ensures(queue.pop(input, replicate));
+            EnsuresEqual(input, 1u);
+            EnsuresEqual(replicate, i);
+        }
+        Ensures(not queue.pop(input, replicate));
+    }
+    {
+        // The first two replicates of each input, then the next ones in
+        // turn, the stopped inputs are skipped.
+        vm::work_queue queue(3, 4);
+        queue.interleave(2);
+        const unsigned int expected[][2] = { { 0, 0 }, { 0, 1 }, { 1, 0 },
+                                             { 1, 1 }, { 2, 0 }, { 2, 1 },
+                                             { 0, 2 }, { 1, 2 }, { 2, 2 } };
+
+        unsigned int input, replicate;
+        for (const auto& elem : expected) {
+            Ensures(queue.pop(input, replicate));
+            EnsuresEqual(input, elem[0]);
+            EnsuresEqual(replicate, elem[1]);
+        }
+
+        queue.stop(1);
+        Ensures(queue.pop(input, replicate));
+        EnsuresEqual(input, 0u);
+        EnsuresEqual(replicate, 3u);
+        Ensures(queue.pop(input, replicate));
+        EnsuresEqual(input, 2u);
+        EnsuresEqual(replicate, 3u);
+        Ensures(not queue.pop(input, replicate));
+    }
+}
+
+void
+test_stopping_threads()
+{
+    // With more threads than replicates, the threads take all the
+    // replicates of an input before the first result is known.
+    const unsigned int inputs = 4, replicates = 8, threads = 8;
+    EnsuresEqual(
+      simulations_with_stopping(inputs, replicates, threads, false),
+      inputs * replicates);
+
+    // Interleaved, an input stops soon after its first two replicates.
+    const auto run =
+      simulations_with_stopping(inputs, replicates, threads, true);
+    Ensures(run < inputs * replicates / 2);
+    EnsuresEqual(run, 15u);
+
+    // One thread runs only the minimal number of replicates.
+    EnsuresEqual(simulations_with_stopping(inputs, replicates, 1, true),
+                 inputs * 2);
+}
+
+void
+test_skewed_plan()
+{
+    // The long simulations are all given to the first thread by striding.
+    const std::vector<double> skewed = { 40, 1, 40, 1, 40, 1, 40, 1 };
+    EnsuresApproximatelyEqual(makespan_striding(skewed, 2), 160.0, 1e-9);
+    EnsuresApproximatelyEqual(makespan_queue(skewed, 2, false), 82.0, 1e-9);
+
+    // Without hint, the longest simulation starts last.
+    const std::vector<double> tail = { 20, 20, 20, 20, 60 };
+    EnsuresApproximatelyEqual(makespan_queue(tail, 2, false), 100.0, 1e-9);
+    EnsuresApproximatelyEqual(makespan_queue(tail, 2, true), 80.0, 1e-9);
+}
+
+void
+test_concurrent_pop()
+{
+    // Each simulation of the plan is popped once by the threads.
+    const unsigned int inputs = 100, replicates = 7, threads = 4;
+    vm::work_queue queue(inputs, replicates);
+    std::vector<std::vector<unsigned int>> popped(threads);
+    std::vector<std::thread> gp;
+    for (unsigned int t = 0; t < threads; ++t) {
+        gp.emplace_back([&queue, &popped, t]() {
+            unsigned int input, replicate;
+            while (queue.pop(input, replicate))
+                popped[t].push_back(input * replicates + replicate);
+        });
+    }
+    for (auto& th : gp)
+        th.join();
+
+    std::vector<unsigned int> all;
+    for (const auto& elem : popped)
+        all.insert(all.end(), elem.begin(), elem.end());
+    std::sort(all.begin(), all.end());
+
+    EnsuresEqual(all.size(), static_cast<std::size_t>(inputs * replicates));
+    for (std::size_t i = 0; i < all.size(); ++i)
+        EnsuresEqual(all[i], static_cast<unsigned int>(i));
+}
+
+int
+main()
+{
+    test_order();
+    test_stopping_threads();
+    test_skewed_plan();
+    test_concurrent_pop();
+
+    return unit_test::report_errors();
+}
@@ -481,12 +481,91 @@ test_compress_filepath(vle::utils::ContextPtr ctx)
     Ensures(t2.exists());
 }
 
+void
+test_spawn_wait_for(vle::utils::ContextPtr ctx)
+{
+#ifndef _WIN32
+    {
+        vle::utils::Spawn spawn(ctx);
+        auto argv = spawn.splitCommandLine(
+          "sh -c 'echo output; echo error 1>&2; exit 3'");
+        auto exe = std::move(argv.front());
+        argv.erase(argv.begin());
+
+        Ensures(spawn.start(exe, utils::Path::current_path().string(), argv));
+
+        std::string output, error;
+        Ensures(spawn.waitFor(
+          std::chrono::milliseconds::zero(),
+          [&output, &error](const std::string& out, const std::string& err) {
+              output += out;
+              error += err;
+          }));
+
+        Ensures(spawn.isfinish());
+        EnsuresEqual(output, "output\n");
+        EnsuresEqual(error, "error\n");
+
+        std::string message;
+        bool success = true;
+        spawn.status(&message, &success);
+        Ensures(not success);
+    }
+
+    {
+        vle::utils::Spawn spawn(ctx);
+        auto argv = spawn.splitCommandLine("sleep 10");
+        auto exe = std::move(argv.front());
+        argv.erase(argv.begin());
+
+        Ensures(spawn.start(exe, utils::Path::current_path().string(), argv));
+
+        auto start = std::chrono::steady_clock::now();
+        Ensures(not spawn.waitFor(std::chrono::milliseconds(100), nullptr));
+        Ensures(std::chrono::steady_clock::now() - start <
+                std::chrono::seconds(5));
+        Ensures(not spawn.isfinish());
+
+        spawn.kill();
+        Ensures(spawn.waitFor(std::chrono::milliseconds::zero(), nullptr));
+    }
+
+    {
+        // A descendant of the child keeps the pipes open after the end of
+        // the child, which ends after its last output.
+        vle::utils::Spawn spawn(ctx);
+        auto argv =
+          spawn.splitCommandLine("sh -c 'sleep 30 & echo x; sleep 1'");
+        auto exe = std::move(argv.front());
+        argv.erase(argv.begin());
+
+        Ensures(spawn.start(exe, utils::Path::current_path().string(), argv));
+
+        std::string output;
+        auto start = std::chrono::steady_clock::now();
+        Ensures(spawn.waitFor(
+          std::chrono::milliseconds::zero(),
+          [&output](const std::string& out, const std::string& /*err*/) {
+              output += out;
+          }));
+        Ensures(std::chrono::steady_clock::now() - start <
+                std::chrono::seconds(5));
+        Ensures(spawn.isfinish());
+        EnsuresEqual(output, "x\n");
+    }
+#else
+    (void)ctx;
+#endif
+}
+
 int
 main()
 {
     F fixture;
     auto ctx = vle::utils::make_context();
 
+    test_spawn_wait_for(ctx);
+
     // We check if user use make install or not otherwise, configure(),
     // build() and install() will fail.
 
@@ -34,6 +34,7 @@
 
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/unit-test.hpp>
+#include <vle/value/Binary.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
@@ -395,6 +396,75 @@ test_table()
     Ensures(t(0, 2) == 4.);
 }
 
+void
+test_binary()
+{
+    value::Map map;
+    map.addBoolean("boolean", true);
+    map.addInt("integer", -12);
+    map.addDouble("double", 0.1);
+    map.addString("string", "vle");
+    map.addXml("xml", "<a>b</a>");
+    map.add("null", value::Null::create());
+
+    auto& set = map.addSet("set");
+    set.addInt(1);
+    set.add(std::unique_ptr<value::Value>());
+    set.addTuple(3, 2.5);
+
+    auto& table = map.addTable("table", 2, 3);
+    for (std::size_t i = 0; i != table.value().size(); ++i)
+        table.value()[i] = static_cast<double>(i);
+
+    auto& matrix = map.addMatrix("matrix");
+    matrix.resize(2, 2);
+    matrix.addDouble(0, 0, 1.);
+    matrix.addString(1, 1, "cell");
+
+    std::string buffer;
+    value::BinaryWriter out(buffer);
+    out.writeValue(map);
+
+    value::BinaryReader in(buffer.data(), buffer.data() + buffer.size());
+    auto read = in.readValue();
+    Ensures(in.empty());
+    Ensures(read and read->isMap());
+
+    const auto& m = read->toMap();
+    EnsuresEqual(m.getBoolean("boolean"), true);
+    EnsuresEqual(m.getInt("integer"), -12);
+    EnsuresEqual(m.getDouble("double"), 0.1);
+    EnsuresEqual(m.getString("string"), "vle");
+    EnsuresEqual(m.getXml("xml"), "<a>b</a>");
+    Ensures(m.get("null")->isNull());
+
+    const auto& s = m.getSet("set");
+    EnsuresEqual(s.size(), 3);
+    EnsuresEqual(s.getInt(0), 1);
+    Ensures(not s.get(1));
+    EnsuresEqual(s.getTuple(2).size(), 3);
+    EnsuresEqual(s.getTuple(2).at(2), 2.5);
+
+    const auto& t = m.getTable("table");
+    EnsuresEqual(t.width(), 2);
+    EnsuresEqual(t.height(), 3);
+    EnsuresEqual(t(1, 2), 5.);
+
+    const auto& mat = m.getMatrix("matrix");
+    EnsuresEqual(mat.columns(), 2);
+    EnsuresEqual(mat.rows(), 2);
+    EnsuresEqual(mat.getDouble(0, 0), 1.);
+    EnsuresEqual(mat.getString(1, 1), "cell");
+    Ensures(not mat.get(1, 0));
+
+    value::BinaryReader truncated(buffer.data(),
+                                  buffer.data() + buffer.size() - 1);
+    EnsuresThrow(truncated.readValue(), utils::ArgError);
+
+    test::MyData user(1., 2., 3., "test-vle");
+    EnsuresThrow(out.writeValue(user), utils::ArgError);
+}
+
 int
 main()
 {
@@ -407,6 +477,7 @@ main()
     test_user_value();
     test_tuple();
     test_table();
+    test_binary();
 
     return unit_test::report_errors();
 }
@@ -25,10 +25,13 @@
  */
 
 #include <vle/utils/Context.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Filesystem.hpp>
 #include <vle/utils/unit-test.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Set.hpp>
 #include <vle/value/Value.hpp>
 #include <vle/vle.hpp>
 #include <vle/vpz/AtomicModel.hpp>
@@ -36,6 +39,8 @@
 #include <vle/vpz/Vpz.hpp>
 
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 
 using namespace vle;
 
@@ -489,7 +494,8 @@ check_classes_unittest_vpz(vpz::Classes& cls)
         EnsuresEqual(c.node()->getName(), "top");
         auto* cpled((vpz::CoupledModel*)c.node());
 
-        Ensures(ptr1 != cpled);
+        /* The hierarchy of a class is not cloned when it is renamed. */
+        Ensures(ptr1 == cpled);
 
         Ensures(cpled->exist("a"));
         Ensures(cpled->findModel("a")->isAtomic());
@@ -510,7 +516,7 @@ check_classes_unittest_vpz(vpz::Classes& cls)
         EnsuresEqual(c.node()->getName(), "top");
         auto* cpled((vpz::CoupledModel*)c.node());
 
-        Ensures(ptr2 != cpled);
+        Ensures(ptr2 == cpled);
 
         Ensures(cpled->exist("a"));
         Ensures(cpled->findModel("a")->isAtomic());
@@ -872,6 +878,309 @@ test_equal_views()
     check_equal_views_unittest_vpz(views);
 }
 
+/* Connections, conditions and maps are stored into pointer ordered or
+ * unordered containers, only the sorted lines of the XML output can be
+ * compared. Single line maps are removed since key order is unspecified. */
+std::vector<std::string>
+sorted_lines(const vpz::Vpz& vpz)
+{
+    std::vector<std::string> lines;
+    std::istringstream iss(vpz.writeToString());
+    std::string line;
+
+    while (std::getline(iss, line))
+        if (line.find("<map>") == std::string::npos)
+            lines.emplace_back(line);
+
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+void
+test_compiled()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+    vpz.parseFile(VPZ_TEST_DIR "/unittest.vpz");
+
+    auto compiled = vle::utils::Path::temp_directory_path();
+    compiled /= "vle-%%%%-%%%%.vpzc";
+    compiled = vle::utils::Path::unique_path(compiled.string());
+    EnsuresNotThrow(vpz.writeCompiled(compiled.string()), std::exception);
+
+    vpz::Vpz vpz2;
+    vpz2.parseFile(compiled.string());
+    check_unittest_vpz(vpz2);
+    Ensures(sorted_lines(vpz) == sorted_lines(vpz2));
+    compiled.remove();
+
+    auto dir = vle::utils::Path::temp_directory_path();
+    dir /= "vle-%%%%-%%%%";
+    dir = vle::utils::Path::unique_path(dir.string());
+    dir.create_directory();
+
+    auto file = dir;
+    file /= "unittest.vpz";
+    vle::utils::Path::copy_file(VPZ_TEST_DIR "/unittest.vpz", file);
+
+    vpz::Vpz cached;
+    cached.parseFileCached(file.string());
+    check_unittest_vpz(cached);
+
+    auto cache = vle::utils::Path(vpz::Vpz::compiledFilename(file.string()));
+    Ensures(cache.is_file());
+
+    cached.parseFileCached(file.string());
+    check_unittest_vpz(cached);
+    EnsuresEqual(cached.filename(), file.string());
+    Ensures(sorted_lines(vpz) == sorted_lines(cached));
+
+    /* A modified XML file must invalidate the cache. */
+    {
+        std::ofstream ofs(file.string(), std::ios::app);
+        ofs << "\n";
+    }
+    cached.parseFileCached(file.string());
+    check_unittest_vpz(cached);
+
+    cache.remove();
+    file.remove();
+    dir.remove();
+}
+
+void
+test_lazy_conditions()
+{
+    auto ctx = vle::utils::make_context();
+    const std::string xml = R"(<?xml version="1.0" encoding="UTF-8" ?>
+<vle_project version="1.0" date="" author="vle">
+ <experiment name="lazy">
+  <conditions>
+   <condition name="c">
+    <port name="set">
+     <set><integer>1</integer><string>a &amp; b</string></set>
+    </port>
+    <port name="empty" />
+    <port name="bad"><integer>abc</integer></port>
+   </condition>
+  </conditions>
+ </experiment>
+</vle_project>)";
+
+    vpz::Vpz vpz;
+    vpz.parseMemory(xml);
+    auto& cnd = vpz.project().experiment().conditions().get("c");
+    EnsuresEqual(cnd.lazyPortsSize(), 2);
+
+    /* Copies share the XML of the values. */
+    vpz::Vpz copy(vpz);
+    EnsuresEqual(
+      copy.project().experiment().conditions().get("c").lazyPortsSize(), 2);
+
+    const auto& set = cnd.valueOfPort("set");
+    Ensures(set and set->isSet());
+    EnsuresEqual(set->toSet().size(), 2);
+    EnsuresEqual(set->toSet().getString(1), "a & b");
+    EnsuresEqual(cnd.lazyPortsSize(), 1);
+    Ensures(not cnd.valueOfPort("empty"));
+
+    /* The value is parsed once for all the copies. */
+    EnsuresEqual(
+      copy.project().experiment().conditions().get("c").lazyPortsSize(), 1);
+
+    EnsuresThrow(cnd.valueOfPort("bad"), std::exception);
+    cnd.setValueToPort("bad", value::Integer::create(1));
+    EnsuresEqual(cnd.lazyPortsSize(), 0);
+
+    /* Unparsed values are written as is. */
+    vpz::Vpz unparsed;
+    unparsed.parseMemory(xml);
+    auto& unparsedcnd = unparsed.project().experiment().conditions().get("c");
+    unparsedcnd.del("bad");
+    vpz::Vpz reread;
+    reread.parseMemory(unparsed.writeToString());
+    EnsuresEqual(reread.project()
+                   .experiment()
+                   .conditions()
+                   .get("c")
+                   .valueOfPort("set")
+                   ->toSet()
+                   .getInt(0),
+                 1);
+    EnsuresEqual(unparsedcnd.lazyPortsSize(), 1);
+}
+
+void
+test_copy_on_write()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+    vpz.parseMemory(R"(<?xml version="1.0" encoding="UTF-8" ?>
+<vle_project version="1.0" date="" author="vle">
+ <structures>
+  <model name="top" type="coupled">
+   <submodels>
+    <model name="a" type="atomic" conditions="c" />
+   </submodels>
+  </model>
+ </structures>
+ <experiment name="cow">
+  <conditions>
+   <condition name="c">
+    <port name="x"><double>1.0</double></port>
+    <port name="s"><set><integer>1</integer></set></port>
+   </condition>
+   <condition name="d">
+    <port name="y"><double>2.0</double></port>
+   </condition>
+  </conditions>
+ </experiment>
+</vle_project>)");
+
+    const vpz::Vpz& original = vpz;
+    vpz::Vpz copy(vpz);
+
+    /* Constant access does not copy the values nor the models. */
+    const vpz::Vpz& ccopy = copy;
+    const auto& cnd = original.project().experiment().conditions().get("c");
+    const auto& copycnd = ccopy.project().experiment().conditions().get("c");
+    EnsuresEqual(cnd.valueOfPort("x").get(), copycnd.valueOfPort("x").get());
+    EnsuresEqual(original.project().model().node(),
+                 ccopy.project().model().node());
+
+    /* Modifying a condition copies only this condition. */
+    auto& c = copy.project().experiment().conditions().get("c");
+    c.setValueToPort("x", value::Double::create(3.0));
+    EnsuresEqual(cnd.valueOfPort("x")->toDouble().value(), 1.0);
+    EnsuresEqual(c.valueOfPort("x")->toDouble().value(), 3.0);
+
+    c.valueOfPort("s")->toSet().add(value::Integer::create(2));
+    EnsuresEqual(cnd.valueOfPort("s")->toSet().size(), 1);
+    EnsuresEqual(c.valueOfPort("s")->toSet().size(), 2);
+
+    const auto& d = original.project().experiment().conditions().get("d");
+    const auto& copyd = ccopy.project().experiment().conditions().get("d");
+    EnsuresEqual(d.valueOfPort("y").get(), copyd.valueOfPort("y").get());
+
+    /* Modifying the models of the copy clones the hierarchy. */
+    auto* top = vpz::BaseModel::toCoupled(copy.project().model().node());
+    Ensures(top != original.project().model().node());
+    top->findModel("a")->addInputPort("in");
+    Ensures(top->findModel("a")->existInputPort("in"));
+    Ensures(not vpz::BaseModel::toCoupled(original.project().model().node())
+                  ->findModel("a")
+                  ->existInputPort("in"));
+
+    /* Releasing a shared hierarchy returns a clone. */
+    vpz::Vpz second(vpz);
+    auto graph = second.project().model().graph();
+    Ensures(graph);
+    Ensures(graph.get() != original.project().model().node());
+    Ensures(original.project().model().node());
+}
+
+void
+test_rename_class_copy_on_write()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+    vpz.parseFile(VPZ_TEST_DIR "/unittest.vpz");
+
+    const vpz::Vpz& original = vpz;
+    vpz::Vpz copy(vpz);
+    const vpz::Vpz& ccopy = copy;
+    const auto* shared = original.project().classes().get("beepbeep").node();
+
+    /* The renamed class of the copy shares the hierarchy. */
+    copy.project().classes().rename("beepbeep", "renamed");
+    EnsuresEqual(ccopy.project().classes().get("renamed").node(), shared);
+
+    /* Modifying the renamed class clones the hierarchy, the original Vpz
+     * keeps its class unchanged. */
+    auto* top = vpz::BaseModel::toCoupled(
+      copy.project().classes().get("renamed").node());
+    Ensures(top != shared);
+    top->addAtomicModel("z");
+    Ensures(top->exist("z"));
+
+    Ensures(original.project().classes().exist("beepbeep"));
+    Ensures(not original.project().classes().exist("renamed"));
+    EnsuresEqual(original.project().classes().get("beepbeep").node(),
+                 shared);
+    Ensures(not vpz::BaseModel::toCoupled(
+                  original.project().classes().get("beepbeep").node())
+                  ->exist("z"));
+}
+
+void
+test_compressed()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+    vpz.parseFile(VPZ_TEST_DIR "/unittest.vpz");
+    Ensures(not vpz.isGzip());
+
+    auto dir = vle::utils::Path::temp_directory_path();
+    dir /= "vle-%%%%-%%%%";
+    dir = vle::utils::Path::unique_path(dir.string());
+    dir.create_directory();
+
+    auto gz = dir;
+    gz /= "unittest.vpz.gz";
+    auto zst = dir;
+    zst /= "unittest.vpz.zst";
+
+    {
+        std::string name = (dir / "unittest.gz").string();
+        vpz::Vpz::fixExtension(name);
+        EnsuresEqual(name, gz.string());
+    }
+
+#ifdef VLE_HAVE_ZLIB
+    vpz.write(gz.string());
+    Ensures(vpz.isGzip());
+
+    std::string content;
+    {
+        std::ifstream in(gz.string(), std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+    }
+    Ensures(content.size() > 2);
+    EnsuresEqual(static_cast<unsigned char>(content[0]), 0x1f);
+    EnsuresEqual(static_cast<unsigned char>(content[1]), 0x8b);
+
+    vpz::Vpz fromfile;
+    fromfile.parseFile(gz.string());
+    Ensures(fromfile.isGzip());
+    check_unittest_vpz(fromfile);
+
+    vpz::Vpz frommemory;
+    frommemory.parseMemory(content);
+    check_unittest_vpz(frommemory);
+    Ensures(sorted_lines(fromfile) == sorted_lines(frommemory));
+
+    content.resize(content.size() / 2);
+    vpz::Vpz truncated;
+    EnsuresThrow(truncated.parseMemory(content), std::exception);
+#else
+    EnsuresThrow(vpz.write(gz.string()), vle::utils::FileError);
+#endif
+
+#ifdef VLE_HAVE_ZSTD
+    vpz.write(zst.string());
+    vpz::Vpz fromzstd;
+    fromzstd.parseFile(zst.string());
+    check_unittest_vpz(fromzstd);
+#else
+    EnsuresThrow(vpz.write(zst.string()), vle::utils::FileError);
+#endif
+
+    gz.remove();
+    zst.remove();
+    dir.remove();
+}
+
 int
 main()
 {
@@ -889,6 +1198,11 @@ main()
     test_equal_dynamics();
     test_equal_outputs();
     test_equal_views();
+    test_compiled();
+    test_lazy_conditions();
+    test_copy_on_write();
+    test_rename_class_copy_on_write();
+    test_compressed();
 
     return unit_test::report_errors();
 }
@@ -342,6 +342,37 @@ test_del_port()
     EnsuresEqual(top1->existOutputConnection("x", "out", "out"), false);
 }
 
+void
+test_del_port_keep_connections()
+{
+    CoupledModel* top = new CoupledModel("top", nullptr);
+
+    AtomicModel* a(top->addAtomicModel("a"));
+    a->addOutputPort("out");
+    a->addOutputPort("out2");
+
+    AtomicModel* b(top->addAtomicModel("b"));
+    b->addInputPort("in");
+    b->addInputPort("in2");
+
+    top->addInternalConnection("a", "out", "b", "in");
+    top->addInternalConnection("a", "out2", "b", "in");
+    top->addInternalConnection("a", "out2", "b", "in2");
+
+    // Only the connections of the deleted port are removed from the other
+    // model, not all the connections between the two models.
+    a->delOutputPort("out");
+    Ensures(not b->getInPort("in").exist(a, "out"));
+    Ensures(b->getInPort("in").exist(a, "out2"));
+    Ensures(b->getInPort("in2").exist(a, "out2"));
+
+    b->delInputPort("in");
+    Ensures(not a->getOutPort("out2").exist(b, "in"));
+    Ensures(a->getOutPort("out2").exist(b, "in2"));
+
+    delete top;
+}
+
 void
 test_clone1()
 {
@@ -853,6 +884,7 @@ main()
     test_complex_displace();
     test_delinput_port();
     test_del_port();
+    test_del_port_keep_connections();
     test_clone1();
     test_clone2();
     test_clone_different_atomic();